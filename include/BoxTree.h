@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Geometry.h"
+#include <memory_resource>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace contour
+{
+    namespace spatial
+    {
+        // Distance from a point to the nearest point of a box; 0 inside it
+        double distanceToBox(const geometry::BoundingBox& box, const geometry::Point2D& point);
+
+        // Static bounding-volume hierarchy over an array of boxes, bulk loaded
+        // by median splits on the wider centroid axis. The tree stores only
+        // item indices into the caller's array, so queries take that array
+        // again and the caller decides what an item is.
+        class BoxTree
+        {
+        public:
+            using size_type = std::size_t;
+
+            explicit BoxTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+            BoxTree(const BoxTree& other, std::pmr::memory_resource* resource);
+            BoxTree(const BoxTree&) = default;
+            BoxTree& operator=(const BoxTree&) = default;
+            BoxTree(BoxTree&&) noexcept = default;
+            BoxTree& operator=(BoxTree&&) = default;
+
+            // Rebuilds the tree over boxes[0, count); O(count log count)
+            void build(const geometry::BoundingBox* boxes, size_type count);
+            void clear();
+
+            // Recomputes the node boxes on the path from item's leaf to the
+            // root after boxes[item] changed; O(log count)
+            void refit(size_type item, const geometry::BoundingBox* boxes);
+
+            // Number of items indexed
+            size_type size() const { return m_items.size(); }
+            bool empty() const { return m_items.empty(); }
+
+            // Calls visit(item) for every item whose box intersects range
+            template<typename Visitor>
+            void query(const geometry::BoundingBox& range, const geometry::BoundingBox* boxes, Visitor&& visit) const;
+
+            // Branch and bound: distance(item) is the exact item distance and
+            // must be at least distanceToBox(boxes[item], point). Lowers best
+            // and sets nearest whenever a closer item is found.
+            template<typename Distance>
+            void nearest(const geometry::Point2D& point, Distance&& distance,
+                         double& best, size_type& nearest) const;
+
+        private:
+            static constexpr size_type LEAF_SIZE = 4;
+            static constexpr size_type MAX_DEPTH = 64;
+
+            // Leaves hold items [first, first + count); internal nodes have
+            // count == 0 and their two children at first and first + 1
+            struct Node
+            {
+                geometry::BoundingBox box;
+                std::uint32_t first = 0;
+                std::uint32_t count = 0;
+            };
+
+            std::pmr::vector<Node> m_nodes;
+            std::pmr::vector<std::uint32_t> m_items;
+            std::pmr::vector<std::uint32_t> m_parents; // per node; the root is its own parent
+            std::pmr::vector<std::uint32_t> m_leaves;  // leaf node holding each item
+
+            void subdivide(size_type node, size_type begin, size_type end,
+                           const geometry::BoundingBox* boxes, const geometry::Point2D* centroids);
+        };
+
+        template<typename Visitor>
+        void BoxTree::query(const geometry::BoundingBox& range, const geometry::BoundingBox* boxes, Visitor&& visit) const
+        {
+            if (m_nodes.empty())
+            {
+                return;
+            }
+
+            std::uint32_t stack[MAX_DEPTH];
+            size_type top = 0;
+            stack[top++] = 0;
+            while (top > 0)
+            {
+                const Node& node = m_nodes[stack[--top]];
+                if (!node.box.intersects(range))
+                {
+                    continue;
+                }
+                if (node.count > 0)
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        if (boxes[m_items[i]].intersects(range))
+                        {
+                            visit(static_cast<size_type>(m_items[i]));
+                        }
+                    }
+                }
+                else
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.first + 1;
+                }
+            }
+        }
+
+        template<typename Distance>
+        void BoxTree::nearest(const geometry::Point2D& point, Distance&& distance,
+                              double& best, size_type& nearest) const
+        {
+            if (m_nodes.empty())
+            {
+                return;
+            }
+
+            std::uint32_t stack[MAX_DEPTH];
+            size_type top = 0;
+            stack[top++] = 0;
+            while (top > 0)
+            {
+                const Node& node = m_nodes[stack[--top]];
+                if (!(distanceToBox(node.box, point) < best))
+                {
+                    continue;
+                }
+                if (node.count > 0)
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        const double d = distance(static_cast<size_type>(m_items[i]));
+                        if (d < best)
+                        {
+                            best = d;
+                            nearest = m_items[i];
+                        }
+                    }
+                }
+                else
+                {
+                    // Push the farther child first so the nearer one is searched first
+                    const std::uint32_t left = node.first;
+                    const std::uint32_t right = node.first + 1;
+                    const bool leftNearer = distanceToBox(m_nodes[left].box, point) <= distanceToBox(m_nodes[right].box, point);
+                    stack[top++] = leftNearer ? right : left;
+                    stack[top++] = leftNearer ? left : right;
+                }
+            }
+        }
+    }
+}
@@ -2,65 +2,212 @@
 
 #include "Segment.h"
 #include "Geometry.h"
+#include "BoxTree.h"
 #include <vector>
 #include <memory>
-#include <optional>
+#include <memory_resource>
+#include <iterator>
+#include <utility>
+#include <cstddef>
 
 namespace contour
 {
+    // Contour with structurally shared, copy-on-write storage. Segments live in
+    // chunks of about CHUNK_SIZE; copies share the chunk table, and an edit
+    // duplicates only the table and the one chunk it touches. Every summary
+    // (joint gaps, lengths) is kept per chunk and updated eagerly, so const
+    // queries never write and shared snapshots can be read from any thread.
     class Contour
     {
+    private:
+        struct Chunk;
+        struct Table;
+
     public:
         // Type aliases for clarity
-        using SegmentContainer = std::vector<std::unique_ptr<Segment>>;
-        using iterator = SegmentContainer::iterator;
-        using const_iterator = SegmentContainer::const_iterator;
+        using SegmentContainer = std::pmr::vector<SegmentPtr>;
         using size_type = SegmentContainer::size_type;
+        class const_iterator;
+        using iterator = const_iterator; // segments are read-only in place
+
+        // Target segments per chunk; chunks split when they reach twice this
+        static constexpr size_type CHUNK_SIZE = 256;
+
+        // Forward iterator over the chunked segments
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = SegmentPtr;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const SegmentPtr*;
+            using reference = const SegmentPtr&;
+
+            const_iterator() = default;
+
+            reference operator*() const { return m_table->chunks[m_chunk]->segments[m_offset]; }
+            pointer operator->() const { return &**this; }
+            const_iterator& operator++();
+            const_iterator operator++(int) { const_iterator previous = *this; ++*this; return previous; }
+
+            bool operator==(const const_iterator& other) const
+            {
+                return m_chunk == other.m_chunk && m_offset == other.m_offset;
+            }
+            bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+        private:
+            friend class Contour;
+            const_iterator(const Table* table, size_type chunk) : m_table(table), m_chunk(chunk) {}
+
+            const Table* m_table = nullptr;
+            size_type m_chunk = 0;
+            size_type m_offset = 0;
+        };
+
+        // Scoped mutable access to one segment. The contour's summaries for
+        // that segment are refreshed on commit() or when the handle is
+        // destroyed; do not copy the contour or add, insert or remove
+        // segments while it is open. Using the handle after commit(), or
+        // after it was moved from, throws std::logic_error.
+        class SegmentEdit
+        {
+        public:
+            SegmentEdit(SegmentEdit&& other) noexcept;
+            SegmentEdit& operator=(SegmentEdit&&) = delete;
+            SegmentEdit(const SegmentEdit&) = delete;
+            SegmentEdit& operator=(const SegmentEdit&) = delete;
+            ~SegmentEdit();
+
+            Segment& operator*() const { return *openContour().editableSegment(m_index); }
+            Segment* operator->() const { return openContour().editableSegment(m_index).get(); }
+            size_type index() const { return m_index; }
+
+            // Swap in a different segment, e.g. one of another type
+            void replace(SegmentPtr segment);
+
+            // Refresh the summaries now and release the handle
+            void commit();
+
+        private:
+            friend class Contour;
+            SegmentEdit(Contour& contour, size_type index) : m_contour(&contour), m_index(index) {}
+            Contour& openContour() const;
+
+            Contour* m_contour;
+            size_type m_index;
+        };
 
         // Constructors and destructor
         Contour() = default;
         explicit Contour(SegmentContainer segments);
         ~Contour() = default;
 
-        // Copy constructor and assignment (deep copy)
-        Contour(const Contour& other);
-        Contour& operator=(const Contour& other);
+        // Allocator-aware construction: chunks and summaries are allocated
+        // from `resource` (the default resource if null). Copying into a
+        // resource clones every segment.
+        explicit Contour(std::pmr::memory_resource* resource);
+        Contour(const Contour& other, std::pmr::memory_resource* resource);
+
+        // Copy constructor and assignment are O(1): the copy shares the
+        // other contour's chunks, and with them its memory resource, which
+        // must outlive both
+        Contour(const Contour& other) = default;
+        Contour& operator=(const Contour& other) = default;
 
         // Move constructor and assignment
         Contour(Contour&&) noexcept = default;
         Contour& operator=(Contour&&) noexcept = default;
 
+        std::pmr::memory_resource* getResource() const { return m_resource; }
+
+        // True if this contour and other currently share their storage
+        bool sharesStorageWith(const Contour& other) const { return m_table && m_table == other.m_table; }
+
+        // Leading and trailing segment counts held in chunks shared with other,
+        // e.g. a snapshot taken before some edits. Compares chunk addresses
+        // only, O(n / CHUNK_SIZE); the two ranges never overlap
+        std::pair<size_type, size_type> sharedEnds(const Contour& other) const;
+
         // Segment management
-        void addSegment(std::unique_ptr<Segment> segment);
-        void insertSegment(size_type index, std::unique_ptr<Segment> segment);
+        void reserve(size_type capacity);
+        void addSegment(SegmentPtr segment);
+        void insertSegment(size_type index, SegmentPtr segment);
         void removeSegment(size_type index);
-        void replaceSegment(size_type index, std::unique_ptr<Segment> segment);
+        void replaceSegment(size_type index, SegmentPtr segment);
         void clear();
 
         // Access methods
-        size_type size() const { return m_segments.size(); }
-        bool empty() const { return m_segments.empty(); }
+        size_type size() const;
+        bool empty() const { return size() == 0; }
         
-        Segment& operator[](size_type index);
+        // Read access never disturbs the cached summaries, even on a non-const contour
         const Segment& operator[](size_type index) const;
-        
-        Segment& at(size_type index);
         const Segment& at(size_type index) const;
 
+        // Explicit mutation of a segment in place
+        SegmentEdit edit(size_type index);
+
         // Iterator support for range-based loops and STL algorithms
-        iterator begin() { invalidateCache(); return m_segments.begin(); }
-        const_iterator begin() const { return m_segments.begin(); }
-        const_iterator cbegin() const { return m_segments.begin(); }
+        const_iterator begin() const;
+        const_iterator cbegin() const { return begin(); }
         
-        iterator end() { invalidateCache(); return m_segments.end(); }
-        const_iterator end() const { return m_segments.end(); }
-        const_iterator cend() const { return m_segments.end(); }
+        const_iterator end() const;
+        const_iterator cend() const { return end(); }
 
-        // Validation with caching
+        // Validation - answered from the joint-gap summary for any epsilon
         bool isValid(double epsilon = geometry::EPSILON) const;
 
+        // A point where two segments touch or cross; first < second
+        struct Crossing
+        {
+            size_type first;
+            size_type second;
+            geometry::Point2D point;
+        };
+
+        // Every crossing between segments other than the joints shared by
+        // connected neighbours, ordered by (first, second, point).
+        // Sweep-line, O((n + k) log n) for k crossings
+        std::vector<Crossing> findSelfIntersections() const;
+
+        // True if no two segments meet outside their shared joints; stops at
+        // the first crossing, O(n log n)
+        bool isSimple() const;
+
+        // Largest end-to-start gap (max of |dx|, |dy|) over all joints;
+        // 0 for fewer than two segments, infinity if any joint has NaN
+        double getMaxJointGap() const;
+
+        // Joints not connected at geometry::EPSILON, ascending; joint i is the
+        // end of segment i meeting the start of segment i + 1
+        const std::vector<size_type>& getDisconnectedJoints() const;
+
         // Utility methods
         double getTotalLength() const;
+
+        // Exact axis-aligned bounds of every segment, kept per chunk and
+        // refreshed with the other summaries; empty for an empty contour
+        geometry::BoundingBox getBoundingBox() const;
+
+        // Spatial queries through a two-level bounding-volume hierarchy: a tree
+        // over the chunk boxes, then a tree over each chunk's segment boxes.
+        // Both are updated with the chunk summaries, so they never go stale.
+        std::vector<size_type> segmentsInBox(const geometry::BoundingBox& range) const; // ascending
+
+        // Index of a segment closest to point; throws std::out_of_range if empty
+        size_type nearestSegment(const geometry::Point2D& point) const;
+
+        // Pairs (i, j) whose segment boxes intersect, sorted; within one contour
+        // i < j and adjacent segments always pair up through their shared joint
+        std::vector<std::pair<size_type, size_type>> overlappingSegments() const;
+        std::vector<std::pair<size_type, size_type>> overlappingSegments(const Contour& other) const;
+
+        // Arc-length parameterization by binary search over the per-chunk and
+        // per-segment cumulative lengths; distance must lie in [0, getTotalLength()]
+        size_type segmentIndexAtDistance(double distance) const;
+        geometry::Point2D pointAtDistance(double distance) const;
+        geometry::Vector2D tangentAtDistance(double distance) const;
         std::vector<geometry::Point2D> getVertices() const;
         bool isClosed(double epsilon = geometry::EPSILON) const;
 
@@ -68,16 +215,63 @@ namespace contour
         bool isEqual(const Contour& other, double epsilon = geometry::EPSILON) const;
 
     private:
-        SegmentContainer m_segments;
-        
-        // Caching for isValid() - mutable to allow modification in const methods
-        mutable std::optional<bool> m_validityCache;
-        mutable double m_lastEpsilon = -1.0; // Track epsilon used for caching
+        // A run of consecutive segments with summaries over its own joints
+        struct Chunk
+        {
+            explicit Chunk(std::pmr::memory_resource* resource);
+
+            SegmentContainer segments;
+            std::pmr::vector<double> jointGaps;         // gap after segments[i], for i + 1 < size
+            std::pmr::vector<double> cumulativeLengths; // length of segments[0..i]
+            std::vector<size_type> brokenJoints;        // local joint indices, sorted
+            double maxGap = 0.0;
+            geometry::BoundingBox bounds;
+            std::pmr::vector<geometry::BoundingBox> boxes; // per segment
+            spatial::BoxTree tree;                         // over boxes[0, tree.size())
+        };
+
+        // Chunk list plus the contour-wide summaries derived from it
+        struct Table
+        {
+            explicit Table(std::pmr::memory_resource* resource);
+            Table(const Table& other, std::pmr::memory_resource* resource);
+
+            std::pmr::vector<std::shared_ptr<Chunk>> chunks;
+            std::pmr::vector<size_type> segmentEnds; // one past the last index of each chunk
+            std::pmr::vector<double> lengthEnds;     // total length up to the end of each chunk
+            std::pmr::vector<double> chunkGaps;      // maxGap of each chunk
+            std::pmr::vector<double> boundaryGaps;   // gap between chunk c and c + 1
+            std::vector<size_type> brokenJoints;     // global joint indices, sorted
+            double maxGap = 0.0;
+            geometry::BoundingBox bounds;
+            std::pmr::vector<geometry::BoundingBox> chunkBoxes;
+            spatial::BoxTree chunkTree;              // over chunkBoxes[0, chunkTree.size())
+            bool uniform = true;                     // every chunk but the last holds CHUNK_SIZE
+        };
+
+        std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
+        std::shared_ptr<Table> m_table; // null while empty
         
         // Helper methods
-        void invalidateCache() const;
-        bool calculateValidity(double epsilon) const;
-        void deepCopyFrom(const Contour& other);
+        Table& mutableTable();
+        Chunk& mutableChunk(size_type chunk);
+        std::shared_ptr<Chunk> makeChunk() const;
+        std::pair<size_type, size_type> locate(size_type index) const;
+        size_type chunkStart(size_type chunk) const;
+        SegmentPtr& editableSegment(size_type index);
+        void segmentChanged(size_type index);
+        void refreshChunk(Chunk& chunk) const;
+        void refreshSegment(Chunk& chunk, size_type offset) const;
+        void refreshTable(size_type first, size_type removed, size_type added);
+        const Segment& locateDistance(double distance, double& t, size_type* index, const char* caller) const;
+        static double jointGap(const Segment& first, const Segment& second);
+
+        // Visit chunk indices / chunk-local segment offsets whose boxes meet range;
+        // items past the end of a tree (a growing tail) are checked one by one
+        template<typename Visitor>
+        void visitChunks(const geometry::BoundingBox& range, Visitor&& visit) const;
+        template<typename Visitor>
+        void visitSegments(const Chunk& chunk, const geometry::BoundingBox& range, Visitor&& visit) const;
     };
 
     // Global operators
@@ -91,6 +285,9 @@ namespace contour
         Contour m_contour;
 
     public:
+        ContourBuilder() = default;
+        explicit ContourBuilder(std::pmr::memory_resource* resource) : m_contour(resource) {}
+
         ContourBuilder& addLine(const geometry::Point2D& start, const geometry::Point2D& end);
         ContourBuilder& addArc(const geometry::Point2D& center, double radius, 
                               double startAngle, double endAngle, bool clockwise = false);
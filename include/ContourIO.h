@@ -0,0 +1,335 @@
+#pragma once
+
+#include "Contour.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace contour
+{
+    namespace io
+    {
+        // Native binary contour format (.cnt), little-endian throughout:
+        //
+        //   offset  size  field
+        //   0       4     magic "CNTR"
+        //   4       2     version (CNT_VERSION)
+        //   6       2     header size in bytes (CNT_HEADER_SIZE)
+        //   8       4     flags, CNT_FLAG_* bits
+        //   12      4     reserved, 0
+        //   16      8     segment count n
+        //   24      8     payload size in bytes
+        //   32      n     one SegmentTag per segment
+        //   ...           zero padding to a multiple of 8
+        //   ...           payload: the doubles of every segment in order,
+        //                 LINE_DOUBLES for a line, ARC_DOUBLES for an arc
+        //
+        // Lines store (startX, startY, endX, endY); arcs store (centerX,
+        // centerY, radius, startAngle, endAngle), and their direction is in the tag.
+        // Files are self-delimiting, so several can be concatenated in one stream.
+        // A long contour may be split over several consecutive records; all
+        // but the last carry CNT_FLAG_CONTINUED, and readers join them.
+        //
+        // A record with CNT_FLAG_COMPRESSED has no tag column. Its payload is
+        // the resolution as a double, then runs of (tag, count) varints each
+        // followed by the segments of the run, zero padded to a multiple of 8.
+        // Coordinates are quantized to multiples of the resolution and stored
+        // as zig-zag varint deltas from the previous quantized point, so a line
+        // that starts where the last segment ended stores only its end point.
+        // Arcs store their center delta and sweep; an arc that starts where the
+        // last segment ended takes its radius and start angle from that point,
+        // and any other arc stores them too. Angles are counted in steps of
+        // resolution / radius radians.
+        constexpr char CNT_MAGIC[4] = { 'C', 'N', 'T', 'R' };
+        constexpr std::uint16_t CNT_VERSION = 1;
+        constexpr std::uint32_t CNT_FLAG_CONTINUED = 1u << 0;
+        constexpr std::uint32_t CNT_FLAG_COMPRESSED = 1u << 1;
+        constexpr std::uint32_t CNT_KNOWN_FLAGS = CNT_FLAG_CONTINUED | CNT_FLAG_COMPRESSED;
+        constexpr std::size_t CNT_HEADER_SIZE = 32;
+        constexpr std::size_t LINE_DOUBLES = 4;
+        constexpr std::size_t ARC_DOUBLES = 5;
+
+        // Quantization step for compressed records. Points move by about the
+        // resolution at most, and joints between segments stay closed.
+        constexpr double CNT_DEFAULT_RESOLUTION = 1e-6;
+
+        enum class SegmentTag : std::uint8_t
+        {
+            Line = 0,
+            ArcCounterClockwise = 1,
+            ArcClockwise = 2
+        };
+
+        struct CntHeader
+        {
+            std::uint16_t version = CNT_VERSION;
+            std::uint32_t flags = 0;
+            std::uint64_t segmentCount = 0;
+            std::uint64_t payloadSize = 0;
+        };
+
+        // Bytes taken by the tag column including its padding
+        constexpr std::uint64_t tagColumnSize(std::uint64_t segmentCount)
+        {
+            return (segmentCount + 7) / 8 * 8;
+        }
+
+        // Largest angle magnitude, in radians, that readers accept
+        constexpr double CNT_MAX_ANGLE = 1e6;
+
+        // Doubles stored for a tag; 0 for an unknown tag
+        constexpr std::size_t doublesForTag(std::uint8_t tag)
+        {
+            return tag == static_cast<std::uint8_t>(SegmentTag::Line) ? LINE_DOUBLES
+                : tag <= static_cast<std::uint8_t>(SegmentTag::ArcClockwise) ? ARC_DOUBLES : 0;
+        }
+
+        // Why the decoded doubles of a segment cannot be trusted, or null if
+        // they can: all must be finite and arc angles within CNT_MAX_ANGLE
+        const char* invalidSegmentValues(std::uint8_t tag, const double* values);
+
+        // Header bytes <-> fields; parseHeader throws std::runtime_error
+        // naming `caller` for a wrong magic, version, header size or flags
+        void formatHeader(const CntHeader& header, unsigned char (&bytes)[CNT_HEADER_SIZE]);
+        CntHeader parseHeader(const unsigned char (&bytes)[CNT_HEADER_SIZE], const char* caller);
+
+        // Little-endian loads and stores that work at any alignment
+        namespace detail
+        {
+            inline bool hostIsLittleEndian()
+            {
+                const std::uint16_t probe = 1;
+                unsigned char first;
+                std::memcpy(&first, &probe, 1);
+                return first == 1;
+            }
+
+            inline std::uint64_t loadU64(const unsigned char* bytes)
+            {
+                std::uint64_t value = 0;
+                for (int i = 7; i >= 0; --i)
+                {
+                    value = (value << 8) | bytes[i];
+                }
+                return value;
+            }
+
+            inline void storeU64(unsigned char* bytes, std::uint64_t value)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+                }
+            }
+
+            inline double loadDouble(const unsigned char* bytes)
+            {
+                const std::uint64_t bits = loadU64(bytes);
+                double value;
+                std::memcpy(&value, &bits, sizeof value);
+                return value;
+            }
+
+            inline void storeDouble(unsigned char* bytes, double value)
+            {
+                std::uint64_t bits;
+                std::memcpy(&bits, &value, sizeof bits);
+                storeU64(bytes, bits);
+            }
+        }
+
+        // Encoder for the payload of compressed records
+        class DeltaEncoder
+        {
+        public:
+            // Throws std::invalid_argument unless resolution is positive and finite
+            explicit DeltaEncoder(double resolution = CNT_DEFAULT_RESOLUTION);
+
+            // Adds a segment given as its tag and plain-record doubles. Throws
+            // std::invalid_argument, leaving the encoder unchanged, if the segment
+            // collapses or a coordinate is out of range at this resolution.
+            void add(SegmentTag tag, const double* values);
+
+            std::size_t size() const { return m_count; }
+            double getResolution() const { return m_resolution; }
+
+            // Returns the padded payload and starts a new, empty one. With
+            // continued the next payload carries on from the last segment, so
+            // the joint between continued records stays closed too.
+            std::vector<unsigned char> finish(bool continued = false);
+
+        private:
+            void flushRun();
+
+            double m_resolution;
+            std::vector<unsigned char> m_bytes;
+            std::vector<unsigned char> m_run;
+            unsigned char m_runTag = 0;
+            std::size_t m_runLength = 0;
+            std::size_t m_count = 0;
+            std::int64_t m_cursorX = 0;
+            std::int64_t m_cursorY = 0;
+            bool m_hasPrevious = false;
+            geometry::Point2D m_previousEnd;
+            geometry::Point2D m_decodedEnd;
+        };
+
+        // Decoder for the payload of compressed records; yields segments as the
+        // tag and plain-record doubles, so callers share the plain-record path
+        class DeltaDecoder
+        {
+        public:
+            // Starts on a payload of segmentCount segments, which must outlive
+            // the decoding; continuesPrevious carries on from the last payload
+            // as the encoder's finish(true) did. Throws std::runtime_error
+            // naming caller for a bad resolution.
+            void reset(const unsigned char* data, std::size_t size, std::uint64_t segmentCount,
+                       bool continuesPrevious, const char* caller);
+
+            // False once every segment is decoded; throws std::runtime_error
+            // for a truncated or malformed payload
+            bool next(unsigned char& tag, double (&values)[ARC_DOUBLES]);
+
+        private:
+            [[noreturn]] void fail(const char* what) const;
+            std::uint64_t readVarint();
+            geometry::Point2D previousEnd() const;
+
+            const unsigned char* m_data = nullptr;
+            const unsigned char* m_end = nullptr;
+            const char* m_caller = "DeltaDecoder";
+            std::uint64_t m_remaining = 0;
+            std::uint64_t m_runLeft = 0;
+            unsigned char m_runTag = 0;
+            double m_resolution = 0.0;
+            std::int64_t m_cursorX = 0;
+            std::int64_t m_cursorY = 0;
+            bool m_hasPrevious = false;
+            unsigned char m_previousTag = 0;
+            double m_previous[ARC_DOUBLES] = {};
+        };
+
+        // Writers throw std::runtime_error if the stream or file fails
+        void writeContour(std::ostream& out, const Contour& contour);
+        void writeContour(const std::string& path, const Contour& contour);
+
+        // Writes compressed records, read back by readContour and ContourReader
+        // (MappedContour only views plain records). Throws std::invalid_argument,
+        // before anything is written, if a segment collapses at the resolution.
+        void writeCompressedContour(std::ostream& out, const Contour& contour,
+                                    double resolution = CNT_DEFAULT_RESOLUTION);
+        void writeCompressedContour(const std::string& path, const Contour& contour,
+                                    double resolution = CNT_DEFAULT_RESOLUTION);
+
+        // Readers throw std::runtime_error for a malformed, truncated or
+        // unreadable file. Segments are allocated from `resource`, or with
+        // plain new if it is null. The stream is left just after the contour.
+        Contour readContour(std::istream& in, std::pmr::memory_resource* resource = nullptr);
+        Contour readContour(const std::string& path, std::pmr::memory_resource* resource = nullptr);
+
+        // Pull-style reader for archives of concatenated contours. Memory use
+        // is bounded by the caller's block size plus one record's tag column,
+        // or one compressed payload, whatever the archive size. Throws std::runtime_error like readContour.
+        class ContourReader
+        {
+        public:
+            explicit ContourReader(std::istream& in);
+
+            // Moves to the next contour, skipping what is left of the current
+            // one; false at a clean end of the stream
+            bool nextContour();
+
+            // Replaces block with up to maxSegments further segments of the
+            // current contour; returns how many, 0 once the contour is exhausted
+            std::size_t readSegments(std::vector<SegmentVariant>& block, std::size_t maxSegments);
+
+            // Reads the whole next contour; false at a clean end of the stream
+            bool read(Contour& contour, std::pmr::memory_resource* resource = nullptr);
+
+        private:
+            bool loadRecord();
+            bool nextValues(unsigned char& tag, double (&values)[ARC_DOUBLES]);
+
+            std::istream& m_in;
+            std::vector<unsigned char> m_tags;
+            std::size_t m_tagCount = 0;
+            std::size_t m_nextTag = 0;
+            bool m_continued = false;
+            bool m_inContour = false;
+            std::vector<unsigned char> m_block;
+            std::size_t m_used = 0;
+            std::size_t m_available = 0;
+            std::uint64_t m_payloadRemaining = 0;
+            bool m_compressed = false;
+            std::vector<unsigned char> m_packed;
+            DeltaDecoder m_decoder;
+        };
+
+        // Append-only writer that never holds more than one block of segments.
+        // Each contour is written as records of up to blockSegments segments,
+        // so readContour, ContourReader and MappedContour all read it back.
+        class ContourWriter
+        {
+        public:
+            static constexpr std::size_t DEFAULT_BLOCK_SEGMENTS = 4096;
+
+            // Throws std::invalid_argument if blockSegments is 0
+            explicit ContourWriter(std::ostream& out, std::size_t blockSegments = DEFAULT_BLOCK_SEGMENTS);
+
+            // Ends a contour left open; errors are swallowed here, so call
+            // endContour() to see them
+            ~ContourWriter();
+
+            ContourWriter(const ContourWriter&) = delete;
+            ContourWriter& operator=(const ContourWriter&) = delete;
+
+            // Segments are validated like their constructors do
+            void addLine(const geometry::Point2D& start, const geometry::Point2D& end);
+            void addArc(const geometry::Point2D& center, double radius,
+                        double startAngle, double endAngle, bool clockwise = false);
+            void addSegment(const Segment& segment);
+            void addSegment(const SegmentVariant& segment);
+
+            // Streaming counterpart of createPolylineContour: every point after
+            // the first adds a line from the previous one, and repeated points
+            // are skipped
+            void addPoint(const geometry::Point2D& point);
+
+            // Finishes the current contour; with nothing added it writes an
+            // empty contour
+            void endContour();
+
+            // Writes a complete contour; std::logic_error if one is open
+            void writeContour(const Contour& contour);
+
+            // Writes later contours as compressed records at this resolution,
+            // or as plain records for 0. Throws std::invalid_argument for a
+            // negative or non-finite resolution and std::logic_error while a
+            // contour is open. A segment that collapses at the resolution is
+            // rejected by the add functions with std::invalid_argument.
+            void setCompression(double resolution);
+
+            std::size_t getContourCount() const { return m_contourCount; }
+
+        private:
+            void append(SegmentTag tag, const double* values, std::size_t count);
+            void flushRecord(bool continued);
+            std::size_t pendingSegments() const;
+
+            std::ostream& m_out;
+            std::size_t m_blockSegments;
+            std::vector<unsigned char> m_tags;
+            std::vector<double> m_values;
+            std::optional<DeltaEncoder> m_encoder;
+            bool m_open = false;
+            bool m_hasPoint = false;
+            geometry::Point2D m_lastPoint;
+            std::size_t m_contourCount = 0;
+        };
+    }
+}
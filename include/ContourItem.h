@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Contour.h"
+#include <QGraphicsItem>
+#include <QPainterPath>
+#include <QColor>
+#include <vector>
+#include <cstdint>
+
+// One scene item that paints a whole contour. Segments are grouped by
+// style so each color and thickness costs one setPen; line runs go through
+// QPainter::drawLines and arcs through cached paths. Painting is culled to
+// the exposed rect with the contour's segment index, so a frame costs
+// O(log n + visible segments) rather than one item per segment.
+class ContourItem : public QGraphicsItem
+{
+public:
+    explicit ContourItem(QGraphicsItem* parent = nullptr);
+
+    // Shows another contour through a copy-on-write snapshot and drops every
+    // cached arc path, O(n). Styles are kept by index; new segments get the
+    // first registered style
+    void setContour(const contour::Contour& contour);
+
+    // Shows an edit of the current contour: segments [first, oldEnd) were
+    // replaced by [first, newEnd) of contour. Only the replaced paths are
+    // dropped; the caches after the range move with their segments. Styles
+    // in the range are kept by position and extra segments get the first
+    // registered style. A replace costs O(newEnd - first). Falls back to
+    // setContour if the range does not fit the sizes
+    void replaceSegments(const contour::Contour& contour, size_t first, size_t oldEnd, size_t newEnd);
+    const contour::Contour& getContour() const { return m_contour; }
+
+    void setSegmentStyle(size_t segmentIndex, const QColor& color, double thickness);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    struct Style
+    {
+        QColor color;
+        double thickness;
+    };
+
+    std::uint32_t styleIndex(const QColor& color, double thickness);
+    void updateBounds();
+    const QPainterPath& arcPath(size_t segmentIndex) const;
+
+    contour::Contour m_contour;
+    QRectF m_bounds;
+    std::vector<Style> m_styles;
+    std::vector<std::uint32_t> m_segmentStyles;
+
+    // Arc paths are built on first paint; m_arcBuilt marks valid entries
+    mutable std::vector<QPainterPath> m_arcPaths;
+    mutable std::vector<bool> m_arcBuilt;
+};
@@ -3,14 +3,19 @@
 #include "Contour.h"
 #include "Segment.h"
 #include "Geometry.h"
+#include "GridHash.h"
 #include <QGraphicsScene>
 #include <QWidget>
 #include <QColor>
+#include <QBrush>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <memory>
 #include <vector>
 #include <map>
 
 // Forward declarations
+class ContourItem;
 class QGraphicsEllipseItem;
 class QGraphicsLineItem;
 class QGraphicsPathItem;
@@ -25,6 +30,11 @@ enum class DrawingMode {
     Arc
 };
 
+enum class RenderBackend {
+    Items,   // one QGraphicsItem per segment
+    Batched  // one ContourItem paints every segment
+};
+
 struct VertexInfo {
     size_t segmentIndex;
     bool isStartPoint;
@@ -53,10 +63,19 @@ public:
     
     bool isValid() const;
     bool isClosed() const;
+    const std::vector<size_t>& getDisconnectedJoints() const;
     
     void setShowGrid(bool show);
     void setSnapToGrid(bool snap);
     
+    // Level of detail: the view reports its zoom in pixels per scene unit.
+    // When a large contour's average segment is shorter than
+    // LOD_PIXEL_THRESHOLD pixels, the per-segment items and markers are
+    // hidden and each run of LOD_TILE_SEGMENTS segments is drawn as one
+    // simplified path instead; zooming back in restores full detail.
+    void setViewZoom(double pixelsPerUnit);
+    bool isLevelOfDetailActive() const { return m_lodActive; }
+    
     // Edit mode methods
     void setEditMode(EditMode mode);
     EditMode getEditMode() const { return m_editMode; }
@@ -65,12 +84,21 @@ public:
     void setDrawingMode(DrawingMode mode);
     DrawingMode getDrawingMode() const { return m_drawingMode; }
     
+    // Rendering backend; switching keeps per-segment colors and thickness
+    void setRenderBackend(RenderBackend backend);
+    RenderBackend getRenderBackend() const { return m_renderBackend; }
+    
     // Color management
     void setSegmentColor(size_t segmentIndex, const QColor& color);
     void setSegmentThickness(size_t segmentIndex, double thickness);
     QColor getSegmentColor(size_t segmentIndex) const;
     double getSegmentThickness(size_t segmentIndex) const;
     
+    // Hit-testing; both look up a grid hash, so the cost does not grow
+    // with the number of segments
+    VertexInfo* findVertexAt(const QPointF& pos, double tolerance = HIT_TOLERANCE);
+    int findSegmentAt(const QPointF& pos, double tolerance = HIT_TOLERANCE) const; // -1 if none
+    
     // Vertex editing
     void startVertexEdit(size_t segmentIndex, bool isStartPoint);
     void finishVertexEdit();
@@ -85,13 +113,17 @@ public:
     void setSignalEmissionEnabled(bool enabled) { m_isEmittingSignals = enabled; }
     bool isSignalEmissionEnabled() const { return m_isEmittingSignals; }
     
-    // Scene update method
+    // Brings the items in line with the contour, rebuilding only segments
+    // that differ from the last update. Chunks still shared with the shown
+    // snapshot are skipped unread; an insert or remove before the end still
+    // renumbers every later item and index entry, O(n)
     void updateScene();
 
 signals:
     void contourModified();
     void vertexEditStarted(size_t segmentIndex, bool isStartPoint);
     void vertexEditFinished();
+    void segmentPicked(size_t segmentIndex);
 
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
@@ -99,6 +131,10 @@ protected:
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
     void drawBackground(QPainter* painter, const QRectF& rect) override;
 
+private slots:
+    // Applies the newest coalesced mouse position to the dragged vertex or preview
+    void applyPendingMove();
+
 private:
     void createSegmentItem(const contour::Segment& segment, size_t segmentIndex);
     QPointF snapToGrid(const QPointF& point) const;
@@ -111,7 +147,24 @@ private:
     void updateVertexMarkersForSegment(size_t segmentIndex);
     void updateVertexMarkersForSegmentOnly(size_t segmentIndex);
     void removeVertexMarkers();
-    VertexInfo* findVertexAt(const QPointF& pos);
+    void addVertexMarkers(size_t segmentIndex);
+    void deleteVertexMarker(size_t slot);
+    void setVertex(size_t segmentIndex, bool isStartPoint, QGraphicsEllipseItem* marker, const geometry::Point2D& point);
+    void rebuildSegmentIndex();
+    void reindexSegment(size_t segmentIndex);
+    
+    // Level-of-detail helpers; the range is the segments that changed
+    void applyLevelOfDetail(size_t firstChanged, size_t lastChanged);
+    bool wantsLevelOfDetail() const;
+    void setDetailItemsVisible(bool visible);
+    void rebuildLodTiles(size_t firstChanged, size_t lastChanged);
+    void removeLodTiles();
+    void createContourItem();
+    
+    // Grid helpers; updateGridTile returns false when the view is zoomed in
+    // too far for a tile and the lines are drawn directly
+    bool updateGridTile(double pixelsPerUnit);
+    void drawGridLines(QPainter* painter, const QRectF& rect);
     void updateSegmentAfterVertexEdit(size_t segmentIndex, bool isStartPoint, const geometry::Point2D& newPoint);
     void updateSegmentVisual(size_t segmentIndex);
     void updateSegmentVisualOnly(size_t segmentIndex);
@@ -122,6 +175,7 @@ private:
     double getDefaultSegmentThickness(size_t segmentIndex) const;
 
     contour::Contour m_contour;
+    contour::Contour m_shownContour; // what the items show; shares storage with m_contour
     bool m_showGrid;
     bool m_snapToGrid;
     double m_gridSize;
@@ -144,6 +198,46 @@ private:
     QGraphicsEllipseItem* m_arcRadiusMarker;
     int m_arcStep; // Tracking urutan klik pada mode Draw Arc
     
+    // Hit-testing indexes. m_vertices[2 * i] and m_vertices[2 * i + 1] are
+    // the start and end of segment i; the grids hold those slot numbers and
+    // segment indices, and m_segmentBoxes the box each segment was hashed with
+    static constexpr double HIT_TOLERANCE = 6.0;
+    static constexpr double HIT_CELL_SIZE = 32.0;
+    contour::spatial::GridHash m_vertexGrid;
+    contour::spatial::GridHash m_segmentGrid;
+    std::vector<geometry::BoundingBox> m_segmentBoxes;
+    
+    // Level of detail. Tiles are simplified for m_lodZoom and rebuilt once
+    // the view zoom drifts more than LOD_REBUILD_RATIO away from it
+    static constexpr size_t LOD_MIN_SEGMENTS = 4096;
+    static constexpr size_t LOD_TILE_SEGMENTS = 4096;
+    static constexpr double LOD_PIXEL_THRESHOLD = 2.0;
+    static constexpr double LOD_TOLERANCE_PIXELS = 0.5;
+    static constexpr double LOD_REBUILD_RATIO = 1.5;
+    bool m_lodActive;
+    double m_viewZoom;
+    double m_lodZoom;
+    std::vector<QGraphicsPathItem*> m_lodTiles;
+    
+    // Batched rendering: segments have no items of their own, and
+    // m_segmentVisuals entries carry only the style
+    RenderBackend m_renderBackend;
+    ContourItem* m_contourItem;
+    
+    // Background grid: one major cell is rendered into a pixmap brush per
+    // zoom level and grid size. Every GRID_MAJOR_EVERY-th line is major, and
+    // the minor step grows by that factor until lines are GRID_MIN_PIXELS apart
+    static constexpr double GRID_MIN_PIXELS = 8.0;
+    static constexpr int GRID_MAJOR_EVERY = 5;
+    static constexpr int GRID_MAX_TILE_PIXELS = 512;
+    static inline const QColor GRID_MINOR_COLOR = QColor(220, 220, 220);
+    static inline const QColor GRID_MAJOR_COLOR = QColor(Qt::lightGray);
+    QBrush m_gridBrush;
+    double m_gridTileZoom;
+    double m_gridTileSize;
+    double m_gridMinorStep;
+    bool m_gridTileUsable;
+    
     // Vertex editing
     std::vector<VertexInfo> m_vertices;
     VertexInfo* m_editingVertex;
@@ -156,10 +250,15 @@ private:
     // Prevent infinite recursion
     bool m_isUpdatingScene;
     
-    // Mouse event throttling
+    // Mouse moves are coalesced: only the newest position is kept, and it is
+    // applied at most once per MOVE_FRAME_INTERVAL_MS
+    static constexpr int MOVE_FRAME_INTERVAL_MS = 16;
     QPointF m_lastMousePos;
     bool m_isMouseDragging;
-    int m_mouseUpdateCounter;
+    QTimer m_moveTimer;
+    QElapsedTimer m_moveClock;
+    QPointF m_pendingMovePos;
+    bool m_hasPendingMove;
     
     // Signal emission control
     bool m_isEmittingSignals;
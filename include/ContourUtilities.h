@@ -4,6 +4,10 @@
 #include "Geometry.h"
 #include <vector>
 #include <initializer_list>
+#include <memory_resource>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 
 namespace contour
 {
@@ -20,7 +24,9 @@ namespace contour
         // C-style array support
         Contour createPolylineContour(const geometry::Point2D* points, size_t count);
         
-        // Iterator-based version for maximum flexibility
+        // Iterator-based version for maximum flexibility. Works in one pass, so
+        // single-pass input iterators (e.g. points decoded from a stream) are
+        // accepted and no intermediate point vector is built
         template<typename Iterator>
         Contour createPolylineContour(Iterator begin, Iterator end);
 
@@ -40,6 +46,14 @@ namespace contour
         Contour createPolylineContour(const std::vector<geometry::Point2D>& points, 
                                      const PolylineOptions& options);
 
+        // Allocator-aware variants: segments and the contour's tables come from
+        // `resource`, e.g. a std::pmr::monotonic_buffer_resource shared by a batch
+        Contour createPolylineContour(const std::vector<geometry::Point2D>& points,
+                                      std::pmr::memory_resource* resource);
+        Contour createPolylineContour(const std::vector<geometry::Point2D>& points,
+                                      const PolylineOptions& options,
+                                      std::pmr::memory_resource* resource);
+
         // Utility functions for contour analysis and manipulation
         std::vector<geometry::Point2D> extractPoints(const Contour& contour);
         bool arePointsCollinear(const geometry::Point2D& p1, 
@@ -62,6 +76,32 @@ namespace contour
         double calculatePolygonArea(const std::vector<geometry::Point2D>& points);
         geometry::Point2D calculateCentroid(const std::vector<geometry::Point2D>& points);
         bool isClockwise(const std::vector<geometry::Point2D>& points);
+
+        // Arc-length resampling in a single sweep over the segments; arcs are
+        // stepped by rotation instead of per-sample trig. Output goes into a
+        // caller-provided buffer and nothing is allocated.
+
+        // Writes n points evenly spaced from the start to the end of the contour
+        void resampleUniform(const Contour& contour, size_t n, geometry::Point2D* out);
+
+        // Writes the points at distances 0, step, 2*step, ... up to the total
+        // length, at most capacity of them; returns how many were written
+        size_t resampleByStep(const Contour& contour, double step,
+                              geometry::Point2D* out, size_t capacity);
+
+        // Buffer size resampleByStep needs for the full sequence
+        size_t resampleByStepCount(const Contour& contour, double step);
+
+        // Level-of-detail flattening for display. Segments [first, last) become
+        // polylines whose consecutive vertices are at least tolerance apart,
+        // apart from each polyline's exact end point; arcs are flattened with a
+        // chord error below tolerance, and polylines spanning less than
+        // tolerance are dropped. A new polyline starts wherever a segment does
+        // not begin within tolerance of the previous end. points receives the
+        // vertices and starts the index where each polyline begins; both are
+        // cleared first.
+        void simplifyForDisplay(const Contour& contour, size_t first, size_t last, double tolerance,
+                                std::vector<geometry::Point2D>& points, std::vector<size_t>& starts);
     }
 }
 
@@ -81,8 +121,46 @@ namespace contour::utilities
     template<typename Iterator>
     Contour createPolylineContour(Iterator begin, Iterator end)
     {
-        std::vector<geometry::Point2D> pointVector(begin, end);
-        return createPolylineContour(pointVector);
+        using Category = typename std::iterator_traits<Iterator>::iterator_category;
+
+        Contour contour;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>)
+        {
+            const auto count = std::distance(begin, end);
+            if (count < 2)
+            {
+                throw std::invalid_argument("createPolylineContour: need at least 2 points");
+            }
+            contour.reserve(static_cast<Contour::size_type>(count - 1));
+        }
+
+        if (begin == end)
+        {
+            throw std::invalid_argument("createPolylineContour: need at least 2 points");
+        }
+        geometry::Point2D previous = *begin;
+        ++begin;
+        if (begin == end)
+        {
+            throw std::invalid_argument("createPolylineContour: need at least 2 points");
+        }
+
+        // Same pairing as the vector overload; zero-length segments are skipped
+        for (; begin != end; ++begin)
+        {
+            const geometry::Point2D point = *begin;
+            if (!previous.isEqual(point))
+            {
+                contour.addSegment(createLineSegment(previous, point, contour.getResource()));
+            }
+            previous = point;
+        }
+
+        if (contour.empty())
+        {
+            throw std::invalid_argument("createPolylineContour: all consecutive points are identical");
+        }
+        return contour;
     }
 
     template<typename Container>
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Contour.h"
+#include <cstddef>
+#include <iosfwd>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace contour
+{
+    namespace io
+    {
+        // Streaming reader for the ENTITIES section of an ASCII DXF drawing.
+        // LINE and ARC entities become one segment each, and an LWPOLYLINE
+        // becomes one segment per edge, with bulged edges as arcs and repeated
+        // vertices skipped. Other entities, and arcs or polylines outside the
+        // XY plane, are skipped and counted. The file is tokenized in place in
+        // one fixed buffer, so nothing is allocated per line. Throws
+        // std::runtime_error with the line number for a malformed file or
+        // invalid geometry.
+        class DxfReader
+        {
+        public:
+            explicit DxfReader(std::istream& in);
+
+            DxfReader(const DxfReader&) = delete;
+            DxfReader& operator=(const DxfReader&) = delete;
+
+            // Replaces block with up to maxSegments further segments in file
+            // order; returns how many, 0 once the entities are exhausted
+            std::size_t readSegments(std::vector<SegmentVariant>& block, std::size_t maxSegments);
+
+            // Supported entities read and other entities skipped so far
+            std::size_t getEntityCount() const { return m_entityCount; }
+            std::size_t getSkippedCount() const { return m_skippedCount; }
+
+        private:
+            bool readLine(std::string_view& line);
+            bool nextPair();
+            // The current value as a finite number, an arc angle in degrees,
+            // or an integer flag word
+            double number() const;
+            double angle() const;
+            long integer() const;
+            // Throws std::runtime_error naming `line`, or the current line for 0
+            [[noreturn]] void fail(const std::string& what, std::size_t line = 0) const;
+
+            // Positions on the first entity; false if the file has no ENTITIES section
+            bool findEntities();
+            // Decodes the entity at the current code 0 pair into m_pending;
+            // false at the end of the section
+            bool readEntity();
+            void addPolylineEdge(const geometry::Point2D& start, const geometry::Point2D& end, double bulge);
+
+            std::istream& m_in;
+            std::vector<char> m_buffer;
+            std::size_t m_begin = 0;
+            std::size_t m_end = 0;
+            bool m_endOfFile = false;
+            std::size_t m_lineNumber = 0;
+
+            // Current group; the value is valid until the next pair is read
+            int m_code = 0;
+            std::string_view m_value;
+
+            bool m_started = false;
+            bool m_finished = false;
+            std::vector<SegmentVariant> m_pending;
+            std::size_t m_nextPending = 0;
+            std::vector<geometry::Point2D> m_vertices;
+            std::vector<double> m_bulges;
+            std::size_t m_entityCount = 0;
+            std::size_t m_skippedCount = 0;
+        };
+
+        // Reads every supported entity, in file order, into one contour.
+        // Segments are allocated from `resource`, or with plain new if it is null.
+        Contour readDxf(std::istream& in, std::pmr::memory_resource* resource = nullptr);
+        Contour readDxf(const std::string& path, std::pmr::memory_resource* resource = nullptr);
+
+        // Writes a minimal AutoCAD R12 drawing with one LINE or ARC entity per
+        // segment. Clockwise arcs get a (0, 0, -1) extrusion, so they read back
+        // with their direction. Throws std::runtime_error if the stream or file fails.
+        void writeDxf(std::ostream& out, const Contour& contour);
+        void writeDxf(const std::string& path, const Contour& contour);
+    }
+}
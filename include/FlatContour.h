@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Contour.h"
+#include "Segment.h"
+#include "Geometry.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace contour
+{
+    // Structure-of-arrays contour for batch geometric kernels.
+    // Every segment contributes one entry to the start/end coordinate columns
+    // and the type column; arc-only parameters live in a side table so the
+    // per-segment columns stay dense and the kernel loops can auto-vectorize.
+    class FlatContour
+    {
+    public:
+        using size_type = std::size_t;
+
+        // Arc parameters, one entry per arc segment in contour order
+        struct ArcTable
+        {
+            std::vector<double> centerX;
+            std::vector<double> centerY;
+            std::vector<double> radius;
+            std::vector<double> startAngle; // normalized, in radians
+            std::vector<double> endAngle;   // normalized, in radians
+            std::vector<double> angleSpan;  // precomputed getAngleSpan()
+            std::vector<std::uint8_t> clockwise;
+            std::vector<size_type> segmentIndex; // owning index in the segment columns
+        };
+
+        FlatContour() = default;
+        explicit FlatContour(const Contour& contour);
+
+        // Construction
+        void reserve(size_type segmentCount);
+        void addLine(const geometry::Point2D& start, const geometry::Point2D& end);
+        void addArc(const geometry::Point2D& center, double radius,
+                    double startAngle, double endAngle, bool clockwise = false);
+        void addSegment(const Segment& segment);
+        void clear();
+
+        // Size
+        size_type size() const { return m_types.size(); }
+        bool empty() const { return m_types.empty(); }
+        size_type arcCount() const { return m_arcs.radius.size(); }
+
+        // Column access for kernels
+        const double* startX() const { return m_startX.data(); }
+        const double* startY() const { return m_startY.data(); }
+        const double* endX() const { return m_endX.data(); }
+        const double* endY() const { return m_endY.data(); }
+        const std::uint8_t* types() const { return m_types.data(); }
+        const ArcTable& arcs() const { return m_arcs; }
+
+        SegmentType typeAt(size_type index) const;
+
+        // Conversion back to the pointer-based layout
+        Contour toContour() const;
+
+    private:
+        std::vector<double> m_startX;
+        std::vector<double> m_startY;
+        std::vector<double> m_endX;
+        std::vector<double> m_endY;
+        std::vector<std::uint8_t> m_types; // SegmentType values
+        ArcTable m_arcs;
+    };
+
+    // Batch kernels over FlatContour columns
+    namespace kernels
+    {
+        double totalLength(const FlatContour& contour);
+        geometry::BoundingBox bounds(const FlatContour& contour);
+        bool isValid(const FlatContour& contour, double epsilon = geometry::EPSILON);
+
+        // Writes size()+1 vertices; out is resized, so a reused vector does not reallocate
+        void extractVertices(const FlatContour& contour, std::vector<geometry::Point2D>& out);
+    }
+}
@@ -48,6 +48,27 @@ namespace geometry
     // 2D Vector (alias for Point2D for clarity in usage)
     using Vector2D = Point2D;
 
+    // Axis-aligned bounding box; default-constructed boxes are empty
+    class BoundingBox
+    {
+    public:
+        Point2D minPoint;
+        Point2D maxPoint;
+
+        BoundingBox();
+        BoundingBox(const Point2D& minPoint, const Point2D& maxPoint);
+
+        bool isEmpty() const;
+        double width() const;
+        double height() const;
+        Point2D center() const;
+
+        void expand(const Point2D& point);
+        void expand(const BoundingBox& other);
+        bool contains(const Point2D& point) const;
+        bool intersects(const BoundingBox& other) const;
+    };
+
     // Utility functions
     bool isEqual(double a, double b, double epsilon = EPSILON);
     double degreesToRadians(double degrees);
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Geometry.h"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace contour
+{
+    namespace spatial
+    {
+        // Uniform-grid spatial hash for small, frequently edited item sets.
+        // Items are bucketed by every cell their box touches; only occupied
+        // cells are stored. Insert, erase and a query over a region a few
+        // cells wide all cost O(1) on average, independent of the item count.
+        // Boxes touching more than MAX_ITEM_CELLS cells go to an overflow list
+        // that every query reports, so one huge item cannot flood the table.
+        class GridHash
+        {
+        public:
+            using size_type = std::size_t;
+
+            explicit GridHash(double cellSize = 1.0);
+
+            // Changing the cell size empties the hash
+            void setCellSize(double cellSize);
+            double cellSize() const { return m_cellSize; }
+
+            void insert(size_type item, const geometry::Point2D& point);
+            void insert(size_type item, const geometry::BoundingBox& box);
+            // Must be called with the point or box the item was inserted with
+            void erase(size_type item, const geometry::Point2D& point);
+            void erase(size_type item, const geometry::BoundingBox& box);
+            void clear();
+
+            // Number of occupied cells
+            size_type cellCount() const { return m_cells.size(); }
+            bool empty() const { return m_cells.empty() && m_oversized.empty(); }
+
+            // Calls visit(item) for every item in a cell touched by range. An
+            // item spanning several cells is reported once per cell, so the
+            // visitor must tolerate duplicates and do its own exact test.
+            template<typename Visitor>
+            void query(const geometry::BoundingBox& range, Visitor&& visit) const;
+
+            static constexpr double MAX_ITEM_CELLS = 256.0;
+
+        private:
+            double m_cellSize;
+            std::unordered_map<std::uint64_t, std::vector<size_type>> m_cells;
+            std::vector<size_type> m_oversized;
+
+            std::int32_t cellOf(double coordinate) const;
+            static std::uint64_t pack(std::int32_t cx, std::int32_t cy);
+            void cellRange(const geometry::BoundingBox& box, std::int32_t& minX, std::int32_t& minY,
+                           std::int32_t& maxX, std::int32_t& maxY) const;
+            static double cellsSpanned(std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY);
+            void eraseFromCell(std::uint64_t cell, size_type item);
+        };
+
+        template<typename Visitor>
+        void GridHash::query(const geometry::BoundingBox& range, Visitor&& visit) const
+        {
+            if (range.isEmpty())
+            {
+                return;
+            }
+            for (size_type item : m_oversized)
+            {
+                visit(item);
+            }
+            if (m_cells.empty())
+            {
+                return;
+            }
+
+            std::int32_t minX, minY, maxX, maxY;
+            cellRange(range, minX, minY, maxX, maxY);
+
+            // A range covering more cells than are occupied is cheaper to answer
+            // by walking the occupied cells
+            if (cellsSpanned(minX, minY, maxX, maxY) > static_cast<double>(m_cells.size()))
+            {
+                for (const auto& entry : m_cells)
+                {
+                    const std::int32_t cx = static_cast<std::int32_t>(static_cast<std::uint32_t>(entry.first >> 32));
+                    const std::int32_t cy = static_cast<std::int32_t>(static_cast<std::uint32_t>(entry.first));
+                    if (cx >= minX && cx <= maxX && cy >= minY && cy <= maxY)
+                    {
+                        for (size_type item : entry.second)
+                        {
+                            visit(item);
+                        }
+                    }
+                }
+                return;
+            }
+
+            for (std::int32_t cx = minX; cx <= maxX; ++cx)
+            {
+                for (std::int32_t cy = minY; cy <= maxY; ++cy)
+                {
+                    auto it = m_cells.find(pack(cx, cy));
+                    if (it == m_cells.end())
+                    {
+                        continue;
+                    }
+                    for (size_type item : it->second)
+                    {
+                        visit(item);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+
+namespace contour
+{
+    namespace log
+    {
+        enum class Level : int
+        {
+            Trace,
+            Debug,
+            Info,
+            Warning,
+            Error,
+            Off
+        };
+
+        // Bit flags; setCategories takes any combination of them
+        enum Category : std::uint32_t
+        {
+            Core = 1u << 0,
+            Scene = 1u << 1,
+            Input = 1u << 2,
+            Render = 1u << 3,
+            AllCategories = 0xFFFFFFFFu
+        };
+
+        struct Record
+        {
+            Level level;
+            std::uint32_t category;
+            std::chrono::system_clock::time_point time;
+            std::string message;
+        };
+
+        using Sink = std::function<void(const Record&)>;
+
+        namespace detail
+        {
+            extern std::atomic<int> g_level;
+            extern std::atomic<std::uint32_t> g_categories;
+        }
+
+        // Records below the level or outside the category mask are discarded
+        // before their message is formatted. Debug builds default to Debug,
+        // release builds to Info; all categories are enabled.
+        void setLevel(Level level);
+        Level getLevel();
+        void setCategories(std::uint32_t mask);
+        std::uint32_t getCategories();
+
+        inline bool isEnabled(Level level, std::uint32_t category)
+        {
+            return static_cast<int>(level) >= detail::g_level.load(std::memory_order_relaxed)
+                && (category & detail::g_categories.load(std::memory_order_relaxed)) != 0;
+        }
+
+        // Queues a record in a fixed-size ring buffer and returns without
+        // doing any I/O; a background thread hands records to the sink in
+        // batches. When the ring is full the oldest record is dropped.
+        void write(Level level, std::uint32_t category, std::string message);
+
+        // Replaces the sink; an empty sink restores the default, which writes
+        // one "[LEVEL] [category] message" line per record to std::clog and
+        // flushes once per batch. Records already queued go to the new sink.
+        void setSink(Sink sink);
+
+        // Blocks until every record written before the call reached the sink
+        void flush();
+
+        // Records lost to a full ring since startup
+        std::size_t getDroppedCount();
+
+        const char* levelName(Level level);
+        const char* categoryName(std::uint32_t category);
+    }
+}
+
+// The stream expression is evaluated only when the record is enabled
+#define CONTOUR_LOG(level, category, expr)                                              \
+    do {                                                                                \
+        if (::contour::log::isEnabled(level, category)) {                               \
+            std::ostringstream contourLogStream_;                                       \
+            contourLogStream_ << expr;                                                  \
+            ::contour::log::write(level, category, contourLogStream_.str());            \
+        }                                                                               \
+    } while (false)
+
+// Trace records are compiled out of release builds; the discarded branch keeps
+// the expression type-checked so trace-only variables do not become unused
+#if defined(NDEBUG) && !defined(CONTOUR_LOG_KEEP_TRACE)
+#define CONTOUR_TRACE(category, expr)                                                   \
+    do {                                                                                \
+        if constexpr (false) {                                                          \
+            std::ostringstream contourLogStream_;                                       \
+            contourLogStream_ << expr;                                                  \
+            static_cast<void>(category);                                                \
+        }                                                                               \
+    } while (false)
+#else
+#define CONTOUR_TRACE(category, expr) CONTOUR_LOG(::contour::log::Level::Trace, category, expr)
+#endif
+
+#define CONTOUR_DEBUG(category, expr) CONTOUR_LOG(::contour::log::Level::Debug, category, expr)
+#define CONTOUR_INFO(category, expr) CONTOUR_LOG(::contour::log::Level::Info, category, expr)
+#define CONTOUR_WARNING(category, expr) CONTOUR_LOG(::contour::log::Level::Warning, category, expr)
+#define CONTOUR_ERROR(category, expr) CONTOUR_LOG(::contour::log::Level::Error, category, expr)
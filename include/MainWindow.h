@@ -35,6 +35,7 @@ private slots:
     void onClearContour();
     void onToggleGrid();
     void onToggleSnap();
+    void onToggleBatchedRendering();
     void onAbout();
     void onContourModified();
     // Semua operasi edit hanya dari Segment Management
@@ -45,6 +46,7 @@ private slots:
     void onSegmentTypeChanged(int index);
     void onInsertPositionChanged(int value);
     void onSegmentSelectChanged(int value);
+    void onSegmentPicked(size_t segmentIndex);
 
 private:
     void setupUI();
@@ -97,5 +99,6 @@ private:
     QAction* m_clearAction;
     QAction* m_gridAction;
     QAction* m_snapAction;
+    QAction* m_batchedRenderingAction;
     QAction* m_aboutAction;
 }; 
\ No newline at end of file
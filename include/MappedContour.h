@@ -0,0 +1,139 @@
+#pragma once
+
+#include "ContourIO.h"
+#include "Segment.h"
+#include "Geometry.h"
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace contour
+{
+    namespace io
+    {
+        // Read-only memory mapping of a whole file. Pages are loaded by the
+        // operating system on first access, so mapping costs nothing until the
+        // data is read. Throws std::runtime_error if the file cannot be mapped.
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const std::string& path);
+            ~MappedFile();
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const unsigned char* data() const { return m_data; }
+            std::size_t size() const { return m_size; }
+
+        private:
+            void release() noexcept;
+
+            const unsigned char* m_data = nullptr;
+            std::size_t m_size = 0;
+#ifdef _WIN32
+            void* m_file = nullptr;
+            void* m_mapping = nullptr;
+#endif
+        };
+
+        // Zero-copy view of one .cnt contour inside a mapped file. Segments are
+        // decoded from the mapped pages into SegmentVariant values as they are
+        // visited; nothing is allocated per segment, and only the record
+        // headers are read when the view is created. A contour split over
+        // continued records is viewed as one. The view borrows the file, which
+        // must outlive it. Queries walk the segments once; decoding a malformed
+        // segment throws std::runtime_error.
+        // Compressed records cannot be viewed in place and are rejected with
+        // std::runtime_error.
+        class MappedContour
+        {
+        private:
+            // One record of the contour; next is null after the last one
+            struct Record
+            {
+                const unsigned char* tags = nullptr;
+                const unsigned char* tagsEnd = nullptr;
+                const unsigned char* payload = nullptr;
+                const unsigned char* payloadEnd = nullptr;
+                const unsigned char* next = nullptr;
+            };
+
+            // Checks the header at start and that the record fits before limit
+            static Record recordAt(const unsigned char* start, const unsigned char* limit);
+
+        public:
+            using size_type = std::size_t;
+            class const_iterator;
+
+            // Views the contour starting at byte `offset`; throws
+            // std::runtime_error if a header is invalid or a record does not fit
+            explicit MappedContour(const MappedFile& file, std::size_t offset = 0);
+
+            // Offset just past this contour, where the next one in an archive starts
+            std::size_t endOffset() const { return m_endOffset; }
+
+            size_type size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            // Same results as the Contour queries of the same names
+            double getTotalLength() const;
+            bool isValid(double epsilon = geometry::EPSILON) const;
+            bool isClosed(double epsilon = geometry::EPSILON) const;
+            std::vector<geometry::Point2D> getVertices() const;
+            geometry::BoundingBox getBoundingBox() const;
+
+            // Copies the segments into an ordinary contour
+            Contour toContour(std::pmr::memory_resource* resource = nullptr) const;
+
+            // Forward iterator; dereferencing decodes the segment by value
+            class const_iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = SegmentVariant;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = SegmentVariant;
+
+                const_iterator() = default;
+
+                SegmentVariant operator*() const;
+                const_iterator& operator++();
+                const_iterator operator++(int) { const_iterator previous = *this; ++*this; return previous; }
+
+                bool operator==(const const_iterator& other) const { return m_tag == other.m_tag; }
+                bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+            private:
+                friend class MappedContour;
+                const_iterator(const Record& record, const unsigned char* limit);
+                explicit const_iterator(const unsigned char* tag) : m_tag(tag) {}
+
+                // Steps into the next record while the current one is used up
+                void skipFinishedRecords();
+
+                const unsigned char* m_tag = nullptr;
+                const unsigned char* m_tagsEnd = nullptr;
+                const unsigned char* m_values = nullptr;
+                const unsigned char* m_valuesEnd = nullptr;
+                const unsigned char* m_next = nullptr;
+                const unsigned char* m_limit = nullptr;
+            };
+
+        private:
+            Record m_first;
+            const unsigned char* m_lastTagsEnd = nullptr;
+            const unsigned char* m_limit = nullptr;
+            size_type m_size = 0;
+            std::size_t m_endOffset = 0;
+        };
+    }
+}
@@ -2,6 +2,9 @@
 
 #include "Geometry.h"
 #include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <type_traits>
 #include <variant>
 
 namespace contour
@@ -31,6 +34,10 @@ namespace contour
         virtual SegmentType getType() const = 0;
         virtual std::unique_ptr<Segment> clone() const = 0;
         virtual double getLength() const = 0;
+        virtual geometry::Point2D getPointAt(double t) const = 0;      // t in [0,1]
+        virtual geometry::Vector2D getTangentAt(double t) const = 0;   // unit direction of travel
+        virtual geometry::BoundingBox getBoundingBox() const = 0;       // exact, arcs included
+        virtual double distanceTo(const geometry::Point2D& point) const = 0; // to the closest point on the segment
 
         // Common functionality
         bool isConnectedTo(const Segment& other, double epsilon = geometry::EPSILON) const;
@@ -46,7 +53,7 @@ namespace contour
     };
 
     // Line segment class
-    class LineSegment : public Segment
+    class LineSegment final : public Segment
     {
     private:
         geometry::Point2D m_start;
@@ -69,15 +76,19 @@ namespace contour
         SegmentType getType() const override;
         std::unique_ptr<Segment> clone() const override;
         double getLength() const override;
+        geometry::Point2D getPointAt(double t) const override; // t in [0,1]
+        geometry::Vector2D getTangentAt(double t) const override;
+        geometry::BoundingBox getBoundingBox() const override;
+        double distanceTo(const geometry::Point2D& point) const override;
         bool isEqual(const Segment& other, double epsilon = geometry::EPSILON) const override;
+        bool isEqual(const LineSegment& other, double epsilon = geometry::EPSILON) const;
 
         // Line-specific methods
         geometry::Vector2D getDirection() const;
-        geometry::Point2D getPointAt(double t) const; // t in [0,1]
     };
 
     // Arc segment class
-    class ArcSegment : public Segment
+    class ArcSegment final : public Segment
     {
     private:
         geometry::Point2D m_center;
@@ -104,7 +115,12 @@ namespace contour
         SegmentType getType() const override;
         std::unique_ptr<Segment> clone() const override;
         double getLength() const override;
+        geometry::Point2D getPointAt(double t) const override; // t in [0,1]
+        geometry::Vector2D getTangentAt(double t) const override;
+        geometry::BoundingBox getBoundingBox() const override; // endpoints plus axis crossings
+        double distanceTo(const geometry::Point2D& point) const override;
         bool isEqual(const Segment& other, double epsilon = geometry::EPSILON) const override;
+        bool isEqual(const ArcSegment& other, double epsilon = geometry::EPSILON) const;
 
         // Arc-specific methods
         geometry::Point2D getCenter() const { return m_center; }
@@ -113,18 +129,83 @@ namespace contour
         double getEndAngle() const { return m_endAngle; }
         bool isClockwise() const { return m_clockwise; }
         double getAngleSpan() const;
-        geometry::Point2D getPointAt(double t) const; // t in [0,1]
 
     private:
         geometry::Point2D pointFromAngle(double angle) const;
+        double angleAt(double t) const;
         double normalizeAngle(double angle) const;
     };
 
+    // Deleter for segments that may live in a std::pmr::memory_resource.
+    // A null resource means the segment was allocated with plain new, so any
+    // std::unique_ptr<Segment> converts to SegmentPtr implicitly.
+    struct SegmentDeleter
+    {
+        std::pmr::memory_resource* resource = nullptr;
+
+        SegmentDeleter() = default;
+        explicit SegmentDeleter(std::pmr::memory_resource* memoryResource) : resource(memoryResource) {}
+
+        template<typename T, typename = std::enable_if_t<std::is_base_of_v<Segment, T>>>
+        SegmentDeleter(const std::default_delete<T>&) {}
+
+        void operator()(Segment* segment) const;
+    };
+
+    using SegmentPtr = std::unique_ptr<Segment, SegmentDeleter>;
+
     // Type-safe variant for holding different segment types
     using SegmentVariant = std::variant<LineSegment, ArcSegment>;
 
+    // Copies a polymorphic segment into its value representation
+    SegmentVariant toSegmentVariant(const Segment& segment);
+
+    // Expands `box` by the points at 0, 90, 180 and 270 degrees that lie inside
+    // an arc's sweep; with the two endpoints these give the arc's exact bounds
+    void expandByArcExtremes(geometry::BoundingBox& box, const geometry::Point2D& center, double radius,
+                             double startAngle, double angleSpan, bool clockwise);
+
+    // Points where two segments meet: none, one (a crossing, a touch or a
+    // tangency) or two. Collinear lines and arcs on the same circle give the
+    // ends of their shared stretch. Arcs are taken with their direction and
+    // span; tolerance is a distance, applied along and across the segments.
+    struct Intersection
+    {
+        int count = 0;
+        geometry::Point2D points[2];
+    };
+
+    Intersection intersect(const LineSegment& first, const LineSegment& second, double tolerance = geometry::EPSILON);
+    Intersection intersect(const LineSegment& line, const ArcSegment& arc, double tolerance = geometry::EPSILON);
+    Intersection intersect(const ArcSegment& arc, const LineSegment& line, double tolerance = geometry::EPSILON);
+    Intersection intersect(const ArcSegment& first, const ArcSegment& second, double tolerance = geometry::EPSILON);
+    Intersection intersect(const SegmentVariant& first, const SegmentVariant& second, double tolerance = geometry::EPSILON);
+    Intersection intersect(const Segment& first, const Segment& second, double tolerance = geometry::EPSILON);
+
+    // Batch forms: test segment against candidates[0, count) and write one
+    // result per candidate to results[0, count). The segment is prepared
+    // once and nothing is allocated. Returns how many candidates meet it.
+    std::size_t intersectBatch(const LineSegment& segment, const LineSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance = geometry::EPSILON);
+    std::size_t intersectBatch(const LineSegment& segment, const ArcSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance = geometry::EPSILON);
+    std::size_t intersectBatch(const ArcSegment& segment, const LineSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance = geometry::EPSILON);
+    std::size_t intersectBatch(const ArcSegment& segment, const ArcSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance = geometry::EPSILON);
+    std::size_t intersectBatch(const SegmentVariant& segment, const SegmentVariant* candidates, std::size_t count,
+                               Intersection* results, double tolerance = geometry::EPSILON);
+
     // Factory functions for creating segments
     std::unique_ptr<Segment> createLineSegment(const geometry::Point2D& start, const geometry::Point2D& end);
     std::unique_ptr<Segment> createArcSegment(const geometry::Point2D& center, double radius, 
                                               double startAngle, double endAngle, bool clockwise = false);
+
+    // Allocator-aware factories: the segment is placed in `resource` (plain new if null)
+    SegmentPtr createLineSegment(const geometry::Point2D& start, const geometry::Point2D& end,
+                                 std::pmr::memory_resource* resource);
+    SegmentPtr createArcSegment(const geometry::Point2D& center, double radius,
+                                double startAngle, double endAngle, bool clockwise,
+                                std::pmr::memory_resource* resource);
+    SegmentPtr cloneSegment(const Segment& segment, std::pmr::memory_resource* resource);
 } 
\ No newline at end of file
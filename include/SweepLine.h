@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Contour.h"
+#include <vector>
+
+namespace contour
+{
+    namespace sweep
+    {
+        // Bentley-Ottmann sweep over the x-monotone pieces of a contour's
+        // segments; arcs are cut at their leftmost and rightmost points. Reports every
+        // point where two segments touch or cross, except the joint shared by
+        // connected neighbours. O((n + k) log n) for k crossings.
+        //
+        // With stopAtFirst the sweep returns at the first crossing, which makes
+        // it a Shamos-Hoey simplicity test: O(n log n) for simple contours.
+        std::vector<Contour::Crossing> findCrossings(const Contour& contour, bool stopAtFirst = false);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Segment.h"
+#include "Contour.h"
+#include "Geometry.h"
+#include <vector>
+#include <optional>
+#include <variant>
+
+namespace contour
+{
+    // Contour that stores its segments by value in one contiguous buffer.
+    // Segments are SegmentVariant values instead of individually allocated
+    // objects, and all bulk queries dispatch through std::visit on the
+    // concrete type, so there is no pointer chase or virtual call per segment.
+    class VariantContour
+    {
+    public:
+        // Type aliases for clarity
+        using SegmentContainer = std::vector<SegmentVariant>;
+        using const_iterator = SegmentContainer::const_iterator;
+        using size_type = SegmentContainer::size_type;
+
+        // Constructors and destructor
+        VariantContour() = default;
+        explicit VariantContour(SegmentContainer segments);
+        explicit VariantContour(const Contour& contour);
+        ~VariantContour() = default;
+
+        // Value semantics - copies are plain buffer copies
+        VariantContour(const VariantContour&) = default;
+        VariantContour& operator=(const VariantContour&) = default;
+        VariantContour(VariantContour&&) noexcept = default;
+        VariantContour& operator=(VariantContour&&) noexcept = default;
+
+        // Segment management
+        void reserve(size_type capacity) { m_segments.reserve(capacity); }
+        void addSegment(SegmentVariant segment);
+        void addLine(const geometry::Point2D& start, const geometry::Point2D& end);
+        void addArc(const geometry::Point2D& center, double radius,
+                    double startAngle, double endAngle, bool clockwise = false);
+        void insertSegment(size_type index, SegmentVariant segment);
+        void removeSegment(size_type index);
+        void replaceSegment(size_type index, SegmentVariant segment);
+        void clear();
+
+        // Access methods (read-only, segments are replaced rather than mutated)
+        size_type size() const { return m_segments.size(); }
+        bool empty() const { return m_segments.empty(); }
+
+        const SegmentVariant& operator[](size_type index) const;
+        const SegmentVariant& at(size_type index) const;
+
+        // Polymorphic view of a stored segment
+        const Segment& segmentAt(size_type index) const;
+
+        const_iterator begin() const { return m_segments.begin(); }
+        const_iterator end() const { return m_segments.end(); }
+        const_iterator cbegin() const { return m_segments.cbegin(); }
+        const_iterator cend() const { return m_segments.cend(); }
+
+        // Validation with caching
+        bool isValid(double epsilon = geometry::EPSILON) const;
+
+        // Utility methods
+        double getTotalLength() const;
+        std::vector<geometry::Point2D> getVertices() const;
+        bool isClosed(double epsilon = geometry::EPSILON) const;
+
+        // Comparison
+        bool isEqual(const VariantContour& other, double epsilon = geometry::EPSILON) const;
+
+        // Conversion back to the pointer-based layout
+        Contour toContour() const;
+
+    private:
+        SegmentContainer m_segments;
+
+        // Caching for isValid() - mutable to allow modification in const methods
+        mutable std::optional<bool> m_validityCache;
+        mutable double m_lastEpsilon = -1.0;
+
+        // Helper methods
+        void invalidateCache() const;
+        bool calculateValidity(double epsilon) const;
+    };
+
+    // Global operators
+    bool operator==(const VariantContour& lhs, const VariantContour& rhs);
+    bool operator!=(const VariantContour& lhs, const VariantContour& rhs);
+}
@@ -0,0 +1,165 @@
+#include "../include/BoxTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace contour
+{
+    namespace spatial
+    {
+        namespace
+        {
+            // Doubled box center; NaN boxes sort last so nth_element stays well-defined
+            geometry::Point2D centroidKey(const geometry::BoundingBox& box)
+            {
+                const double x = box.minPoint.x + box.maxPoint.x;
+                const double y = box.minPoint.y + box.maxPoint.y;
+                const double last = std::numeric_limits<double>::infinity();
+                return geometry::Point2D(std::isnan(x) ? last : x, std::isnan(y) ? last : y);
+            }
+        }
+
+        double distanceToBox(const geometry::BoundingBox& box, const geometry::Point2D& point)
+        {
+            if (box.isEmpty())
+            {
+                return std::numeric_limits<double>::infinity();
+            }
+            const double dx = std::max({ box.minPoint.x - point.x, 0.0, point.x - box.maxPoint.x });
+            const double dy = std::max({ box.minPoint.y - point.y, 0.0, point.y - box.maxPoint.y });
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        BoxTree::BoxTree(std::pmr::memory_resource* resource)
+            : m_nodes(resource)
+            , m_items(resource)
+            , m_parents(resource)
+            , m_leaves(resource)
+        {
+        }
+
+        BoxTree::BoxTree(const BoxTree& other, std::pmr::memory_resource* resource)
+            : m_nodes(other.m_nodes, resource)
+            , m_items(other.m_items, resource)
+            , m_parents(other.m_parents, resource)
+            , m_leaves(other.m_leaves, resource)
+        {
+        }
+
+        void BoxTree::build(const geometry::BoundingBox* boxes, size_type count)
+        {
+            if (count > std::numeric_limits<std::uint32_t>::max())
+            {
+                throw std::length_error("BoxTree::build: too many boxes");
+            }
+
+            clear();
+            if (count == 0)
+            {
+                return;
+            }
+
+            m_items.resize(count);
+            m_leaves.resize(count);
+            std::vector<geometry::Point2D> centroids(count);
+            for (size_type i = 0; i < count; ++i)
+            {
+                m_items[i] = static_cast<std::uint32_t>(i);
+                centroids[i] = centroidKey(boxes[i]);
+            }
+
+            // A binary tree with leaves of at least one item has fewer than 2 * count nodes
+            m_nodes.reserve(2 * count);
+            m_parents.reserve(2 * count);
+            m_nodes.emplace_back();
+            m_parents.push_back(0);
+            subdivide(0, 0, count, boxes, centroids.data());
+        }
+
+        void BoxTree::clear()
+        {
+            m_nodes.clear();
+            m_items.clear();
+            m_parents.clear();
+            m_leaves.clear();
+        }
+
+        void BoxTree::refit(size_type item, const geometry::BoundingBox* boxes)
+        {
+            if (item >= m_leaves.size())
+            {
+                throw std::out_of_range("BoxTree::refit: item out of range");
+            }
+
+            size_type node = m_leaves[item];
+            geometry::BoundingBox box;
+            for (std::uint32_t i = m_nodes[node].first; i < m_nodes[node].first + m_nodes[node].count; ++i)
+            {
+                box.expand(boxes[m_items[i]]);
+            }
+            m_nodes[node].box = box;
+            while (node != 0)
+            {
+                node = m_parents[node];
+                box = m_nodes[m_nodes[node].first].box;
+                box.expand(m_nodes[m_nodes[node].first + 1].box);
+                m_nodes[node].box = box;
+            }
+        }
+
+        void BoxTree::subdivide(size_type node, size_type begin, size_type end,
+                                const geometry::BoundingBox* boxes, const geometry::Point2D* centroids)
+        {
+            if (end - begin <= LEAF_SIZE)
+            {
+                geometry::BoundingBox box;
+                for (size_type i = begin; i < end; ++i)
+                {
+                    box.expand(boxes[m_items[i]]);
+                    m_leaves[m_items[i]] = static_cast<std::uint32_t>(node);
+                }
+                m_nodes[node].box = box;
+                m_nodes[node].first = static_cast<std::uint32_t>(begin);
+                m_nodes[node].count = static_cast<std::uint32_t>(end - begin);
+                return;
+            }
+
+            // Median split on the wider centroid axis keeps the depth at log2(count)
+            double minX = std::numeric_limits<double>::infinity();
+            double minY = minX;
+            double maxX = -minX;
+            double maxY = -minX;
+            for (size_type i = begin; i < end; ++i)
+            {
+                const geometry::Point2D& c = centroids[m_items[i]];
+                minX = std::min(minX, c.x);
+                minY = std::min(minY, c.y);
+                maxX = std::max(maxX, c.x);
+                maxY = std::max(maxY, c.y);
+            }
+            const bool alongX = maxX - minX >= maxY - minY;
+            const size_type middle = begin + (end - begin) / 2;
+            std::nth_element(m_items.begin() + begin, m_items.begin() + middle, m_items.begin() + end,
+                             [centroids, alongX](std::uint32_t a, std::uint32_t b) {
+                                 return alongX ? centroids[a].x < centroids[b].x : centroids[a].y < centroids[b].y;
+                             });
+
+            const size_type left = m_nodes.size();
+            m_nodes.emplace_back();
+            m_nodes.emplace_back();
+            m_parents.push_back(static_cast<std::uint32_t>(node));
+            m_parents.push_back(static_cast<std::uint32_t>(node));
+            m_nodes[node].first = static_cast<std::uint32_t>(left);
+            m_nodes[node].count = 0;
+
+            subdivide(left, begin, middle, boxes, centroids);
+            subdivide(left + 1, middle, end, boxes, centroids);
+
+            // Internal boxes are the union of the children, so each item box is read once
+            geometry::BoundingBox box = m_nodes[left].box;
+            box.expand(m_nodes[left + 1].box);
+            m_nodes[node].box = box;
+        }
+    }
+}
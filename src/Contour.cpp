@@ -1,178 +1,719 @@
 #include "../include/Contour.h"
+#include "../include/SweepLine.h"
 #include <stdexcept>
 #include <algorithm>
 #include <utility>
+#include <cmath>
+#include <limits>
+#include <atomic>
 #include <string> // Added for std::to_string
 
 namespace contour
 {
-    // Constructor with segments
-    Contour::Contour(SegmentContainer segments) : m_segments(std::move(segments))
+    namespace
     {
-        // No need to validate here, let isValid() handle validation when called
+        const std::vector<Contour::size_type> NO_JOINTS;
+
+        std::pmr::memory_resource* resourceOrDefault(std::pmr::memory_resource* resource)
+        {
+            return resource ? resource : std::pmr::get_default_resource();
+        }
+
+        // Same test as isConnectedTo at geometry::EPSILON; NaN gaps count as broken
+        bool isBrokenGap(double gap)
+        {
+            return !(gap < geometry::EPSILON);
+        }
+
+        // Turns v[first, first + removed) into `added` default values
+        template<typename Vector>
+        void spliceRange(Vector& v, std::size_t first, std::size_t removed, std::size_t added)
+        {
+            if (added > removed)
+            {
+                v.insert(v.begin() + first + removed, added - removed, typename Vector::value_type());
+            }
+            else
+            {
+                v.erase(v.begin() + first + added, v.begin() + first + removed);
+            }
+        }
+
+        // True if replacing the boxes in `removed` by those in `added` can
+        // shrink `bounds`, i.e. some edge was reached only by removed boxes
+        bool mayShrink(const geometry::BoundingBox& bounds, const geometry::BoundingBox& removed,
+                       const geometry::BoundingBox& added)
+        {
+            return (!(removed.minPoint.x > bounds.minPoint.x) && !(added.minPoint.x <= bounds.minPoint.x)) ||
+                   (!(removed.minPoint.y > bounds.minPoint.y) && !(added.minPoint.y <= bounds.minPoint.y)) ||
+                   (!(removed.maxPoint.x < bounds.maxPoint.x) && !(added.maxPoint.x >= bounds.maxPoint.x)) ||
+                   (!(removed.maxPoint.y < bounds.maxPoint.y) && !(added.maxPoint.y >= bounds.maxPoint.y));
+        }
+
+        // use_count() is a relaxed read; the fence orders our writes after any
+        // reads made through copies that other threads have since released
+        template<typename T>
+        bool isShared(const std::shared_ptr<T>& pointer)
+        {
+            if (pointer.use_count() > 1)
+            {
+                return true;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return false;
+        }
     }
 
-    // Copy constructor - deep copy
-    Contour::Contour(const Contour& other)
+    // Storage blocks
+    Contour::Chunk::Chunk(std::pmr::memory_resource* resource)
+        : segments(resource)
+        , jointGaps(resource)
+        , cumulativeLengths(resource)
+        , boxes(resource)
+        , tree(resource)
     {
-        deepCopyFrom(other);
     }
 
-    // Copy assignment operator - deep copy
-    Contour& Contour::operator=(const Contour& other)
+    Contour::Table::Table(std::pmr::memory_resource* resource)
+        : chunks(resource)
+        , segmentEnds(resource)
+        , lengthEnds(resource)
+        , chunkGaps(resource)
+        , boundaryGaps(resource)
+        , chunkBoxes(resource)
+        , chunkTree(resource)
     {
-        if (this != &other)
+    }
+
+    Contour::Table::Table(const Table& other, std::pmr::memory_resource* resource)
+        : chunks(other.chunks, resource)
+        , segmentEnds(other.segmentEnds, resource)
+        , lengthEnds(other.lengthEnds, resource)
+        , chunkGaps(other.chunkGaps, resource)
+        , boundaryGaps(other.boundaryGaps, resource)
+        , brokenJoints(other.brokenJoints)
+        , maxGap(other.maxGap)
+        , bounds(other.bounds)
+        , chunkBoxes(other.chunkBoxes, resource)
+        , chunkTree(other.chunkTree, resource)
+        , uniform(other.uniform)
+    {
+    }
+
+    Contour::const_iterator& Contour::const_iterator::operator++()
+    {
+        if (++m_offset == m_table->chunks[m_chunk]->segments.size())
         {
-            deepCopyFrom(other);
+            ++m_chunk;
+            m_offset = 0;
         }
         return *this;
     }
 
+    // Spatial traversal shared by the query methods
+    template<typename Visitor>
+    void Contour::visitChunks(const geometry::BoundingBox& range, Visitor&& visit) const
+    {
+        if (!m_table)
+        {
+            return;
+        }
+        const Table& table = *m_table;
+        table.chunkTree.query(range, table.chunkBoxes.data(), visit);
+        for (size_type c = table.chunkTree.size(); c < table.chunks.size(); ++c)
+        {
+            if (table.chunkBoxes[c].intersects(range))
+            {
+                visit(c);
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void Contour::visitSegments(const Chunk& chunk, const geometry::BoundingBox& range, Visitor&& visit) const
+    {
+        chunk.tree.query(range, chunk.boxes.data(), visit);
+        for (size_type i = chunk.tree.size(); i < chunk.boxes.size(); ++i)
+        {
+            if (chunk.boxes[i].intersects(range))
+            {
+                visit(i);
+            }
+        }
+    }
+
+    // Constructor with segments - chunks share the segments' resource
+    Contour::Contour(SegmentContainer segments) : Contour(segments.get_allocator().resource())
+    {
+        // Connectivity is not enforced here, only summarized for isValid()
+        reserve(segments.size());
+        for (auto& segment : segments)
+        {
+            addSegment(std::move(segment));
+        }
+    }
+
+    // Allocator-aware constructors
+    Contour::Contour(std::pmr::memory_resource* resource) : m_resource(resourceOrDefault(resource))
+    {
+    }
+
+    Contour::Contour(const Contour& other, std::pmr::memory_resource* resource) : Contour(resource)
+    {
+        reserve(other.size());
+        for (const auto& segment : other)
+        {
+            addSegment(cloneSegment(*segment, m_resource));
+        }
+    }
+
+    std::pair<Contour::size_type, Contour::size_type> Contour::sharedEnds(const Contour& other) const
+    {
+        if (!m_table || !other.m_table)
+        {
+            return { 0, 0 };
+        }
+        if (m_table == other.m_table)
+        {
+            return { size(), 0 };
+        }
+
+        const auto& mine = m_table->chunks;
+        const auto& theirs = other.m_table->chunks;
+        const size_type common = std::min(mine.size(), theirs.size());
+        size_type first = 0;
+        size_type prefix = 0;
+        while (first < common && mine[first] == theirs[first])
+        {
+            prefix += mine[first]->segments.size();
+            ++first;
+        }
+        size_type last = 0;
+        size_type suffix = 0;
+        while (first + last < common && mine[mine.size() - 1 - last] == theirs[theirs.size() - 1 - last])
+        {
+            suffix += mine[mine.size() - 1 - last]->segments.size();
+            ++last;
+        }
+        return { prefix, suffix };
+    }
+
     // Segment management
-    void Contour::addSegment(std::unique_ptr<Segment> segment)
+    void Contour::reserve(size_type capacity)
+    {
+        const size_type chunkCount = (capacity + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        Table& table = mutableTable();
+        table.chunks.reserve(chunkCount);
+        table.segmentEnds.reserve(chunkCount);
+        table.lengthEnds.reserve(chunkCount);
+        table.chunkGaps.reserve(chunkCount);
+        table.chunkBoxes.reserve(chunkCount);
+        table.boundaryGaps.reserve(chunkCount > 0 ? chunkCount - 1 : 0);
+    }
+
+    void Contour::addSegment(SegmentPtr segment)
     {
         if (!segment)
         {
             throw std::invalid_argument("Contour::addSegment: segment cannot be null");
         }
-        m_segments.push_back(std::move(segment));
-        invalidateCache();
+
+        // Appends update the summaries in place instead of refreshing them
+        Table& table = mutableTable();
+        if (table.chunks.empty() || table.chunks.back()->segments.size() >= CHUNK_SIZE)
+        {
+            const size_type count = table.segmentEnds.empty() ? 0 : table.segmentEnds.back();
+            const double length = table.lengthEnds.empty() ? 0.0 : table.lengthEnds.back();
+            if (!table.chunks.empty())
+            {
+                const Chunk& last = *table.chunks.back();
+                const double gap = jointGap(*last.segments.back(), *segment);
+                table.boundaryGaps.push_back(gap);
+                table.maxGap = std::max(table.maxGap, gap);
+                if (isBrokenGap(gap))
+                {
+                    table.brokenJoints.push_back(count - 1);
+                }
+                table.uniform = table.uniform && last.segments.size() == CHUNK_SIZE;
+
+                // The previous chunk is final now; index the finished chunks
+                // again once they outgrow the tree by an eighth
+                const size_type finished = table.chunks.size();
+                const size_type indexed = table.chunkTree.size();
+                if (finished - indexed > 1 + indexed / 8)
+                {
+                    table.chunkTree.build(table.chunkBoxes.data(), finished);
+                }
+            }
+            table.chunks.push_back(makeChunk());
+            table.segmentEnds.push_back(count);
+            table.lengthEnds.push_back(length);
+            table.chunkGaps.push_back(0.0);
+            table.chunkBoxes.emplace_back();
+        }
+
+        const size_type chunkIndex = table.chunks.size() - 1;
+        Chunk& chunk = mutableChunk(chunkIndex);
+        if (!chunk.segments.empty())
+        {
+            const double gap = jointGap(*chunk.segments.back(), *segment);
+            chunk.jointGaps.push_back(gap);
+            chunk.maxGap = std::max(chunk.maxGap, gap);
+            table.chunkGaps.back() = chunk.maxGap;
+            table.maxGap = std::max(table.maxGap, gap);
+            if (isBrokenGap(gap))
+            {
+                chunk.brokenJoints.push_back(chunk.segments.size() - 1);
+                table.brokenJoints.push_back(table.segmentEnds.back() - 1);
+            }
+        }
+
+        const geometry::BoundingBox box = segment->getBoundingBox();
+        chunk.bounds.expand(box);
+        chunk.boxes.push_back(box);
+        table.bounds.expand(box);
+        table.chunkBoxes.back() = chunk.bounds;
+
+        const double chunkLength = (chunk.cumulativeLengths.empty() ? 0.0 : chunk.cumulativeLengths.back()) +
+                                   segment->getLength();
+        chunk.cumulativeLengths.push_back(chunkLength);
+        chunk.segments.push_back(std::move(segment));
+        if (chunk.segments.size() == CHUNK_SIZE)
+        {
+            chunk.tree.build(chunk.boxes.data(), chunk.boxes.size());
+        }
+
+        table.segmentEnds.back() += 1;
+        table.lengthEnds.back() = (chunkIndex > 0 ? table.lengthEnds[chunkIndex - 1] : 0.0) + chunkLength;
     }
 
-    void Contour::insertSegment(size_type index, std::unique_ptr<Segment> segment)
+    void Contour::insertSegment(size_type index, SegmentPtr segment)
     {
         if (!segment)
         {
             throw std::invalid_argument("Contour::insertSegment: segment cannot be null");
         }
-        if (index > m_segments.size())
+        if (index > size())
         {
             throw std::out_of_range("Contour::insertSegment: index out of range");
         }
-        m_segments.insert(m_segments.begin() + index, std::move(segment));
-        invalidateCache();
+        if (index == size())
+        {
+            addSegment(std::move(segment));
+            return;
+        }
+
+        const auto position = locate(index);
+        Chunk& chunk = mutableChunk(position.first);
+        chunk.segments.insert(chunk.segments.begin() + position.second, std::move(segment));
+
+        // Split an overgrown chunk in half so later edits stay O(chunk)
+        size_type added = 1;
+        if (chunk.segments.size() >= 2 * CHUNK_SIZE)
+        {
+            auto tail = makeChunk();
+            auto middle = chunk.segments.begin() + CHUNK_SIZE;
+            tail->segments.insert(tail->segments.end(),
+                                  std::make_move_iterator(middle), std::make_move_iterator(chunk.segments.end()));
+            chunk.segments.erase(middle, chunk.segments.end());
+            refreshChunk(*tail);
+            m_table->chunks.insert(m_table->chunks.begin() + position.first + 1, std::move(tail));
+            added = 2;
+        }
+
+        refreshChunk(chunk);
+        refreshTable(position.first, 1, added);
     }
 
     void Contour::removeSegment(size_type index)
     {
-        if (index >= m_segments.size())
+        if (index >= size())
         {
             throw std::out_of_range("Contour::removeSegment: index out of range");
         }
-        m_segments.erase(m_segments.begin() + index);
-        invalidateCache();
+
+        const auto position = locate(index);
+        Chunk& chunk = mutableChunk(position.first);
+        chunk.segments.erase(chunk.segments.begin() + position.second);
+
+        auto& chunks = m_table->chunks;
+        size_type removed = 1;
+        size_type added = 1;
+        if (chunk.segments.empty())
+        {
+            chunks.erase(chunks.begin() + position.first);
+            added = 0;
+        }
+        else
+        {
+            // Fold a small chunk into its successor when they fit in one
+            const size_type next = position.first + 1;
+            if (chunk.segments.size() < CHUNK_SIZE / 4 && next < chunks.size() &&
+                chunk.segments.size() + chunks[next]->segments.size() <= CHUNK_SIZE)
+            {
+                Chunk& following = mutableChunk(next);
+                chunk.segments.insert(chunk.segments.end(),
+                                      std::make_move_iterator(following.segments.begin()),
+                                      std::make_move_iterator(following.segments.end()));
+                chunks.erase(chunks.begin() + next);
+                removed = 2;
+            }
+            refreshChunk(chunk);
+        }
+
+        if (chunks.empty())
+        {
+            m_table.reset();
+            return;
+        }
+        refreshTable(position.first, removed, added);
     }
 
-    void Contour::replaceSegment(size_type index, std::unique_ptr<Segment> segment)
+    void Contour::replaceSegment(size_type index, SegmentPtr segment)
     {
         if (!segment)
         {
             throw std::invalid_argument("Contour::replaceSegment: segment cannot be null");
         }
-        if (index >= m_segments.size())
+        if (index >= size())
         {
             throw std::out_of_range("Contour::replaceSegment: index out of range");
         }
-        m_segments[index] = std::move(segment);
-        invalidateCache();
+        editableSegment(index) = std::move(segment);
+        segmentChanged(index);
     }
 
     void Contour::clear()
     {
-        m_segments.clear();
-        invalidateCache();
+        // Snapshots keep their own reference to the chunks
+        m_table.reset();
     }
 
     // Access methods
-    Segment& Contour::operator[](size_type index)
+    Contour::size_type Contour::size() const
     {
-        if (index >= m_segments.size()) {
-            throw std::out_of_range("Contour::operator[]: index out of range");
-        }
-        if (!m_segments[index]) {
-            throw std::runtime_error("Contour::operator[]: null segment at index " + std::to_string(index));
-        }
-        invalidateCache(); // Non-const access might modify the segment
-        return *m_segments[index];
+        return (m_table && !m_table->segmentEnds.empty()) ? m_table->segmentEnds.back() : 0;
     }
 
     const Segment& Contour::operator[](size_type index) const
     {
-        if (index >= m_segments.size()) {
+        if (index >= size()) {
             throw std::out_of_range("Contour::operator[]: index out of range");
         }
-        if (!m_segments[index]) {
+        const auto position = locate(index);
+        const auto& segment = m_table->chunks[position.first]->segments[position.second];
+        if (!segment) {
             throw std::runtime_error("Contour::operator[]: null segment at index " + std::to_string(index));
         }
-        return *m_segments[index];
+        return *segment;
     }
 
-    Segment& Contour::at(size_type index)
+    const Segment& Contour::at(size_type index) const
     {
-        if (index >= m_segments.size())
+        if (index >= size())
         {
             throw std::out_of_range("Contour::at: index out of range");
         }
-        if (!m_segments[index]) {
+        const auto position = locate(index);
+        const auto& segment = m_table->chunks[position.first]->segments[position.second];
+        if (!segment) {
             throw std::runtime_error("Contour::at: null segment at index " + std::to_string(index));
         }
-        invalidateCache(); // Non-const access might modify the segment
-        return *m_segments[index];
+        return *segment;
     }
 
-    const Segment& Contour::at(size_type index) const
+    Contour::const_iterator Contour::begin() const
+    {
+        return const_iterator(m_table.get(), 0);
+    }
+
+    Contour::const_iterator Contour::end() const
     {
-        if (index >= m_segments.size())
+        return const_iterator(m_table.get(), m_table ? m_table->chunks.size() : 0);
+    }
+
+    Contour::SegmentEdit Contour::edit(size_type index)
+    {
+        if (index >= size())
         {
-            throw std::out_of_range("Contour::at: index out of range");
+            throw std::out_of_range("Contour::edit: index out of range");
         }
-        if (!m_segments[index]) {
-            throw std::runtime_error("Contour::at: null segment at index " + std::to_string(index));
+
+        // Detach the chunk now so the handle never writes into a snapshot
+        editableSegment(index);
+        return SegmentEdit(*this, index);
+    }
+
+    // SegmentEdit implementation
+    Contour::SegmentEdit::SegmentEdit(SegmentEdit&& other) noexcept
+        : m_contour(other.m_contour), m_index(other.m_index)
+    {
+        other.m_contour = nullptr;
+    }
+
+    Contour::SegmentEdit::~SegmentEdit()
+    {
+        if (m_contour)
+        {
+            m_contour->segmentChanged(m_index);
+        }
+    }
+
+    void Contour::SegmentEdit::replace(SegmentPtr segment)
+    {
+        if (!segment)
+        {
+            throw std::invalid_argument("Contour::SegmentEdit::replace: segment cannot be null");
+        }
+        openContour().editableSegment(m_index) = std::move(segment);
+    }
+
+    Contour& Contour::SegmentEdit::openContour() const
+    {
+        if (!m_contour)
+        {
+            throw std::logic_error("Contour::SegmentEdit: the edit has already been committed");
+        }
+        return *m_contour;
+    }
+
+    void Contour::SegmentEdit::commit()
+    {
+        if (m_contour)
+        {
+            m_contour->segmentChanged(m_index);
+            m_contour = nullptr;
         }
-        return *m_segments[index];
     }
 
-    // Validation with caching
+    // Validation
     bool Contour::isValid(double epsilon) const
     {
-        // Check if cache is valid for this epsilon
-        if (m_validityCache.has_value() && geometry::isEqual(m_lastEpsilon, epsilon))
+        // Empty contour is considered invalid
+        if (empty())
         {
-            return m_validityCache.value();
+            return false;
         }
 
-        // Calculate validity and cache result
-        bool isValid = calculateValidity(epsilon);
-        m_validityCache = isValid;
-        m_lastEpsilon = epsilon;
-        
-        return isValid;
+        // Single segment is always valid
+        if (size() == 1)
+        {
+            return true;
+        }
+
+        if (std::isnan(epsilon) || epsilon < 0)
+        {
+            return false;
+        }
+
+        // Every joint is connected iff the widest one is
+        return getMaxJointGap() < epsilon;
+    }
+
+    std::vector<Contour::Crossing> Contour::findSelfIntersections() const
+    {
+        return sweep::findCrossings(*this);
+    }
+
+    bool Contour::isSimple() const
+    {
+        return sweep::findCrossings(*this, true).empty();
+    }
+
+    double Contour::getMaxJointGap() const
+    {
+        return m_table ? m_table->maxGap : 0.0;
+    }
+
+    const std::vector<Contour::size_type>& Contour::getDisconnectedJoints() const
+    {
+        return m_table ? m_table->brokenJoints : NO_JOINTS;
     }
 
     // Utility methods
     double Contour::getTotalLength() const
     {
-        double totalLength = 0.0;
-        for (const auto& segment : m_segments)
+        return (m_table && !m_table->lengthEnds.empty()) ? m_table->lengthEnds.back() : 0.0;
+    }
+
+    geometry::BoundingBox Contour::getBoundingBox() const
+    {
+        return m_table ? m_table->bounds : geometry::BoundingBox();
+    }
+
+    std::vector<Contour::size_type> Contour::segmentsInBox(const geometry::BoundingBox& range) const
+    {
+        std::vector<size_type> indices;
+        visitChunks(range, [&](size_type c) {
+            const size_type first = chunkStart(c);
+            visitSegments(*m_table->chunks[c], range, [&](size_type i) { indices.push_back(first + i); });
+        });
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+
+    Contour::size_type Contour::nearestSegment(const geometry::Point2D& point) const
+    {
+        if (empty())
+        {
+            throw std::out_of_range("Contour::nearestSegment: contour is empty");
+        }
+
+        const Table& table = *m_table;
+        double best = std::numeric_limits<double>::infinity();
+        size_type nearest = 0;
+
+        // Exact distance to a chunk: the best segment in it that beats the
+        // current best, or infinity when none does
+        auto chunkDistance = [&](size_type c) {
+            const Chunk& chunk = *table.chunks[c];
+            auto segmentDistance = [&](size_type i) { return chunk.segments[i]->distanceTo(point); };
+            double chunkBest = best;
+            size_type local = chunk.segments.size();
+            chunk.tree.nearest(point, segmentDistance, chunkBest, local);
+            for (size_type i = chunk.tree.size(); i < chunk.segments.size(); ++i)
+            {
+                if (spatial::distanceToBox(chunk.boxes[i], point) < chunkBest)
+                {
+                    const double d = segmentDistance(i);
+                    if (d < chunkBest)
+                    {
+                        chunkBest = d;
+                        local = i;
+                    }
+                }
+            }
+            if (local == chunk.segments.size())
+            {
+                return std::numeric_limits<double>::infinity();
+            }
+            nearest = chunkStart(c) + local;
+            return chunkBest;
+        };
+
+        size_type nearestChunk = table.chunks.size();
+        table.chunkTree.nearest(point, chunkDistance, best, nearestChunk);
+        for (size_type c = table.chunkTree.size(); c < table.chunks.size(); ++c)
         {
-            totalLength += segment->getLength();
+            if (spatial::distanceToBox(table.chunkBoxes[c], point) < best)
+            {
+                best = std::min(best, chunkDistance(c));
+            }
         }
-        return totalLength;
+
+        return nearest;
+    }
+
+    std::vector<std::pair<Contour::size_type, Contour::size_type>> Contour::overlappingSegments() const
+    {
+        std::vector<std::pair<size_type, size_type>> pairs;
+        if (!m_table)
+        {
+            return pairs;
+        }
+
+        // Chunk pairs first, then each segment of one chunk against the other's tree
+        const Table& table = *m_table;
+        for (size_type c = 0; c < table.chunks.size(); ++c)
+        {
+            const Chunk& chunk = *table.chunks[c];
+            const size_type first = chunkStart(c);
+            visitChunks(table.chunkBoxes[c], [&](size_type d) {
+                if (d < c)
+                {
+                    return;
+                }
+                const Chunk& other = *table.chunks[d];
+                const size_type otherFirst = chunkStart(d);
+                for (size_type i = 0; i < chunk.boxes.size(); ++i)
+                {
+                    if (!chunk.boxes[i].intersects(table.chunkBoxes[d]))
+                    {
+                        continue;
+                    }
+                    visitSegments(other, chunk.boxes[i], [&](size_type j) {
+                        if (d != c || j > i)
+                        {
+                            pairs.emplace_back(first + i, otherFirst + j);
+                        }
+                    });
+                }
+            });
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    std::vector<std::pair<Contour::size_type, Contour::size_type>> Contour::overlappingSegments(const Contour& other) const
+    {
+        std::vector<std::pair<size_type, size_type>> pairs;
+        if (!m_table || !other.m_table)
+        {
+            return pairs;
+        }
+
+        const Table& table = *m_table;
+        const Table& otherTable = *other.m_table;
+        for (size_type c = 0; c < table.chunks.size(); ++c)
+        {
+            const Chunk& chunk = *table.chunks[c];
+            const size_type first = chunkStart(c);
+            other.visitChunks(table.chunkBoxes[c], [&](size_type d) {
+                const Chunk& otherChunk = *otherTable.chunks[d];
+                const size_type otherFirst = other.chunkStart(d);
+                for (size_type i = 0; i < chunk.boxes.size(); ++i)
+                {
+                    if (!chunk.boxes[i].intersects(otherTable.chunkBoxes[d]))
+                    {
+                        continue;
+                    }
+                    other.visitSegments(otherChunk, chunk.boxes[i], [&](size_type j) {
+                        pairs.emplace_back(first + i, otherFirst + j);
+                    });
+                }
+            });
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    Contour::size_type Contour::segmentIndexAtDistance(double distance) const
+    {
+        double t = 0.0;
+        size_type index = 0;
+        locateDistance(distance, t, &index, "Contour::segmentIndexAtDistance");
+        return index;
+    }
+
+    geometry::Point2D Contour::pointAtDistance(double distance) const
+    {
+        double t = 0.0;
+        return locateDistance(distance, t, nullptr, "Contour::pointAtDistance").getPointAt(t);
+    }
+
+    geometry::Vector2D Contour::tangentAtDistance(double distance) const
+    {
+        double t = 0.0;
+        return locateDistance(distance, t, nullptr, "Contour::tangentAtDistance").getTangentAt(t);
     }
 
     std::vector<geometry::Point2D> Contour::getVertices() const
     {
         std::vector<geometry::Point2D> vertices;
-        if (m_segments.empty())
+        if (empty())
         {
             return vertices;
         }
 
+        vertices.reserve(size() + 1);
+
         // Add start point of first segment
-        vertices.push_back(m_segments[0]->getStartPoint());
+        vertices.push_back((*this)[0].getStartPoint());
 
         // Add end points of all segments
-        for (const auto& segment : m_segments)
+        for (const auto& segment : *this)
         {
             vertices.push_back(segment->getEndPoint());
         }
@@ -182,27 +723,33 @@ namespace contour
 
     bool Contour::isClosed(double epsilon) const
     {
-        if (m_segments.empty())
+        if (empty())
         {
             return false;
         }
 
-        const auto& firstStart = m_segments[0]->getStartPoint();
-        const auto& lastEnd = m_segments.back()->getEndPoint();
+        const auto& firstStart = (*this)[0].getStartPoint();
+        const auto& lastEnd = (*this)[size() - 1].getEndPoint();
         
         return firstStart.isEqual(lastEnd, epsilon);
     }
 
     bool Contour::isEqual(const Contour& other, double epsilon) const
     {
-        if (m_segments.size() != other.m_segments.size())
+        if (size() != other.size())
         {
             return false;
         }
 
-        for (size_type i = 0; i < m_segments.size(); ++i)
+        // Shared storage is trivially equal
+        if (m_table == other.m_table)
+        {
+            return true;
+        }
+
+        for (auto lhs = begin(), rhs = other.begin(); lhs != end(); ++lhs, ++rhs)
         {
-            if (!m_segments[i]->isEqual(*other.m_segments[i], epsilon))
+            if (!(*lhs)->isEqual(**rhs, epsilon))
             {
                 return false;
             }
@@ -212,50 +759,368 @@ namespace contour
     }
 
     // Private helper methods
-    void Contour::invalidateCache() const
+    Contour::Table& Contour::mutableTable()
     {
-        m_validityCache.reset();
-        m_lastEpsilon = -1.0;
+        std::pmr::polymorphic_allocator<Table> allocator(m_resource);
+        if (!m_table)
+        {
+            m_table = std::allocate_shared<Table>(allocator, m_resource);
+        }
+        else if (isShared(m_table))
+        {
+            // Copies the chunk pointers, not the chunks
+            m_table = std::allocate_shared<Table>(allocator, *m_table, m_resource);
+        }
+        return *m_table;
     }
 
-    bool Contour::calculateValidity(double epsilon) const
+    Contour::Chunk& Contour::mutableChunk(size_type chunk)
     {
-        // Empty contour is considered invalid
-        if (m_segments.empty())
+        auto& pointer = mutableTable().chunks[chunk];
+        if (isShared(pointer))
         {
-            return false;
+            auto copy = makeChunk();
+            copy->segments.reserve(pointer->segments.size());
+            for (const auto& segment : pointer->segments)
+            {
+                copy->segments.push_back(cloneSegment(*segment, m_resource));
+            }
+            copy->jointGaps.assign(pointer->jointGaps.begin(), pointer->jointGaps.end());
+            copy->cumulativeLengths.assign(pointer->cumulativeLengths.begin(), pointer->cumulativeLengths.end());
+            copy->brokenJoints = pointer->brokenJoints;
+            copy->maxGap = pointer->maxGap;
+            copy->bounds = pointer->bounds;
+            copy->boxes.assign(pointer->boxes.begin(), pointer->boxes.end());
+            copy->tree = pointer->tree;
+            pointer = std::move(copy);
         }
+        return *pointer;
+    }
 
-        // Single segment is always valid
-        if (m_segments.size() == 1)
+    std::shared_ptr<Contour::Chunk> Contour::makeChunk() const
+    {
+        return std::allocate_shared<Chunk>(std::pmr::polymorphic_allocator<Chunk>(m_resource), m_resource);
+    }
+
+    std::pair<Contour::size_type, Contour::size_type> Contour::locate(size_type index) const
+    {
+        // Append-only contours keep full chunks, so the chunk is a division away
+        const Table& table = *m_table;
+        if (table.uniform)
         {
-            return true;
+            return { index / CHUNK_SIZE, index % CHUNK_SIZE };
         }
 
-        // Check that all segments are sequentially connected end-to-begin
-        for (size_type i = 0; i < m_segments.size() - 1; ++i)
+        auto it = std::upper_bound(table.segmentEnds.begin(), table.segmentEnds.end(), index);
+        const size_type chunk = static_cast<size_type>(it - table.segmentEnds.begin());
+        return { chunk, index - (chunk > 0 ? table.segmentEnds[chunk - 1] : 0) };
+    }
+
+    Contour::size_type Contour::chunkStart(size_type chunk) const
+    {
+        return chunk > 0 ? m_table->segmentEnds[chunk - 1] : 0;
+    }
+
+    SegmentPtr& Contour::editableSegment(size_type index)
+    {
+        const auto position = locate(index);
+        return mutableChunk(position.first).segments[position.second];
+    }
+
+    void Contour::segmentChanged(size_type index)
+    {
+        // Only the segment's own summaries and the chunk's table entries are recomputed
+        const auto position = locate(index);
+        refreshSegment(mutableChunk(position.first), position.second);
+        refreshTable(position.first, 1, 1);
+    }
+
+    void Contour::refreshChunk(Chunk& chunk) const
+    {
+        chunk.jointGaps.clear();
+        chunk.cumulativeLengths.clear();
+        chunk.brokenJoints.clear();
+        chunk.maxGap = 0.0;
+        chunk.bounds = geometry::BoundingBox();
+        chunk.boxes.clear();
+
+        double length = 0.0;
+        const size_type count = chunk.segments.size();
+        for (size_type i = 0; i < count; ++i)
         {
-            if (!m_segments[i]->isConnectedTo(*m_segments[i + 1], epsilon))
+            length += chunk.segments[i]->getLength();
+            chunk.cumulativeLengths.push_back(length);
+            chunk.boxes.push_back(chunk.segments[i]->getBoundingBox());
+            chunk.bounds.expand(chunk.boxes.back());
+            if (i + 1 < count)
             {
-                return false;
+                const double gap = jointGap(*chunk.segments[i], *chunk.segments[i + 1]);
+                chunk.jointGaps.push_back(gap);
+                chunk.maxGap = std::max(chunk.maxGap, gap);
+                if (isBrokenGap(gap))
+                {
+                    chunk.brokenJoints.push_back(i);
+                }
             }
         }
+        chunk.tree.build(chunk.boxes.data(), chunk.boxes.size());
+    }
 
-        return true;
+    void Contour::refreshSegment(Chunk& chunk, size_type offset) const
+    {
+        // One segment changed: its box, the joints on either side and the
+        // lengths from it on are all that differ
+        const geometry::BoundingBox oldBox = chunk.boxes[offset];
+        chunk.boxes[offset] = chunk.segments[offset]->getBoundingBox();
+        if (mayShrink(chunk.bounds, oldBox, chunk.boxes[offset]))
+        {
+            chunk.bounds = geometry::BoundingBox();
+            for (const auto& box : chunk.boxes)
+            {
+                chunk.bounds.expand(box);
+            }
+        }
+        else
+        {
+            chunk.bounds.expand(chunk.boxes[offset]);
+        }
+        if (offset < chunk.tree.size())
+        {
+            chunk.tree.refit(offset, chunk.boxes.data());
+        }
+
+        const size_type count = chunk.segments.size();
+        double length = offset > 0 ? chunk.cumulativeLengths[offset - 1] : 0.0;
+        for (size_type i = offset; i < count; ++i)
+        {
+            length += chunk.segments[i]->getLength();
+            chunk.cumulativeLengths[i] = length;
+        }
+
+        double removedGap = 0.0;
+        double addedGap = 0.0;
+        for (size_type joint = offset > 0 ? offset - 1 : 0; joint <= offset && joint + 1 < count; ++joint)
+        {
+            removedGap = std::max(removedGap, chunk.jointGaps[joint]);
+            const double gap = jointGap(*chunk.segments[joint], *chunk.segments[joint + 1]);
+            chunk.jointGaps[joint] = gap;
+            addedGap = std::max(addedGap, gap);
+
+            auto it = std::lower_bound(chunk.brokenJoints.begin(), chunk.brokenJoints.end(), joint);
+            const bool listed = it != chunk.brokenJoints.end() && *it == joint;
+            if (isBrokenGap(gap) && !listed)
+            {
+                chunk.brokenJoints.insert(it, joint);
+            }
+            else if (!isBrokenGap(gap) && listed)
+            {
+                chunk.brokenJoints.erase(it);
+            }
+        }
+        if (removedGap < chunk.maxGap || addedGap >= chunk.maxGap)
+        {
+            chunk.maxGap = std::max(chunk.maxGap, addedGap);
+        }
+        else
+        {
+            chunk.maxGap = 0.0;
+            for (double gap : chunk.jointGaps)
+            {
+                chunk.maxGap = std::max(chunk.maxGap, gap);
+            }
+        }
     }
 
-    void Contour::deepCopyFrom(const Contour& other)
+    void Contour::refreshTable(size_type first, size_type removed, size_type added)
     {
-        m_segments.clear();
-        m_segments.reserve(other.m_segments.size());
-        
-        for (const auto& segment : other.m_segments)
+        // Chunks [first, first + removed) of the summaries were replaced by
+        // chunks [first, first + added) of the list. Only their entries and the
+        // joints around them are recomputed; the prefix sums after them shift.
+        Table& table = *m_table;
+        const size_type oldChunkCount = table.segmentEnds.size();
+        const size_type chunkCount = table.chunks.size();
+        const size_type oldLast = first + removed;
+        const size_type newLast = first + added;
+        const size_type start = chunkStart(first);
+        const size_type oldEnd = table.segmentEnds[oldLast - 1];
+        const double oldLengthEnd = table.lengthEnds[oldLast - 1];
+
+        // Boundary b lies between chunks b and b + 1
+        const size_type gapFirst = first > 0 ? first - 1 : 0;
+        const size_type oldGapLast = std::min(oldLast, oldChunkCount - 1);
+        const size_type newGapLast = std::min(newLast, chunkCount - 1);
+
+        double removedGap = 0.0;
+        geometry::BoundingBox removedBounds;
+        for (size_type c = first; c < oldLast; ++c)
+        {
+            removedGap = std::max(removedGap, table.chunkGaps[c]);
+            removedBounds.expand(table.chunkBoxes[c]);
+        }
+        for (size_type b = gapFirst; b < oldGapLast; ++b)
+        {
+            removedGap = std::max(removedGap, table.boundaryGaps[b]);
+        }
+
+        spliceRange(table.segmentEnds, first, removed, added);
+        spliceRange(table.lengthEnds, first, removed, added);
+        spliceRange(table.chunkGaps, first, removed, added);
+        spliceRange(table.chunkBoxes, first, removed, added);
+        spliceRange(table.boundaryGaps, gapFirst, oldGapLast - gapFirst, newGapLast - gapFirst);
+
+        size_type count = start;
+        double length = first > 0 ? table.lengthEnds[first - 1] : 0.0;
+        double addedGap = 0.0;
+        geometry::BoundingBox addedBounds;
+        for (size_type c = first; c < newLast; ++c)
+        {
+            const Chunk& chunk = *table.chunks[c];
+            count += chunk.segments.size();
+            length += chunk.cumulativeLengths.back();
+            table.segmentEnds[c] = count;
+            table.lengthEnds[c] = length;
+            table.chunkGaps[c] = chunk.maxGap;
+            table.chunkBoxes[c] = chunk.bounds;
+            addedGap = std::max(addedGap, chunk.maxGap);
+            addedBounds.expand(chunk.bounds);
+        }
+        for (size_type b = gapFirst; b < newGapLast; ++b)
+        {
+            table.boundaryGaps[b] = jointGap(*table.chunks[b]->segments.back(), *table.chunks[b + 1]->segments.front());
+            addedGap = std::max(addedGap, table.boundaryGaps[b]);
+        }
+
+        const size_type newEnd = count;
+        if (newEnd != oldEnd || length != oldLengthEnd)
+        {
+            const double shift = length - oldLengthEnd;
+            for (size_type c = newLast; c < chunkCount; ++c)
+            {
+                table.segmentEnds[c] = table.segmentEnds[c] - oldEnd + newEnd;
+                table.lengthEnds[c] += shift;
+            }
+        }
+
+        // Broken joints from the one before the replaced segments up to their last
+        std::vector<size_type> joints;
+        for (size_type c = first; c < newLast; ++c)
+        {
+            const size_type offset = chunkStart(c);
+            if (c > 0 && isBrokenGap(table.boundaryGaps[c - 1]))
+            {
+                joints.push_back(offset - 1);
+            }
+            for (size_type joint : table.chunks[c]->brokenJoints)
+            {
+                joints.push_back(offset + joint);
+            }
+        }
+        if (newLast > 0 && newLast < chunkCount && isBrokenGap(table.boundaryGaps[newLast - 1]))
+        {
+            joints.push_back(table.segmentEnds[newLast - 1] - 1);
+        }
+        auto& broken = table.brokenJoints;
+        const auto low = std::lower_bound(broken.begin(), broken.end(), start > 0 ? start - 1 : 0);
+        const auto high = std::lower_bound(low, broken.end(), oldEnd);
+        for (auto it = high; it != broken.end(); ++it)
+        {
+            *it = *it - oldEnd + newEnd;
+        }
+        broken.insert(broken.erase(low, high), joints.begin(), joints.end());
+
+        // The maximum and the bounds are scanned again only if what was
+        // removed may have defined them
+        if (removedGap < table.maxGap || addedGap >= table.maxGap)
+        {
+            table.maxGap = std::max(table.maxGap, addedGap);
+        }
+        else
+        {
+            table.maxGap = 0.0;
+            for (double gap : table.chunkGaps)
+            {
+                table.maxGap = std::max(table.maxGap, gap);
+            }
+            for (double gap : table.boundaryGaps)
+            {
+                table.maxGap = std::max(table.maxGap, gap);
+            }
+        }
+        if (mayShrink(table.bounds, removedBounds, addedBounds))
         {
-            m_segments.push_back(segment->clone());
+            table.bounds = geometry::BoundingBox();
+            for (const auto& box : table.chunkBoxes)
+            {
+                table.bounds.expand(box);
+            }
+        }
+        else
+        {
+            table.bounds.expand(addedBounds);
         }
 
-        // Don't copy cache - let it be recalculated when needed
-        invalidateCache();
+        // Insertions and removals can change whether every chunk is full
+        if (newEnd != oldEnd || removed != added)
+        {
+            table.uniform = table.segmentEnds.back() - chunkStart(chunkCount - 1) <= CHUNK_SIZE;
+            for (size_type c = 0; table.uniform && c + 1 < chunkCount; ++c)
+            {
+                table.uniform = table.segmentEnds[c] == (c + 1) * CHUNK_SIZE;
+            }
+        }
+
+        if (removed == added)
+        {
+            // Same chunk indices: refit the tree paths above the changed chunks
+            for (size_type c = first; c < newLast && c < table.chunkTree.size(); ++c)
+            {
+                table.chunkTree.refit(c, table.chunkBoxes.data());
+            }
+        }
+        else
+        {
+            // Chunk indices moved, so the tree is loaded again; the last chunk
+            // may still grow by appends, so it stays out of the tree
+            table.chunkTree.build(table.chunkBoxes.data(), chunkCount - 1);
+        }
+    }
+
+    const Segment& Contour::locateDistance(double distance, double& t, size_type* index, const char* caller) const
+    {
+        if (empty() || std::isnan(distance) || distance < 0.0 || distance > getTotalLength())
+        {
+            throw std::out_of_range(std::string(caller) + ": distance out of range");
+        }
+
+        // Chunk whose cumulative length reaches the distance, then the segment inside it
+        const Table& table = *m_table;
+        auto chunkIt = std::lower_bound(table.lengthEnds.begin(), table.lengthEnds.end(), distance);
+        const size_type chunkIndex = static_cast<size_type>(chunkIt - table.lengthEnds.begin());
+        const Chunk& chunk = *table.chunks[chunkIndex];
+
+        const double local = distance - (chunkIndex > 0 ? table.lengthEnds[chunkIndex - 1] : 0.0);
+        auto segmentIt = std::lower_bound(chunk.cumulativeLengths.begin(), chunk.cumulativeLengths.end(), local);
+        size_type offset = static_cast<size_type>(segmentIt - chunk.cumulativeLengths.begin());
+        offset = std::min(offset, chunk.segments.size() - 1);
+
+        const double segmentStart = offset > 0 ? chunk.cumulativeLengths[offset - 1] : 0.0;
+        const double segmentLength = chunk.cumulativeLengths[offset] - segmentStart;
+        t = segmentLength > 0.0 ? std::clamp((local - segmentStart) / segmentLength, 0.0, 1.0) : 0.0;
+
+        if (index)
+        {
+            *index = (chunkIndex > 0 ? table.segmentEnds[chunkIndex - 1] : 0) + offset;
+        }
+        return *chunk.segments[offset];
+    }
+
+    double Contour::jointGap(const Segment& first, const Segment& second)
+    {
+        // Same metric as Point2D::isEqual, so gap < epsilon matches isConnectedTo
+        const auto end = first.getEndPoint();
+        const auto start = second.getStartPoint();
+        const double gap = std::max(std::abs(end.x - start.x), std::abs(end.y - start.y));
+        return std::isnan(gap) ? std::numeric_limits<double>::infinity() : gap;
     }
 
     // Global operators
@@ -272,14 +1137,14 @@ namespace contour
     // ContourBuilder implementation
     ContourBuilder& ContourBuilder::addLine(const geometry::Point2D& start, const geometry::Point2D& end)
     {
-        m_contour.addSegment(createLineSegment(start, end));
+        m_contour.addSegment(createLineSegment(start, end, m_contour.getResource()));
         return *this;
     }
 
     ContourBuilder& ContourBuilder::addArc(const geometry::Point2D& center, double radius, 
                                           double startAngle, double endAngle, bool clockwise)
     {
-        m_contour.addSegment(createArcSegment(center, radius, startAngle, endAngle, clockwise));
+        m_contour.addSegment(createArcSegment(center, radius, startAngle, endAngle, clockwise, m_contour.getResource()));
         return *this;
     }
 } 
\ No newline at end of file
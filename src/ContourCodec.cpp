@@ -0,0 +1,400 @@
+#include "../include/ContourIO.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace contour
+{
+    namespace io
+    {
+        namespace
+        {
+            // Added to the SegmentTag of a run whose segments do not start where
+            // the previous segment ended, and so store their own start
+            constexpr unsigned char DETACHED = 4;
+
+            // Quantized values stay exact in a double and their deltas in an int64
+            constexpr double MAX_QUANTUM = 9007199254740992.0;
+
+            // Longest varint: 64 bits in groups of 7
+            constexpr std::size_t MAX_VARINT_BYTES = 10;
+
+            std::uint64_t zigZag(std::int64_t value)
+            {
+                return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+            }
+
+            std::int64_t unZigZag(std::uint64_t value)
+            {
+                return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+            }
+
+            // Wraps instead of overflowing, so a corrupt payload decodes to
+            // garbage rather than undefined behaviour
+            std::int64_t offsetBy(std::int64_t base, std::uint64_t encodedDelta)
+            {
+                return static_cast<std::int64_t>(static_cast<std::uint64_t>(base)
+                                                 + static_cast<std::uint64_t>(unZigZag(encodedDelta)));
+            }
+
+            double sweepBetween(double startAngle, double endAngle)
+            {
+                const double sweep = std::fmod(endAngle - startAngle, 2.0 * geometry::PI);
+                return sweep < 0.0 ? sweep + 2.0 * geometry::PI : sweep;
+            }
+
+            std::int64_t quantize(double value, double resolution)
+            {
+                const double steps = std::round(value / resolution);
+                if (!(std::fabs(steps) <= MAX_QUANTUM))
+                {
+                    throw std::invalid_argument("DeltaEncoder: coordinate out of range at this resolution");
+                }
+                return static_cast<std::int64_t>(steps);
+            }
+
+            // Small fixed buffer for the varints of one segment
+            struct SegmentBytes
+            {
+                unsigned char bytes[ARC_DOUBLES * MAX_VARINT_BYTES];
+                std::size_t used = 0;
+
+                void put(std::uint64_t value)
+                {
+                    while (value >= 0x80)
+                    {
+                        bytes[used++] = static_cast<unsigned char>(value | 0x80);
+                        value >>= 7;
+                    }
+                    bytes[used++] = static_cast<unsigned char>(value);
+                }
+            };
+
+            void putVarint(std::vector<unsigned char>& bytes, std::uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    bytes.push_back(static_cast<unsigned char>(value | 0x80));
+                    value >>= 7;
+                }
+                bytes.push_back(static_cast<unsigned char>(value));
+            }
+        }
+
+        // DeltaEncoder implementation
+        DeltaEncoder::DeltaEncoder(double resolution)
+            : m_resolution(resolution)
+            , m_bytes(sizeof(double))
+        {
+            if (!(resolution > 0.0) || !std::isfinite(resolution))
+            {
+                throw std::invalid_argument("DeltaEncoder: resolution must be positive and finite");
+            }
+            detail::storeDouble(m_bytes.data(), m_resolution);
+        }
+
+        void DeltaEncoder::add(SegmentTag tag, const double* values)
+        {
+            // Everything is worked out before any state changes, so a rejected
+            // segment leaves the encoder as it was
+            SegmentBytes encoded;
+            unsigned char runTag = static_cast<unsigned char>(tag);
+            std::int64_t cursorX;
+            std::int64_t cursorY;
+            geometry::Point2D originalEnd;
+            geometry::Point2D decodedEnd;
+
+            if (tag == SegmentTag::Line)
+            {
+                const geometry::Point2D start(values[0], values[1]);
+                originalEnd = geometry::Point2D(values[2], values[3]);
+
+                // A shared vertex is stored once: the line starts from the
+                // decoded end of the previous segment
+                std::int64_t startX = m_cursorX;
+                std::int64_t startY = m_cursorY;
+                geometry::Point2D decodedStart = m_decodedEnd;
+                if (!m_hasPrevious || !start.isEqual(m_previousEnd))
+                {
+                    runTag |= DETACHED;
+                    startX = quantize(start.x, m_resolution);
+                    startY = quantize(start.y, m_resolution);
+                    decodedStart = geometry::Point2D(startX * m_resolution, startY * m_resolution);
+                    encoded.put(zigZag(startX - m_cursorX));
+                    encoded.put(zigZag(startY - m_cursorY));
+                }
+
+                cursorX = quantize(originalEnd.x, m_resolution);
+                cursorY = quantize(originalEnd.y, m_resolution);
+                decodedEnd = geometry::Point2D(cursorX * m_resolution, cursorY * m_resolution);
+                if (decodedStart.isEqual(decodedEnd))
+                {
+                    throw std::invalid_argument("DeltaEncoder: line collapses at this resolution");
+                }
+                encoded.put(zigZag(cursorX - startX));
+                encoded.put(zigZag(cursorY - startY));
+            }
+            else
+            {
+                const bool clockwise = tag == SegmentTag::ArcClockwise;
+                const ArcSegment original(geometry::Point2D(values[0], values[1]), values[2], values[3], values[4], clockwise);
+                originalEnd = original.getEndPoint();
+
+                cursorX = quantize(values[0], m_resolution);
+                cursorY = quantize(values[1], m_resolution);
+                const geometry::Point2D center(cursorX * m_resolution, cursorY * m_resolution);
+                encoded.put(zigZag(cursorX - m_cursorX));
+                encoded.put(zigZag(cursorY - m_cursorY));
+
+                // An arc that continues the contour takes its radius and start
+                // angle from the decoded end of the previous segment, which also
+                // keeps the joint closed; any other arc stores both. Angles are
+                // counted in steps that move the arc end by one resolution step.
+                double radius;
+                double startAngle;
+                if (m_hasPrevious && original.getStartPoint().isEqual(m_previousEnd))
+                {
+                    radius = m_decodedEnd.distanceTo(center);
+                    startAngle = std::atan2(m_decodedEnd.y - center.y, m_decodedEnd.x - center.x);
+                }
+                else
+                {
+                    runTag |= DETACHED;
+                    const std::int64_t radiusSteps = quantize(values[2], m_resolution);
+                    if (radiusSteps == 0)
+                    {
+                        throw std::invalid_argument("DeltaEncoder: arc collapses at this resolution");
+                    }
+                    radius = radiusSteps * m_resolution;
+                    const std::int64_t startSteps = std::llround(original.getStartAngle() * radius / m_resolution);
+                    startAngle = startSteps * m_resolution / radius;
+                    encoded.put(static_cast<std::uint64_t>(radiusSteps));
+                    encoded.put(zigZag(startSteps)); // start angles are often negative
+                }
+                const std::int64_t sweepSteps = std::llround(sweepBetween(startAngle, original.getEndAngle()) * radius / m_resolution);
+                encoded.put(static_cast<std::uint64_t>(sweepSteps));
+
+                try
+                {
+                    const ArcSegment decoded(center, radius, startAngle, startAngle + sweepSteps * m_resolution / radius, clockwise);
+                    decodedEnd = decoded.getEndPoint();
+                }
+                catch (const std::invalid_argument&)
+                {
+                    throw std::invalid_argument("DeltaEncoder: arc collapses at this resolution");
+                }
+            }
+
+            if (m_runLength > 0 && runTag != m_runTag)
+            {
+                flushRun();
+            }
+            m_runTag = runTag;
+            m_run.insert(m_run.end(), encoded.bytes, encoded.bytes + encoded.used);
+            ++m_runLength;
+            ++m_count;
+            m_cursorX = cursorX;
+            m_cursorY = cursorY;
+            m_previousEnd = originalEnd;
+            m_decodedEnd = decodedEnd;
+            m_hasPrevious = true;
+        }
+
+        void DeltaEncoder::flushRun()
+        {
+            putVarint(m_bytes, m_runTag);
+            putVarint(m_bytes, m_runLength);
+            m_bytes.insert(m_bytes.end(), m_run.begin(), m_run.end());
+            m_run.clear();
+            m_runLength = 0;
+        }
+
+        std::vector<unsigned char> DeltaEncoder::finish(bool continued)
+        {
+            if (m_runLength > 0)
+            {
+                flushRun();
+            }
+            m_bytes.resize((m_bytes.size() + 7) / 8 * 8, 0);
+
+            std::vector<unsigned char> payload;
+            payload.swap(m_bytes);
+            m_bytes.resize(sizeof(double));
+            detail::storeDouble(m_bytes.data(), m_resolution);
+            m_count = 0;
+            if (!continued)
+            {
+                m_cursorX = 0;
+                m_cursorY = 0;
+                m_hasPrevious = false;
+            }
+            return payload;
+        }
+
+        // DeltaDecoder implementation
+        void DeltaDecoder::reset(const unsigned char* data, std::size_t size, std::uint64_t segmentCount,
+                                 bool continuesPrevious, const char* caller)
+        {
+            m_caller = caller;
+            if (size < sizeof(double))
+            {
+                fail("compressed payload is truncated");
+            }
+            m_resolution = detail::loadDouble(data);
+            if (!(m_resolution > 0.0) || !std::isfinite(m_resolution))
+            {
+                fail("compressed payload has an invalid resolution");
+            }
+            m_data = data + sizeof(double);
+            m_end = data + size;
+            m_remaining = segmentCount;
+            m_runLeft = 0;
+            if (!continuesPrevious)
+            {
+                m_cursorX = 0;
+                m_cursorY = 0;
+                m_hasPrevious = false;
+                m_previousTag = static_cast<unsigned char>(SegmentTag::Line);
+            }
+        }
+
+        void DeltaDecoder::fail(const char* what) const
+        {
+            throw std::runtime_error(std::string(m_caller) + ": " + what);
+        }
+
+        std::uint64_t DeltaDecoder::readVarint()
+        {
+            std::uint64_t value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                if (m_data == m_end)
+                {
+                    fail("compressed payload is truncated");
+                }
+                const unsigned char byte = *m_data++;
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            fail("compressed payload has a malformed varint");
+        }
+
+        geometry::Point2D DeltaDecoder::previousEnd() const
+        {
+            if (!m_hasPrevious)
+            {
+                fail("compressed payload starts with a connected segment");
+            }
+            if (m_previousTag == static_cast<unsigned char>(SegmentTag::Line))
+            {
+                return geometry::Point2D(m_previous[2], m_previous[3]);
+            }
+            // The exact end of the arc the reader builds, so the joint closes
+            try
+            {
+                return ArcSegment(geometry::Point2D(m_previous[0], m_previous[1]), m_previous[2], m_previous[3], m_previous[4],
+                                  m_previousTag == static_cast<unsigned char>(SegmentTag::ArcClockwise)).getEndPoint();
+            }
+            catch (const std::invalid_argument& e)
+            {
+                fail(e.what());
+            }
+        }
+
+        bool DeltaDecoder::next(unsigned char& tag, double (&values)[ARC_DOUBLES])
+        {
+            if (m_remaining == 0)
+            {
+                return false;
+            }
+            if (m_runLeft == 0)
+            {
+                const std::uint64_t runTag = readVarint();
+                m_runLeft = readVarint();
+                if (runTag > (DETACHED | static_cast<unsigned char>(SegmentTag::ArcClockwise))
+                    || doublesForTag(static_cast<std::uint8_t>(runTag & ~static_cast<std::uint64_t>(DETACHED))) == 0)
+                {
+                    fail("compressed payload has an unknown segment tag");
+                }
+                if (m_runLeft == 0 || m_runLeft > m_remaining)
+                {
+                    fail("compressed payload has a bad run length");
+                }
+                m_runTag = static_cast<unsigned char>(runTag);
+            }
+            --m_runLeft;
+            --m_remaining;
+
+            const bool detached = (m_runTag & DETACHED) != 0;
+            tag = static_cast<unsigned char>(m_runTag & ~DETACHED);
+            if (tag == static_cast<unsigned char>(SegmentTag::Line))
+            {
+                geometry::Point2D start;
+                if (detached)
+                {
+                    m_cursorX = offsetBy(m_cursorX, readVarint());
+                    m_cursorY = offsetBy(m_cursorY, readVarint());
+                    start = geometry::Point2D(m_cursorX * m_resolution, m_cursorY * m_resolution);
+                }
+                else
+                {
+                    start = previousEnd();
+                }
+                m_cursorX = offsetBy(m_cursorX, readVarint());
+                m_cursorY = offsetBy(m_cursorY, readVarint());
+
+                values[0] = start.x;
+                values[1] = start.y;
+                values[2] = m_cursorX * m_resolution;
+                values[3] = m_cursorY * m_resolution;
+            }
+            else
+            {
+                m_cursorX = offsetBy(m_cursorX, readVarint());
+                m_cursorY = offsetBy(m_cursorY, readVarint());
+                const geometry::Point2D center(m_cursorX * m_resolution, m_cursorY * m_resolution);
+
+                // Same arithmetic as the encoder, so the arc is the one it checked
+                double radius;
+                double startAngle;
+                if (detached)
+                {
+                    const std::uint64_t radiusSteps = readVarint();
+                    if (radiusSteps == 0 || radiusSteps > static_cast<std::uint64_t>(MAX_QUANTUM))
+                    {
+                        fail("compressed payload has a bad arc radius");
+                    }
+                    radius = static_cast<std::int64_t>(radiusSteps) * m_resolution;
+                    startAngle = unZigZag(readVarint()) * m_resolution / radius;
+                }
+                else
+                {
+                    const geometry::Point2D start = previousEnd();
+                    radius = start.distanceTo(center);
+                    startAngle = std::atan2(start.y - center.y, start.x - center.x);
+                }
+                const std::int64_t sweepSteps = static_cast<std::int64_t>(readVarint());
+
+                values[0] = center.x;
+                values[1] = center.y;
+                values[2] = radius;
+                values[3] = startAngle;
+                values[4] = startAngle + sweepSteps * m_resolution / radius;
+            }
+            // Corrupt steps can decode to any double; reject them before a
+            // segment, or the next connected one, is built from them
+            if (const char* problem = invalidSegmentValues(tag, values))
+            {
+                fail(problem);
+            }
+            std::copy(values, values + doublesForTag(tag), m_previous);
+            m_previousTag = tag;
+            m_hasPrevious = true;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,635 @@
+#include "../include/ContourIO.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace contour
+{
+    namespace io
+    {
+        namespace
+        {
+            // Tags and payload go through buffers of this size, so a corrupt
+            // segment count cannot make the reader allocate more than it reads
+            constexpr std::size_t BLOCK_BYTES = 64 * 1024;
+
+            void readExactly(std::istream& in, unsigned char* bytes, std::size_t count, const char* caller)
+            {
+                in.read(reinterpret_cast<char*>(bytes), static_cast<std::streamsize>(count));
+                if (static_cast<std::size_t>(in.gcount()) != count)
+                {
+                    throw std::runtime_error(std::string(caller) + ": unexpected end of file");
+                }
+            }
+
+            void writeBytes(std::ostream& out, const unsigned char* bytes, std::size_t count)
+            {
+                out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+                if (!out)
+                {
+                    throw std::runtime_error("writeContour: write failed");
+                }
+            }
+
+            SegmentTag tagOf(const Segment& segment)
+            {
+                if (segment.getType() == SegmentType::Line)
+                {
+                    return SegmentTag::Line;
+                }
+                const auto& arc = static_cast<const ArcSegment&>(segment);
+                return arc.isClockwise() ? SegmentTag::ArcClockwise : SegmentTag::ArcCounterClockwise;
+            }
+
+            // The tag of a segment and the doubles a plain record stores for it
+            SegmentTag valuesOf(const Segment& segment, double (&values)[ARC_DOUBLES])
+            {
+                if (segment.getType() == SegmentType::Line)
+                {
+                    const auto& line = static_cast<const LineSegment&>(segment);
+                    values[0] = line.getStartPoint().x;
+                    values[1] = line.getStartPoint().y;
+                    values[2] = line.getEndPoint().x;
+                    values[3] = line.getEndPoint().y;
+                    return SegmentTag::Line;
+                }
+                const auto& arc = static_cast<const ArcSegment&>(segment);
+                values[0] = arc.getCenter().x;
+                values[1] = arc.getCenter().y;
+                values[2] = arc.getRadius();
+                values[3] = arc.getStartAngle();
+                values[4] = arc.getEndAngle();
+                return tagOf(segment);
+            }
+
+            // Appends a compressed record holding what the encoder has collected
+            void appendCompressedRecord(DeltaEncoder& encoder, bool continued, std::vector<unsigned char>& bytes)
+            {
+                CntHeader header;
+                header.flags = CNT_FLAG_COMPRESSED | (continued ? CNT_FLAG_CONTINUED : 0);
+                header.segmentCount = encoder.size();
+                const std::vector<unsigned char> payload = encoder.finish(continued);
+                header.payloadSize = payload.size();
+
+                unsigned char headerBytes[CNT_HEADER_SIZE];
+                formatHeader(header, headerBytes);
+                bytes.insert(bytes.end(), headerBytes, headerBytes + CNT_HEADER_SIZE);
+                bytes.insert(bytes.end(), payload.begin(), payload.end());
+            }
+        }
+
+        const char* invalidSegmentValues(std::uint8_t tag, const double* values)
+        {
+            const std::size_t doubles = doublesForTag(tag);
+            for (std::size_t k = 0; k < doubles; ++k)
+            {
+                if (!std::isfinite(values[k]))
+                {
+                    return "segment value is not finite";
+                }
+            }
+            if (doubles == ARC_DOUBLES && (std::fabs(values[3]) > CNT_MAX_ANGLE || std::fabs(values[4]) > CNT_MAX_ANGLE))
+            {
+                return "arc angle out of range";
+            }
+            return nullptr;
+        }
+
+        void formatHeader(const CntHeader& header, unsigned char (&bytes)[CNT_HEADER_SIZE])
+        {
+            std::fill(std::begin(bytes), std::end(bytes), static_cast<unsigned char>(0));
+            std::memcpy(bytes, CNT_MAGIC, sizeof CNT_MAGIC);
+            bytes[4] = static_cast<unsigned char>(header.version);
+            bytes[5] = static_cast<unsigned char>(header.version >> 8);
+            bytes[6] = static_cast<unsigned char>(CNT_HEADER_SIZE);
+            bytes[7] = static_cast<unsigned char>(CNT_HEADER_SIZE >> 8);
+            for (int i = 0; i < 4; ++i)
+            {
+                bytes[8 + i] = static_cast<unsigned char>(header.flags >> (8 * i));
+            }
+            detail::storeU64(bytes + 16, header.segmentCount);
+            detail::storeU64(bytes + 24, header.payloadSize);
+        }
+
+        CntHeader parseHeader(const unsigned char (&bytes)[CNT_HEADER_SIZE], const char* caller)
+        {
+            if (std::memcmp(bytes, CNT_MAGIC, sizeof CNT_MAGIC) != 0)
+            {
+                throw std::runtime_error(std::string(caller) + ": not a .cnt contour file");
+            }
+
+            CntHeader header;
+            header.version = static_cast<std::uint16_t>(bytes[4] | (bytes[5] << 8));
+            if (header.version != CNT_VERSION)
+            {
+                throw std::runtime_error(std::string(caller) + ": unsupported .cnt version " + std::to_string(header.version));
+            }
+            const std::size_t headerSize = static_cast<std::size_t>(bytes[6] | (bytes[7] << 8));
+            if (headerSize != CNT_HEADER_SIZE)
+            {
+                throw std::runtime_error(std::string(caller) + ": unexpected .cnt header size");
+            }
+            header.flags = 0;
+            for (int i = 3; i >= 0; --i)
+            {
+                header.flags = (header.flags << 8) | bytes[8 + i];
+            }
+            if ((header.flags & ~CNT_KNOWN_FLAGS) != 0)
+            {
+                throw std::runtime_error(std::string(caller) + ": unsupported .cnt flags");
+            }
+            header.segmentCount = detail::loadU64(bytes + 16);
+            header.payloadSize = detail::loadU64(bytes + 24);
+            return header;
+        }
+
+        void writeContour(std::ostream& out, const Contour& contour)
+        {
+            // First pass: the tag column, which also fixes the payload size
+            std::vector<unsigned char> tags(tagColumnSize(contour.size()), 0);
+            std::uint64_t payloadDoubles = 0;
+            std::size_t index = 0;
+            for (const auto& segment : contour)
+            {
+                tags[index] = static_cast<unsigned char>(tagOf(*segment));
+                payloadDoubles += doublesForTag(tags[index]);
+                ++index;
+            }
+
+            CntHeader header;
+            header.segmentCount = contour.size();
+            header.payloadSize = payloadDoubles * sizeof(double);
+            unsigned char headerBytes[CNT_HEADER_SIZE];
+            formatHeader(header, headerBytes);
+            writeBytes(out, headerBytes, CNT_HEADER_SIZE);
+            writeBytes(out, tags.data(), tags.size());
+
+            // Second pass: the payload, a block at a time
+            std::vector<unsigned char> block(BLOCK_BYTES);
+            std::size_t used = 0;
+            auto put = [&](double value) {
+                if (used == block.size())
+                {
+                    writeBytes(out, block.data(), used);
+                    used = 0;
+                }
+                detail::storeDouble(block.data() + used, value);
+                used += sizeof(double);
+            };
+            double values[ARC_DOUBLES];
+            for (const auto& segment : contour)
+            {
+                const SegmentTag tag = valuesOf(*segment, values);
+                for (std::size_t k = 0; k < doublesForTag(static_cast<std::uint8_t>(tag)); ++k)
+                {
+                    put(values[k]);
+                }
+            }
+            writeBytes(out, block.data(), used);
+        }
+
+        void writeContour(const std::string& path, const Contour& contour)
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                throw std::runtime_error("writeContour: cannot open " + path);
+            }
+            writeContour(out, contour);
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("writeContour: write failed for " + path);
+            }
+        }
+
+        void writeCompressedContour(std::ostream& out, const Contour& contour, double resolution)
+        {
+            // Encoded in memory first, which is small, so a rejected segment
+            // leaves the stream untouched
+            DeltaEncoder encoder(resolution);
+            std::vector<unsigned char> bytes;
+            double values[ARC_DOUBLES];
+            for (const auto& segment : contour)
+            {
+                if (encoder.size() == ContourWriter::DEFAULT_BLOCK_SEGMENTS)
+                {
+                    appendCompressedRecord(encoder, true, bytes);
+                }
+                const SegmentTag tag = valuesOf(*segment, values);
+                encoder.add(tag, values);
+            }
+            appendCompressedRecord(encoder, false, bytes);
+            writeBytes(out, bytes.data(), bytes.size());
+        }
+
+        void writeCompressedContour(const std::string& path, const Contour& contour, double resolution)
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                throw std::runtime_error("writeContour: cannot open " + path);
+            }
+            writeCompressedContour(out, contour, resolution);
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("writeContour: write failed for " + path);
+            }
+        }
+
+        Contour readContour(std::istream& in, std::pmr::memory_resource* resource)
+        {
+            ContourReader reader(in);
+            Contour contour(resource);
+            if (!reader.read(contour, resource))
+            {
+                throw std::runtime_error("readContour: unexpected end of file");
+            }
+            return contour;
+        }
+
+        Contour readContour(const std::string& path, std::pmr::memory_resource* resource)
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                throw std::runtime_error("readContour: cannot open " + path);
+            }
+            return readContour(in, resource);
+        }
+
+        // ContourReader implementation
+        ContourReader::ContourReader(std::istream& in)
+            : m_in(in)
+            , m_block(BLOCK_BYTES)
+        {
+        }
+
+        bool ContourReader::loadRecord()
+        {
+            unsigned char headerBytes[CNT_HEADER_SIZE];
+            readExactly(m_in, headerBytes, CNT_HEADER_SIZE, "ContourReader");
+            const CntHeader header = parseHeader(headerBytes, "ContourReader");
+            const bool continuesPrevious = m_inContour && m_continued;
+            m_tagCount = 0;
+            m_nextTag = 0;
+            m_continued = (header.flags & CNT_FLAG_CONTINUED) != 0;
+
+            m_compressed = (header.flags & CNT_FLAG_COMPRESSED) != 0;
+            if (m_compressed)
+            {
+                // Every segment takes at least two payload bytes
+                if (header.segmentCount > header.payloadSize / 2)
+                {
+                    throw std::runtime_error("ContourReader: segment count does not match the compressed payload");
+                }
+                m_packed.clear();
+                while (m_packed.size() < header.payloadSize)
+                {
+                    const std::size_t offset = m_packed.size();
+                    const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(BLOCK_BYTES, header.payloadSize - offset));
+                    m_packed.resize(offset + count);
+                    readExactly(m_in, m_packed.data() + offset, count, "ContourReader");
+                }
+                m_decoder.reset(m_packed.data(), m_packed.size(), header.segmentCount, continuesPrevious, "ContourReader");
+                m_tagCount = static_cast<std::size_t>(header.segmentCount);
+                return true;
+            }
+
+            // The tag column grows as it is read, never ahead of the data
+            const std::uint64_t tagBytes = tagColumnSize(header.segmentCount);
+            if (tagBytes < header.segmentCount)
+            {
+                throw std::runtime_error("ContourReader: segment count out of range");
+            }
+            m_tags.clear();
+            while (m_tags.size() < tagBytes)
+            {
+                const std::size_t offset = m_tags.size();
+                const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(BLOCK_BYTES, tagBytes - offset));
+                m_tags.resize(offset + count);
+                readExactly(m_in, m_tags.data() + offset, count, "ContourReader");
+            }
+
+            std::uint64_t payloadDoubles = 0;
+            for (std::uint64_t i = 0; i < header.segmentCount; ++i)
+            {
+                const std::size_t doubles = doublesForTag(m_tags[i]);
+                if (doubles == 0)
+                {
+                    throw std::runtime_error("ContourReader: unknown segment tag " + std::to_string(m_tags[i]));
+                }
+                payloadDoubles += doubles;
+            }
+            if (header.payloadSize != payloadDoubles * sizeof(double))
+            {
+                throw std::runtime_error("ContourReader: payload size does not match the segment tags");
+            }
+
+            m_tagCount = static_cast<std::size_t>(header.segmentCount);
+            m_payloadRemaining = header.payloadSize;
+            m_used = 0;
+            m_available = 0;
+            return true;
+        }
+
+        bool ContourReader::nextValues(unsigned char& tag, double (&values)[ARC_DOUBLES])
+        {
+            if (!m_inContour)
+            {
+                return false;
+            }
+            while (m_nextTag == m_tagCount)
+            {
+                if (!m_continued)
+                {
+                    m_inContour = false;
+                    return false;
+                }
+                loadRecord();
+            }
+
+            ++m_nextTag;
+            if (m_compressed)
+            {
+                return m_decoder.next(tag, values);
+            }
+
+            tag = m_tags[m_nextTag - 1];
+            const std::size_t doubles = doublesForTag(tag);
+            for (std::size_t k = 0; k < doubles; ++k)
+            {
+                if (m_used == m_available)
+                {
+                    m_available = static_cast<std::size_t>(std::min<std::uint64_t>(m_block.size(), m_payloadRemaining));
+                    readExactly(m_in, m_block.data(), m_available, "ContourReader");
+                    m_payloadRemaining -= m_available;
+                    m_used = 0;
+                }
+                values[k] = detail::loadDouble(m_block.data() + m_used);
+                m_used += sizeof(double);
+            }
+            if (const char* problem = invalidSegmentValues(tag, values))
+            {
+                throw std::runtime_error(std::string("ContourReader: ") + problem);
+            }
+            return true;
+        }
+
+        bool ContourReader::nextContour()
+        {
+            unsigned char tag;
+            double values[ARC_DOUBLES];
+            while (nextValues(tag, values))
+            {
+            }
+
+            if (m_in.peek() == std::char_traits<char>::eof())
+            {
+                return false;
+            }
+            loadRecord();
+            m_inContour = true;
+            return true;
+        }
+
+        std::size_t ContourReader::readSegments(std::vector<SegmentVariant>& block, std::size_t maxSegments)
+        {
+            block.clear();
+            unsigned char tag;
+            double values[ARC_DOUBLES];
+            while (block.size() < maxSegments && nextValues(tag, values))
+            {
+                try
+                {
+                    if (tag == static_cast<unsigned char>(SegmentTag::Line))
+                    {
+                        block.emplace_back(LineSegment(geometry::Point2D(values[0], values[1]),
+                                                       geometry::Point2D(values[2], values[3])));
+                    }
+                    else
+                    {
+                        block.emplace_back(ArcSegment(geometry::Point2D(values[0], values[1]), values[2], values[3], values[4],
+                                                      tag == static_cast<unsigned char>(SegmentTag::ArcClockwise)));
+                    }
+                }
+                catch (const std::invalid_argument& e)
+                {
+                    throw std::runtime_error(std::string("ContourReader: ") + e.what());
+                }
+            }
+            return block.size();
+        }
+
+        bool ContourReader::read(Contour& contour, std::pmr::memory_resource* resource)
+        {
+            if (!nextContour())
+            {
+                return false;
+            }
+
+            Contour result(resource);
+            result.reserve(m_tagCount);
+            unsigned char tag;
+            double values[ARC_DOUBLES];
+            while (nextValues(tag, values))
+            {
+                try
+                {
+                    if (tag == static_cast<unsigned char>(SegmentTag::Line))
+                    {
+                        result.addSegment(createLineSegment(geometry::Point2D(values[0], values[1]),
+                                                            geometry::Point2D(values[2], values[3]), resource));
+                    }
+                    else
+                    {
+                        const bool clockwise = tag == static_cast<unsigned char>(SegmentTag::ArcClockwise);
+                        result.addSegment(createArcSegment(geometry::Point2D(values[0], values[1]), values[2],
+                                                           values[3], values[4], clockwise, resource));
+                    }
+                }
+                catch (const std::invalid_argument& e)
+                {
+                    throw std::runtime_error("readContour: segment " + std::to_string(result.size()) + ": " + e.what());
+                }
+            }
+            contour = std::move(result);
+            return true;
+        }
+
+        // ContourWriter implementation
+        ContourWriter::ContourWriter(std::ostream& out, std::size_t blockSegments)
+            : m_out(out)
+            , m_blockSegments(blockSegments)
+        {
+            if (blockSegments == 0)
+            {
+                throw std::invalid_argument("ContourWriter: block size must be positive");
+            }
+            m_tags.reserve(std::min(blockSegments, BLOCK_BYTES));
+        }
+
+        ContourWriter::~ContourWriter()
+        {
+            if (m_open)
+            {
+                try
+                {
+                    endContour();
+                }
+                catch (...)
+                {
+                }
+            }
+        }
+
+        void ContourWriter::addLine(const geometry::Point2D& start, const geometry::Point2D& end)
+        {
+            const LineSegment line(start, end);
+            const double values[LINE_DOUBLES] = { start.x, start.y, end.x, end.y };
+            append(SegmentTag::Line, values, LINE_DOUBLES);
+        }
+
+        void ContourWriter::addArc(const geometry::Point2D& center, double radius,
+                                   double startAngle, double endAngle, bool clockwise)
+        {
+            const ArcSegment arc(center, radius, startAngle, endAngle, clockwise);
+            const double values[ARC_DOUBLES] = { center.x, center.y, radius, startAngle, endAngle };
+            append(clockwise ? SegmentTag::ArcClockwise : SegmentTag::ArcCounterClockwise, values, ARC_DOUBLES);
+        }
+
+        void ContourWriter::addSegment(const Segment& segment)
+        {
+            if (segment.getType() == SegmentType::Line)
+            {
+                addLine(segment.getStartPoint(), segment.getEndPoint());
+                return;
+            }
+            const auto& arc = static_cast<const ArcSegment&>(segment);
+            addArc(arc.getCenter(), arc.getRadius(), arc.getStartAngle(), arc.getEndAngle(), arc.isClockwise());
+        }
+
+        void ContourWriter::addSegment(const SegmentVariant& segment)
+        {
+            std::visit([this](const auto& concrete) { addSegment(static_cast<const Segment&>(concrete)); }, segment);
+        }
+
+        void ContourWriter::addPoint(const geometry::Point2D& point)
+        {
+            // Same pairing as createPolylineContour: each point against the one before it
+            if (m_hasPoint && !m_lastPoint.isEqual(point))
+            {
+                addLine(m_lastPoint, point);
+            }
+            m_lastPoint = point;
+            m_hasPoint = true;
+            m_open = true;
+        }
+
+        void ContourWriter::endContour()
+        {
+            flushRecord(false);
+            m_open = false;
+            m_hasPoint = false;
+            ++m_contourCount;
+        }
+
+        void ContourWriter::writeContour(const Contour& contour)
+        {
+            if (m_open)
+            {
+                throw std::logic_error("ContourWriter::writeContour: a contour is still open");
+            }
+            for (const auto& segment : contour)
+            {
+                addSegment(*segment);
+            }
+            endContour();
+        }
+
+        void ContourWriter::setCompression(double resolution)
+        {
+            if (m_open)
+            {
+                throw std::logic_error("ContourWriter::setCompression: a contour is still open");
+            }
+            if (resolution == 0.0)
+            {
+                m_encoder.reset();
+            }
+            else
+            {
+                m_encoder.emplace(resolution);
+            }
+        }
+
+        std::size_t ContourWriter::pendingSegments() const
+        {
+            return m_encoder ? m_encoder->size() : m_tags.size();
+        }
+
+        void ContourWriter::append(SegmentTag tag, const double* values, std::size_t count)
+        {
+            // A full block is written only once more segments arrive, so the
+            // last record of a contour is never an empty one
+            if (pendingSegments() == m_blockSegments)
+            {
+                flushRecord(true);
+            }
+            if (m_encoder)
+            {
+                m_encoder->add(tag, values);
+            }
+            else
+            {
+                m_tags.push_back(static_cast<unsigned char>(tag));
+                m_values.insert(m_values.end(), values, values + count);
+            }
+            m_open = true;
+        }
+
+        void ContourWriter::flushRecord(bool continued)
+        {
+            if (m_encoder)
+            {
+                std::vector<unsigned char> bytes;
+                appendCompressedRecord(*m_encoder, continued, bytes);
+                writeBytes(m_out, bytes.data(), bytes.size());
+                return;
+            }
+
+            CntHeader header;
+            header.flags = continued ? CNT_FLAG_CONTINUED : 0;
+            header.segmentCount = m_tags.size();
+            header.payloadSize = m_values.size() * sizeof(double);
+            unsigned char headerBytes[CNT_HEADER_SIZE];
+            formatHeader(header, headerBytes);
+            writeBytes(m_out, headerBytes, CNT_HEADER_SIZE);
+
+            m_tags.resize(tagColumnSize(m_tags.size()), 0);
+            writeBytes(m_out, m_tags.data(), m_tags.size());
+
+            std::vector<unsigned char> block(std::min(BLOCK_BYTES, m_values.size() * sizeof(double)));
+            std::size_t used = 0;
+            for (const double value : m_values)
+            {
+                if (used == block.size())
+                {
+                    writeBytes(m_out, block.data(), used);
+                    used = 0;
+                }
+                detail::storeDouble(block.data() + used, value);
+                used += sizeof(double);
+            }
+            writeBytes(m_out, block.data(), used);
+
+            m_tags.clear();
+            m_values.clear();
+        }
+    }
+}
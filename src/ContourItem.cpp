@@ -0,0 +1,176 @@
+#include "../include/ContourItem.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QVector>
+#include <QLineF>
+#include <algorithm>
+#include <cmath>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+ContourItem::ContourItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+    // exposedRect is only filled in with the extended style option
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
+
+void ContourItem::setContour(const contour::Contour& contour)
+{
+    prepareGeometryChange();
+    m_contour = contour;
+    updateBounds();
+
+    m_segmentStyles.resize(m_contour.size(), 0);
+    m_arcPaths.assign(m_contour.size(), QPainterPath());
+    m_arcBuilt.assign(m_contour.size(), false);
+    update();
+}
+
+void ContourItem::replaceSegments(const contour::Contour& contour, size_t first, size_t oldEnd, size_t newEnd)
+{
+    const size_t count = m_contour.size();
+    if (first > oldEnd || first > newEnd || oldEnd > count || contour.size() != count - oldEnd + newEnd) {
+        setContour(contour);
+        return;
+    }
+
+    prepareGeometryChange();
+    m_contour = contour;
+    updateBounds();
+
+    // Grow or shrink the caches at the end of the range so later entries keep their segments
+    if (newEnd > oldEnd) {
+        m_segmentStyles.insert(m_segmentStyles.begin() + oldEnd, newEnd - oldEnd, 0);
+        m_arcPaths.insert(m_arcPaths.begin() + oldEnd, newEnd - oldEnd, QPainterPath());
+        m_arcBuilt.insert(m_arcBuilt.begin() + oldEnd, newEnd - oldEnd, false);
+    } else if (oldEnd > newEnd) {
+        m_segmentStyles.erase(m_segmentStyles.begin() + newEnd, m_segmentStyles.begin() + oldEnd);
+        m_arcPaths.erase(m_arcPaths.begin() + newEnd, m_arcPaths.begin() + oldEnd);
+        m_arcBuilt.erase(m_arcBuilt.begin() + newEnd, m_arcBuilt.begin() + oldEnd);
+    }
+    for (size_t i = first; i < std::min(oldEnd, newEnd); ++i) {
+        m_arcPaths[i] = QPainterPath();
+        m_arcBuilt[i] = false;
+    }
+    update();
+}
+
+void ContourItem::updateBounds()
+{
+    // Pad the exact segment bounds by the widest pen so strokes are not clipped
+    const geometry::BoundingBox box = m_contour.getBoundingBox();
+    double pad = 0.0;
+    for (const Style& style : m_styles) {
+        pad = std::max(pad, style.thickness);
+    }
+    m_bounds = box.isEmpty() ? QRectF()
+                             : QRectF(QPointF(box.minPoint.x, box.minPoint.y), QPointF(box.maxPoint.x, box.maxPoint.y))
+                                   .adjusted(-pad, -pad, pad, pad);
+}
+
+void ContourItem::setSegmentStyle(size_t segmentIndex, const QColor& color, double thickness)
+{
+    if (segmentIndex >= m_segmentStyles.size()) {
+        return;
+    }
+    const std::uint32_t style = styleIndex(color, thickness);
+    if (m_segmentStyles[segmentIndex] != style) {
+        m_segmentStyles[segmentIndex] = style;
+        update();
+    }
+}
+
+std::uint32_t ContourItem::styleIndex(const QColor& color, double thickness)
+{
+    // Contours use a handful of styles, so a linear search beats a map
+    for (std::uint32_t i = 0; i < m_styles.size(); ++i) {
+        if (m_styles[i].color == color && m_styles[i].thickness == thickness) {
+            return i;
+        }
+    }
+    if (thickness > 0.0 && !m_bounds.isNull()) {
+        prepareGeometryChange();
+        m_bounds.adjust(-thickness, -thickness, thickness, thickness);
+    }
+    m_styles.push_back(Style{color, thickness});
+    return static_cast<std::uint32_t>(m_styles.size() - 1);
+}
+
+QRectF ContourItem::boundingRect() const
+{
+    return m_bounds;
+}
+
+const QPainterPath& ContourItem::arcPath(size_t segmentIndex) const
+{
+    if (!m_arcBuilt[segmentIndex]) {
+        // Same arc as ContourScene::createSegmentItem draws; arcMoveTo keeps
+        // the path from starting with a line out of the origin
+        const auto& arc = static_cast<const contour::ArcSegment&>(m_contour[segmentIndex]);
+        const geometry::Point2D center = arc.getCenter();
+        const double radius = arc.getRadius();
+        const QRectF rect(center.x - radius, center.y - radius, 2 * radius, 2 * radius);
+        const double startDeg = arc.getStartAngle() * 180.0 / M_PI;
+        double sweepDeg = arc.getEndAngle() * 180.0 / M_PI - startDeg;
+        if (sweepDeg < 0) sweepDeg += 360.0;
+
+        QPainterPath path;
+        path.arcMoveTo(rect, startDeg);
+        path.arcTo(rect, startDeg, sweepDeg);
+        m_arcPaths[segmentIndex] = path;
+        m_arcBuilt[segmentIndex] = true;
+    }
+    return m_arcPaths[segmentIndex];
+}
+
+void ContourItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget);
+    if (!painter || m_contour.empty() || m_styles.empty()) {
+        return;
+    }
+
+    // Only segments whose boxes meet the exposed rect, padded by the pen
+    QRectF exposed = option ? option->exposedRect : m_bounds;
+    if (exposed.isEmpty()) {
+        exposed = m_bounds;
+    }
+    double pad = 0.0;
+    for (const Style& style : m_styles) {
+        pad = std::max(pad, style.thickness);
+    }
+    exposed.adjust(-pad, -pad, pad, pad);
+    const std::vector<contour::Contour::size_type> visible = m_contour.segmentsInBox(
+        geometry::BoundingBox(geometry::Point2D(exposed.left(), exposed.top()),
+                              geometry::Point2D(exposed.right(), exposed.bottom())));
+
+    // Bucket by style: lines are batched, arcs are drawn from their cached paths
+    std::vector<QVector<QLineF>> lines(m_styles.size());
+    std::vector<std::vector<size_t>> arcs(m_styles.size());
+    for (contour::Contour::size_type index : visible) {
+        const contour::Segment& segment = m_contour[index];
+        const std::uint32_t style = m_segmentStyles[index];
+        if (segment.getType() == contour::SegmentType::Arc) {
+            arcs[style].push_back(index);
+        } else {
+            const geometry::Point2D start = segment.getStartPoint();
+            const geometry::Point2D end = segment.getEndPoint();
+            lines[style].append(QLineF(start.x, start.y, end.x, end.y));
+        }
+    }
+
+    painter->setBrush(Qt::NoBrush);
+    for (size_t style = 0; style < m_styles.size(); ++style) {
+        if (lines[style].isEmpty() && arcs[style].empty()) {
+            continue;
+        }
+        painter->setPen(QPen(m_styles[style].color, m_styles[style].thickness));
+        if (!lines[style].isEmpty()) {
+            painter->drawLines(lines[style].constData(), lines[style].size());
+        }
+        for (size_t index : arcs[style]) {
+            painter->drawPath(arcPath(index));
+        }
+    }
+}
@@ -1,5 +1,10 @@
 #include "../include/ContourScene.h"
+#include "../include/ContourItem.h"
+#include "../include/ContourUtilities.h"
+#include "../include/Log.h"
 #include <QPainter>
+#include <QPixmap>
+#include <QTransform>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsLineItem>
 #include <QGraphicsEllipseItem>
@@ -8,12 +13,40 @@
 #include <QDebug>
 #include <cmath>
 #include <limits>
-#include <iostream>
 #include <cstdlib>
 #include <utility>
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <QSignalBlocker>
+#include <algorithm>
+
+namespace
+{
+    // Exact comparison of what a segment item draws; segments shared by two
+    // contour snapshots compare by address
+    bool isSameGeometry(const contour::Segment& a, const contour::Segment& b)
+    {
+        if (&a == &b) {
+            return true;
+        }
+        if (a.getType() != b.getType()) {
+            return false;
+        }
+        if (a.getType() == contour::SegmentType::Arc) {
+            const auto& arcA = static_cast<const contour::ArcSegment&>(a);
+            const auto& arcB = static_cast<const contour::ArcSegment&>(b);
+            return arcA.getCenter().x == arcB.getCenter().x && arcA.getCenter().y == arcB.getCenter().y
+                && arcA.getRadius() == arcB.getRadius()
+                && arcA.getStartAngle() == arcB.getStartAngle() && arcA.getEndAngle() == arcB.getEndAngle()
+                && arcA.isClockwise() == arcB.isClockwise();
+        }
+        const geometry::Point2D startA = a.getStartPoint();
+        const geometry::Point2D startB = b.getStartPoint();
+        const geometry::Point2D endA = a.getEndPoint();
+        const geometry::Point2D endB = b.getEndPoint();
+        return startA.x == startB.x && startA.y == startB.y && endA.x == endB.x && endA.y == endB.y;
+    }
+}
 
 ContourScene::ContourScene(QWidget* parent)
     : QGraphicsScene(parent)
@@ -30,9 +63,20 @@ ContourScene::ContourScene(QWidget* parent)
     , m_arcCenterMarker(nullptr)
     , m_arcRadiusMarker(nullptr)
     , m_arcStep(0)
+    , m_vertexGrid(HIT_CELL_SIZE)
+    , m_segmentGrid(HIT_CELL_SIZE)
+    , m_lodActive(false)
+    , m_viewZoom(1.0)
+    , m_lodZoom(1.0)
+    , m_renderBackend(RenderBackend::Items)
+    , m_contourItem(nullptr)
+    , m_gridTileZoom(0.0)
+    , m_gridTileSize(0.0)
+    , m_gridMinorStep(20.0)
+    , m_gridTileUsable(false)
     , m_isUpdatingScene(false)
     , m_isMouseDragging(false)
-    , m_mouseUpdateCounter(0)
+    , m_hasPendingMove(false)
     , m_isEmittingSignals(true)
     , m_isInVertexUpdate(false)
     , m_recursionDepth(0)
@@ -41,6 +85,9 @@ ContourScene::ContourScene(QWidget* parent)
 {
     setSceneRect(-500, -500, 1000, 1000);
     
+    m_moveTimer.setSingleShot(true);
+    connect(&m_moveTimer, &QTimer::timeout, this, &ContourScene::applyPendingMove);
+    
     // Initialize default colors
     m_defaultColors = {
         QColor(255, 0, 0),    // Red
@@ -55,29 +102,30 @@ ContourScene::ContourScene(QWidget* parent)
         QColor(128, 128, 0)   // Olive
     };
     
-    std::cout << "ContourScene initialized with enhanced recursion protection" << std::endl;
+    CONTOUR_DEBUG(contour::log::Scene, "ContourScene initialized with enhanced recursion protection");
 }
 
 void ContourScene::setContour(const contour::Contour& contour)
 {
     try {
         if (m_updateInProgress) {
-            std::cout << "Preventing recursive setContour call" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Preventing recursive setContour call");
             return;
         }
         
-        m_updateInProgress = true;
+        // updateScene has its own guard, so it runs before the flag is raised
         m_contour = contour;
         updateScene();
+        m_updateInProgress = true;
         
         if (m_isEmittingSignals && !m_isUpdatingScene) {
-            std::cout << "[TRACE] emit contourModified" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "emit contourModified");
         emit contourModified();
         }
         
         m_updateInProgress = false;
     } catch (const std::exception& e) {
-        std::cerr << "Error setting contour: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error setting contour: " << e.what());
         m_updateInProgress = false;
     }
 }
@@ -88,19 +136,19 @@ void ContourScene::addLineSegment(const geometry::Point2D& start, const geometry
         // Basic validation
         if (std::isnan(start.x) || std::isnan(start.y) || 
             std::isnan(end.x) || std::isnan(end.y)) {
-            std::cerr << "Invalid point coordinates" << std::endl;
+            CONTOUR_WARNING(contour::log::Scene, "Invalid point coordinates");
             return;
         }
 
         // Check if points are too close
         if (start.isEqual(end, 1e-6)) {
-            std::cerr << "Start and end points are too close" << std::endl;
+            CONTOUR_WARNING(contour::log::Scene, "Start and end points are too close");
             return;
         }
 
         auto segment = contour::createLineSegment(start, end);
         if (!segment) {
-            std::cerr << "Failed to create line segment" << std::endl;
+            CONTOUR_ERROR(contour::log::Scene, "Failed to create line segment");
             return;
         }
         
@@ -110,15 +158,15 @@ void ContourScene::addLineSegment(const geometry::Point2D& start, const geometry
         if (!m_isUpdatingScene && !m_updateInProgress) {
         updateScene();
             if (m_isEmittingSignals) {
-                std::cout << "[TRACE] emit contourModified" << std::endl;
+                CONTOUR_TRACE(contour::log::Scene, "emit contourModified");
         emit contourModified();
             }
         }
         
-        std::cout << "Added line segment: (" << start.x << "," << start.y << ") to (" 
-                  << end.x << "," << end.y << ")" << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Added line segment: (" << start.x << "," << start.y << ") to (" 
+                                           << end.x << "," << end.y << ")");
     } catch (const std::exception& e) {
-        std::cerr << "Error adding line segment: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error adding line segment: " << e.what());
     }
 }
 
@@ -128,23 +176,23 @@ void ContourScene::addArcSegment(const geometry::Point2D& center, double radius,
     try {
         // Basic validation
         if (std::isnan(center.x) || std::isnan(center.y)) {
-            std::cerr << "Invalid center point coordinates" << std::endl;
+            CONTOUR_WARNING(contour::log::Scene, "Invalid center point coordinates");
             return;
         }
         
         if (std::isnan(radius) || radius <= 0) {
-            std::cerr << "Invalid radius value" << std::endl;
+            CONTOUR_WARNING(contour::log::Scene, "Invalid radius value");
             return;
         }
         
         if (std::isnan(startAngle) || std::isnan(endAngle)) {
-            std::cerr << "Invalid angle values" << std::endl;
+            CONTOUR_WARNING(contour::log::Scene, "Invalid angle values");
             return;
         }
 
         auto segment = contour::createArcSegment(center, radius, startAngle, endAngle, clockwise);
         if (!segment) {
-            std::cerr << "Failed to create arc segment" << std::endl;
+            CONTOUR_ERROR(contour::log::Scene, "Failed to create arc segment");
             return;
         }
         
@@ -154,15 +202,15 @@ void ContourScene::addArcSegment(const geometry::Point2D& center, double radius,
         if (!m_isUpdatingScene && !m_updateInProgress) {
         updateScene();
             if (m_isEmittingSignals) {
-                std::cout << "[TRACE] emit contourModified" << std::endl;
+                CONTOUR_TRACE(contour::log::Scene, "emit contourModified");
         emit contourModified();
             }
         }
         
-        std::cout << "Added arc segment: center(" << center.x << "," << center.y 
-                  << "), radius=" << radius << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Added arc segment: center(" << center.x << "," << center.y 
+                                           << "), radius=" << radius);
     } catch (const std::exception& e) {
-        std::cerr << "Error adding arc segment: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error adding arc segment: " << e.what());
     }
 }
 
@@ -170,7 +218,7 @@ void ContourScene::clear()
 {
     try {
         if (m_updateInProgress) {
-            std::cout << "Preventing recursive clear call" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Preventing recursive clear call");
             return;
         }
         
@@ -181,16 +229,26 @@ void ContourScene::clear()
         removeVertexMarkers();
         m_segmentVisuals.clear();
         m_vertices.clear();
+        m_vertexGrid.clear();
+        m_segmentGrid.clear();
+        m_segmentBoxes.clear();
+        m_shownContour = contour::Contour();
+        m_lodTiles.clear();
+        m_lodActive = false;
+        m_contourItem = nullptr;
+        if (m_renderBackend == RenderBackend::Batched) {
+            createContourItem();
+        }
         m_editingVertex = nullptr;
         
         if (m_isEmittingSignals && !m_isUpdatingScene) {
-            std::cout << "[TRACE] emit contourModified" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "emit contourModified");
         emit contourModified();
         }
         
         m_updateInProgress = false;
     } catch (const std::exception& e) {
-        std::cerr << "Error clearing scene: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error clearing scene: " << e.what());
         m_updateInProgress = false;
     }
 }
@@ -198,13 +256,13 @@ void ContourScene::clear()
 // Edit mode methods
 void ContourScene::setEditMode(EditMode mode)
 {
-    std::cout << "[TRACE] setEditMode called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "setEditMode called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive setEditMode call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive setEditMode call");
         return;
     }
 
@@ -220,19 +278,19 @@ void ContourScene::setEditMode(EditMode mode)
             }
         }
         
-        std::cout << "Edit mode changed to: " << (mode == EditMode::Draw ? "Draw" : "Edit") << std::endl;
+        CONTOUR_INFO(contour::log::Scene, "Edit mode changed to: " << (mode == EditMode::Draw ? "Draw" : "Edit"));
     }
 }
 
 void ContourScene::setDrawingMode(DrawingMode mode)
 {
-    std::cout << "[TRACE] setDrawingMode called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "setDrawingMode called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive setDrawingMode call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive setDrawingMode call");
         return;
     }
 
@@ -249,25 +307,25 @@ void ContourScene::setDrawingMode(DrawingMode mode)
             cleanupArcDrawing();
         }
         
-        std::cout << "Drawing mode changed to: " << (mode == DrawingMode::Line ? "Line" : "Arc") << std::endl;
+        CONTOUR_INFO(contour::log::Scene, "Drawing mode changed to: " << (mode == DrawingMode::Line ? "Line" : "Arc"));
     }
 }
 
 // Color management methods
 void ContourScene::setSegmentColor(size_t segmentIndex, const QColor& color)
 {
-    std::cout << "[TRACE] setSegmentColor called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "setSegmentColor called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive setSegmentColor call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive setSegmentColor call");
         return;
     }
 
     if (segmentIndex >= m_contour.size()) {
-        std::cerr << "Invalid segment index: " << segmentIndex << std::endl;
+        CONTOUR_WARNING(contour::log::Scene, "Invalid segment index: " << segmentIndex);
         return;
     }
     
@@ -282,31 +340,33 @@ void ContourScene::setSegmentColor(size_t segmentIndex, const QColor& color)
             } else if (QGraphicsPathItem* pathItem = qgraphicsitem_cast<QGraphicsPathItem*>(it->second.visualItem)) {
                 pathItem->setPen(QPen(color, it->second.thickness));
             }
+        } else if (m_contourItem) {
+            m_contourItem->setSegmentStyle(segmentIndex, color, it->second.thickness);
         }
         
-        std::cout << "Set segment " << segmentIndex << " color to " << color.name().toStdString() << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Set segment " << segmentIndex << " color to " << color.name().toStdString());
     }
 }
 
 void ContourScene::setSegmentThickness(size_t segmentIndex, double thickness)
 {
-    std::cout << "[TRACE] setSegmentThickness called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "setSegmentThickness called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive setSegmentThickness call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive setSegmentThickness call");
         return;
     }
 
     if (segmentIndex >= m_contour.size()) {
-        std::cerr << "Invalid segment index: " << segmentIndex << std::endl;
+        CONTOUR_WARNING(contour::log::Scene, "Invalid segment index: " << segmentIndex);
         return;
     }
     
     if (thickness <= 0.0) {
-        std::cerr << "Invalid thickness value: " << thickness << std::endl;
+        CONTOUR_WARNING(contour::log::Scene, "Invalid thickness value: " << thickness);
         return;
     }
     
@@ -321,9 +381,11 @@ void ContourScene::setSegmentThickness(size_t segmentIndex, double thickness)
             } else if (QGraphicsPathItem* pathItem = qgraphicsitem_cast<QGraphicsPathItem*>(it->second.visualItem)) {
                 pathItem->setPen(QPen(it->second.color, thickness));
             }
+        } else if (m_contourItem) {
+            m_contourItem->setSegmentStyle(segmentIndex, it->second.color, thickness);
         }
         
-        std::cout << "Set segment " << segmentIndex << " thickness to " << thickness << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Set segment " << segmentIndex << " thickness to " << thickness);
     }
 }
 
@@ -359,7 +421,7 @@ double ContourScene::getSegmentThickness(size_t segmentIndex) const
 void ContourScene::startVertexEdit(size_t segmentIndex, bool isStartPoint)
 {
     if (segmentIndex >= m_contour.size()) {
-        std::cerr << "Invalid segment index for vertex edit: " << segmentIndex << std::endl;
+        CONTOUR_WARNING(contour::log::Scene, "Invalid segment index for vertex edit: " << segmentIndex);
         return;
     }
     
@@ -370,12 +432,12 @@ void ContourScene::startVertexEdit(size_t segmentIndex, bool isStartPoint)
         m_editingVertex = new VertexInfo{segmentIndex, isStartPoint, nullptr, point};
         m_editStartPos = QPointF(point.x, point.y);
         
-        std::cout << "[TRACE] emit vertexEditStarted" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "emit vertexEditStarted");
         emit vertexEditStarted(segmentIndex, isStartPoint);
-        std::cout << "Started editing vertex " << (isStartPoint ? "start" : "end") 
-                  << " of segment " << segmentIndex << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Started editing vertex " << (isStartPoint ? "start" : "end") 
+                                           << " of segment " << segmentIndex);
     } catch (const std::exception& e) {
-        std::cerr << "Error starting vertex edit: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error starting vertex edit: " << e.what());
     }
 }
 
@@ -384,86 +446,121 @@ void ContourScene::finishVertexEdit()
     if (m_editingVertex) {
         delete m_editingVertex;
         m_editingVertex = nullptr;
-        std::cout << "[TRACE] emit vertexEditFinished" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "emit vertexEditFinished");
         emit vertexEditFinished();
-        std::cout << "Finished vertex editing" << std::endl;
+        CONTOUR_DEBUG(contour::log::Scene, "Finished vertex editing");
     }
 }
 
 // Vertex editing helper methods
 void ContourScene::createVertexMarkers()
 {
-    std::cout << "[TRACE] createVertexMarkers called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "createVertexMarkers called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive createVertexMarkers call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive createVertexMarkers call");
         return;
     }
 
     QSignalBlocker blocker(this); // Blokir signal Qt internal selama update
     removeVertexMarkers();
-    m_vertices.clear();
+    m_vertices.assign(2 * m_contour.size(), VertexInfo{0, true, nullptr, geometry::Point2D()});
+    m_vertexGrid.clear();
     
     for (size_t i = 0; i < m_contour.size(); ++i) {
-        try {
-            const auto& segment = m_contour.at(i);
-            
-            // Create start point marker
-            auto startPoint = segment.getStartPoint();
-            QGraphicsEllipseItem* startMarker = new QGraphicsEllipseItem(startPoint.x - 4, startPoint.y - 4, 8, 8);
-            startMarker->setBrush(Qt::red);
-            startMarker->setPen(QPen(Qt::black, 1));
-            startMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
-            startMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
-            addItem(startMarker);
-            
-            VertexInfo startVertex{i, true, startMarker, startPoint};
-            m_vertices.push_back(startVertex);
-            
-            // Create end point marker
-            auto endPoint = segment.getEndPoint();
-            QGraphicsEllipseItem* endMarker = new QGraphicsEllipseItem(endPoint.x - 4, endPoint.y - 4, 8, 8);
-            endMarker->setBrush(Qt::blue);
-            endMarker->setPen(QPen(Qt::black, 1));
-            endMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
-            endMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
-            addItem(endMarker);
-            
-            VertexInfo endVertex{i, false, endMarker, endPoint};
-            m_vertices.push_back(endVertex);
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Error creating vertex markers for segment " << i << ": " << e.what() << std::endl;
-        }
+        addVertexMarkers(i);
     }
     
-    std::cout << "Created " << m_vertices.size() << " vertex markers" << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "Created " << m_vertices.size() << " vertex markers");
+}
+
+void ContourScene::addVertexMarkers(size_t segmentIndex)
+{
+    try {
+        const auto& segment = m_contour.at(segmentIndex);
+        
+        // Create start point marker
+        auto startPoint = segment.getStartPoint();
+        QGraphicsEllipseItem* startMarker = new QGraphicsEllipseItem(startPoint.x - 4, startPoint.y - 4, 8, 8);
+        startMarker->setBrush(Qt::red);
+        startMarker->setPen(QPen(Qt::black, 1));
+        startMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
+        startMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
+        addItem(startMarker);
+        startMarker->setVisible(!m_lodActive);
+        setVertex(segmentIndex, true, startMarker, startPoint);
+        
+        // Create end point marker
+        auto endPoint = segment.getEndPoint();
+        QGraphicsEllipseItem* endMarker = new QGraphicsEllipseItem(endPoint.x - 4, endPoint.y - 4, 8, 8);
+        endMarker->setBrush(Qt::blue);
+        endMarker->setPen(QPen(Qt::black, 1));
+        endMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
+        endMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
+        addItem(endMarker);
+        endMarker->setVisible(!m_lodActive);
+        setVertex(segmentIndex, false, endMarker, endPoint);
+    } catch (const std::exception& e) {
+        CONTOUR_ERROR(contour::log::Scene, "Error creating vertex markers for segment " << segmentIndex << ": " << e.what());
+    }
 }
 
 void ContourScene::updateVertexMarker(size_t segmentIndex, bool isStartPoint, const QPointF& pos)
 {
-    for (auto& vertex : m_vertices) {
-        if (vertex.segmentIndex == segmentIndex && vertex.isStartPoint == isStartPoint) {
-            if (vertex.marker) {
-                vertex.marker->setPos(pos.x() - 4, pos.y() - 4);
-            }
-            break;
-        }
+    const size_t slot = 2 * segmentIndex + (isStartPoint ? 0 : 1);
+    if (slot >= m_vertices.size() || !m_vertices[slot].marker) {
+        return;
+    }
+    
+    // The marker rect is built around the point it was created at, so the
+    // item offset is relative to that rect's center
+    QGraphicsEllipseItem* marker = m_vertices[slot].marker;
+    marker->setPos(pos - marker->rect().center());
+    setVertex(segmentIndex, isStartPoint, marker, geometry::Point2D(pos.x(), pos.y()));
+}
+
+void ContourScene::deleteVertexMarker(size_t slot)
+{
+    if (slot >= m_vertices.size() || !m_vertices[slot].marker) {
+        return;
+    }
+    
+    VertexInfo& vertex = m_vertices[slot];
+    m_vertexGrid.erase(slot, vertex.originalPoint);
+    removeItem(vertex.marker);
+    delete vertex.marker;
+    vertex.marker = nullptr;
+}
+
+void ContourScene::setVertex(size_t segmentIndex, bool isStartPoint, QGraphicsEllipseItem* marker, const geometry::Point2D& point)
+{
+    const size_t slot = 2 * segmentIndex + (isStartPoint ? 0 : 1);
+    if (slot >= m_vertices.size()) {
+        m_vertices.resize(slot + 1, VertexInfo{0, true, nullptr, geometry::Point2D()});
+    }
+    
+    VertexInfo& vertex = m_vertices[slot];
+    if (vertex.marker) {
+        m_vertexGrid.erase(slot, vertex.originalPoint);
+    }
+    vertex = VertexInfo{segmentIndex, isStartPoint, marker, point};
+    if (marker) {
+        m_vertexGrid.insert(slot, point);
     }
 }
 
 void ContourScene::removeVertexMarkers()
 {
-    std::cout << "[TRACE] removeVertexMarkers called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "removeVertexMarkers called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     // Prevent recursion by checking if we're already updating
     if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
-        std::cout << "Preventing recursive removeVertexMarkers call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive removeVertexMarkers call");
         return;
     }
 
@@ -476,49 +573,98 @@ void ContourScene::removeVertexMarkers()
                 }
                 delete vertex.marker;
             } catch (const std::exception& e) {
-                std::cerr << "Error removing vertex marker: " << e.what() << std::endl;
+                CONTOUR_ERROR(contour::log::Scene, "Error removing vertex marker: " << e.what());
             }
             vertex.marker = nullptr;
         }
     }
     m_vertices.clear();
+    m_vertexGrid.clear();
 }
 
-VertexInfo* ContourScene::findVertexAt(const QPointF& pos)
+VertexInfo* ContourScene::findVertexAt(const QPointF& pos, double tolerance)
 {
-    const double tolerance = 6.0; // 6 pixels tolerance
-    
-    for (auto& vertex : m_vertices) {
-        if (vertex.marker) {
-            QRectF bounds = vertex.marker->boundingRect();
-            QPointF markerPos = vertex.marker->pos() + QPointF(4, 4); // Center of marker
-            QPointF diff = pos - markerPos;
-            
-            if (std::abs(diff.x()) <= tolerance && std::abs(diff.y()) <= tolerance) {
-                return &vertex;
-            }
+    // Only the cells within tolerance of pos are visited; of the vertices
+    // there, the closest one inside the tolerance square wins
+    const geometry::BoundingBox range(geometry::Point2D(pos.x() - tolerance, pos.y() - tolerance),
+                                      geometry::Point2D(pos.x() + tolerance, pos.y() + tolerance));
+    size_t found = m_vertices.size();
+    double bestDistance = std::numeric_limits<double>::infinity();
+    m_vertexGrid.query(range, [&](size_t slot) {
+        const VertexInfo& vertex = m_vertices[slot];
+        const double dx = pos.x() - vertex.originalPoint.x;
+        const double dy = pos.y() - vertex.originalPoint.y;
+        if (!vertex.marker || std::abs(dx) > tolerance || std::abs(dy) > tolerance) {
+            return;
         }
+        // Ties go to the lower slot so the result does not depend on cell order
+        const double distance = dx * dx + dy * dy;
+        if (distance < bestDistance || (distance == bestDistance && slot < found)) {
+            bestDistance = distance;
+            found = slot;
+        }
+    });
+    return found < m_vertices.size() ? &m_vertices[found] : nullptr;
+}
+
+int ContourScene::findSegmentAt(const QPointF& pos, double tolerance) const
+{
+    const geometry::Point2D point(pos.x(), pos.y());
+    const geometry::BoundingBox range(geometry::Point2D(pos.x() - tolerance, pos.y() - tolerance),
+                                      geometry::Point2D(pos.x() + tolerance, pos.y() + tolerance));
+    int found = -1;
+    double bestDistance = tolerance;
+    m_segmentGrid.query(range, [&](size_t segmentIndex) {
+        if (segmentIndex >= m_contour.size()) {
+            return;
+        }
+        const double distance = m_contour[segmentIndex].distanceTo(point);
+        if (distance < bestDistance || (distance == bestDistance && (found < 0 || int(segmentIndex) < found))) {
+            bestDistance = distance;
+            found = int(segmentIndex);
+        }
+    });
+    return found;
+}
+
+void ContourScene::rebuildSegmentIndex()
+{
+    m_segmentGrid.clear();
+    m_segmentBoxes.resize(m_contour.size());
+    for (size_t i = 0; i < m_contour.size(); ++i) {
+        m_segmentBoxes[i] = m_contour[i].getBoundingBox();
+        m_segmentGrid.insert(i, m_segmentBoxes[i]);
+    }
+}
+
+void ContourScene::reindexSegment(size_t segmentIndex)
+{
+    if (segmentIndex >= m_contour.size() || segmentIndex >= m_segmentBoxes.size()) {
+        rebuildSegmentIndex();
+        return;
     }
-    return nullptr;
+    m_segmentGrid.erase(segmentIndex, m_segmentBoxes[segmentIndex]);
+    m_segmentBoxes[segmentIndex] = m_contour[segmentIndex].getBoundingBox();
+    m_segmentGrid.insert(segmentIndex, m_segmentBoxes[segmentIndex]);
 }
 
 void ContourScene::updateSegmentAfterVertexEdit(size_t segmentIndex, bool isStartPoint, const geometry::Point2D& newPoint)
 {
-    std::cout << "[TRACE] updateSegmentAfterVertexEdit called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "updateSegmentAfterVertexEdit called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     try {
         // Prevent recursion by checking if we're already updating
         if (m_isUpdatingScene || m_isInVertexUpdate || m_vertexUpdateInProgress || m_updateInProgress) {
-            std::cout << "Preventing recursive vertex update" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Preventing recursive vertex update");
             return;
         }
         
         // Track recursion depth
         m_recursionDepth++;
         if (m_recursionDepth > 2) { // Reduced from 3 to 2
-            std::cout << "Recursion depth limit reached: " << m_recursionDepth << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Recursion depth limit reached: " << m_recursionDepth);
             m_recursionDepth--;
             return;
         }
@@ -558,11 +704,15 @@ void ContourScene::updateSegmentAfterVertexEdit(size_t segmentIndex, bool isStar
         }
         
         if (newSegment) {
-            // Replace the segment in the contour
+            // Replace the segment in the contour; only the joints on either
+            // side of it are rechecked
             m_contour.replaceSegment(segmentIndex, std::move(newSegment));
+            reindexSegment(segmentIndex);
             
             // Update only the specific visual item without triggering full scene update
             updateSegmentVisualOnly(segmentIndex);
+            m_shownContour = m_contour;
+            applyLevelOfDetail(segmentIndex, segmentIndex + 1);
             
             // Update vertex markers for this segment only
             if (m_editMode == EditMode::Edit) {
@@ -571,16 +721,16 @@ void ContourScene::updateSegmentAfterVertexEdit(size_t segmentIndex, bool isStar
             
             // Emit signal only if not in recursive update
             if (m_isEmittingSignals && !m_isUpdatingScene) {
-                std::cout << "[TRACE] emit contourModified" << std::endl;
+                CONTOUR_TRACE(contour::log::Scene, "emit contourModified");
                 emit contourModified();
             }
             
-            std::cout << "Updated segment " << segmentIndex << " " 
-                      << (isStartPoint ? "start" : "end") << " point to (" 
-                      << newPoint.x << "," << newPoint.y << ")" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Updated segment " << segmentIndex << " " 
+                                               << (isStartPoint ? "start" : "end") << " point to ("
+                                               << newPoint.x << "," << newPoint.y << ")");
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error updating segment after vertex edit: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error updating segment after vertex edit: " << e.what());
     }
     
     // Cleanup recursion tracking
@@ -591,8 +741,8 @@ void ContourScene::updateSegmentAfterVertexEdit(size_t segmentIndex, bool isStar
 
 void ContourScene::updateSegmentVisualOnly(size_t segmentIndex)
 {
-    std::cout << "[TRACE] updateSegmentVisualOnly called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "updateSegmentVisualOnly called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress);
     try {
         if (segmentIndex >= m_contour.size()) {
             return;
@@ -603,6 +753,13 @@ void ContourScene::updateSegmentVisualOnly(size_t segmentIndex)
             return;
         }
         
+        // The batched item repaints from the new snapshot and drops only
+        // this segment's cached path; styles are unchanged
+        if (m_contourItem) {
+            m_contourItem->replaceSegments(m_contour, segmentIndex, segmentIndex + 1, segmentIndex + 1);
+            return;
+        }
+        
         const auto& segment = m_contour.at(segmentIndex);
         auto it = m_segmentVisuals.find(segmentIndex);
         
@@ -615,16 +772,16 @@ void ContourScene::updateSegmentVisualOnly(size_t segmentIndex)
             createSegmentItemOnly(segment, segmentIndex);
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error updating segment visual: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error updating segment visual: " << e.what());
     }
 }
 
 void ContourScene::updateVertexMarkersForSegmentOnly(size_t segmentIndex)
 {
-    std::cout << "[TRACE] updateVertexMarkersForSegmentOnly called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "updateVertexMarkersForSegmentOnly called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     try {
         if (segmentIndex >= m_contour.size()) {
             return;
@@ -632,62 +789,29 @@ void ContourScene::updateVertexMarkersForSegmentOnly(size_t segmentIndex)
         
         // Prevent recursion during vertex editing
         if (m_isUpdatingScene || m_isMouseDragging || m_isInVertexUpdate || m_vertexUpdateInProgress || m_updateInProgress) {
-            std::cout << "Preventing recursive vertex marker update" << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Preventing recursive vertex marker update");
             return;
         }
         
         // Track recursion depth
         m_recursionDepth++;
         if (m_recursionDepth > 1) { // Reduced from 2 to 1
-            std::cout << "Vertex marker recursion depth limit reached: " << m_recursionDepth << std::endl;
+            CONTOUR_TRACE(contour::log::Scene, "Vertex marker recursion depth limit reached: " << m_recursionDepth);
             m_recursionDepth--;
             return;
         }
         
-        const auto& segment = m_contour.at(segmentIndex);
-        
-        // Remove existing vertex markers for this segment only
-        for (auto it = m_vertices.begin(); it != m_vertices.end();) {
-            if (it->segmentIndex == segmentIndex) {
-                if (it->marker) {
-                    removeItem(it->marker);
-                    delete it->marker;
-                }
-                it = m_vertices.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        // Remove existing vertex markers for this segment only; the slots stay
+        // in place so the other entries and their grid cells are untouched
+        deleteVertexMarker(2 * segmentIndex);
+        deleteVertexMarker(2 * segmentIndex + 1);
         
         // Create new vertex markers for this segment only
-        auto startPoint = segment.getStartPoint();
-        auto endPoint = segment.getEndPoint();
-        
-        // Create start point marker
-        QGraphicsEllipseItem* startMarker = new QGraphicsEllipseItem(startPoint.x - 4, startPoint.y - 4, 8, 8);
-        startMarker->setBrush(Qt::red);
-        startMarker->setPen(QPen(Qt::black, 1));
-        startMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
-        startMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
-        addItem(startMarker);
-        
-        VertexInfo startVertex{segmentIndex, true, startMarker, startPoint};
-        m_vertices.push_back(startVertex);
-        
-        // Create end point marker
-        QGraphicsEllipseItem* endMarker = new QGraphicsEllipseItem(endPoint.x - 4, endPoint.y - 4, 8, 8);
-        endMarker->setBrush(Qt::blue);
-        endMarker->setPen(QPen(Qt::black, 1));
-        endMarker->setFlag(QGraphicsItem::ItemIsSelectable, true);
-        endMarker->setFlag(QGraphicsItem::ItemIsMovable, true); // Aktifkan drag
-        addItem(endMarker);
+        addVertexMarkers(segmentIndex);
         
-        VertexInfo endVertex{segmentIndex, false, endMarker, endPoint};
-        m_vertices.push_back(endVertex);
-        
-        std::cout << "Updated vertex markers for segment " << segmentIndex << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Updated vertex markers for segment " << segmentIndex);
     } catch (const std::exception& e) {
-        std::cerr << "Error updating vertex markers: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error updating vertex markers: " << e.what());
     }
     
     m_recursionDepth--;
@@ -717,6 +841,11 @@ bool ContourScene::isClosed() const
     return m_contour.isClosed();
 }
 
+const std::vector<size_t>& ContourScene::getDisconnectedJoints() const
+{
+    return m_contour.getDisconnectedJoints();
+}
+
 void ContourScene::setShowGrid(bool show)
 {
     if (m_showGrid != show) {
@@ -730,6 +859,182 @@ void ContourScene::setSnapToGrid(bool snap)
     m_snapToGrid = snap;
 }
 
+void ContourScene::setRenderBackend(RenderBackend backend)
+{
+    if (m_isUpdatingScene || m_updateInProgress || m_isInVertexUpdate || m_vertexUpdateInProgress) {
+        CONTOUR_TRACE(contour::log::Render, "Preventing recursive setRenderBackend call");
+        return;
+    }
+    if (backend == m_renderBackend) {
+        return;
+    }
+    
+    QSignalBlocker blocker(this); // Blokir signal Qt internal selama update
+    m_renderBackend = backend;
+    if (backend == RenderBackend::Batched) {
+        for (auto& entry : m_segmentVisuals) {
+            if (entry.second.visualItem) {
+                removeItem(entry.second.visualItem);
+                delete entry.second.visualItem;
+                entry.second.visualItem = nullptr;
+            }
+        }
+        createContourItem();
+    } else {
+        if (m_contourItem) {
+            removeItem(m_contourItem);
+            delete m_contourItem;
+            m_contourItem = nullptr;
+        }
+        // createSegmentItem picks the recorded styles up from m_segmentVisuals
+        for (size_t i = 0; i < m_shownContour.size(); ++i) {
+            createSegmentItem(m_shownContour[i], i);
+        }
+    }
+    
+    CONTOUR_INFO(contour::log::Render, "Render backend changed to: " << (backend == RenderBackend::Items ? "Items" : "Batched"));
+}
+
+void ContourScene::createContourItem()
+{
+    m_contourItem = new ContourItem();
+    m_contourItem->setContour(m_shownContour);
+    for (const auto& entry : m_segmentVisuals) {
+        m_contourItem->setSegmentStyle(entry.first, entry.second.color, entry.second.thickness);
+    }
+    m_contourItem->setVisible(!m_lodActive);
+    addItem(m_contourItem);
+}
+
+void ContourScene::setViewZoom(double pixelsPerUnit)
+{
+    if (!(pixelsPerUnit > 0.0) || std::isinf(pixelsPerUnit)) {
+        CONTOUR_WARNING(contour::log::Render, "Invalid view zoom: " << pixelsPerUnit);
+        return;
+    }
+    m_viewZoom = pixelsPerUnit;
+    applyLevelOfDetail(0, 0);
+}
+
+bool ContourScene::wantsLevelOfDetail() const
+{
+    if (m_contour.size() < LOD_MIN_SEGMENTS) {
+        return false;
+    }
+    const double averageLength = m_contour.getTotalLength() / static_cast<double>(m_contour.size());
+    return averageLength * m_viewZoom < LOD_PIXEL_THRESHOLD;
+}
+
+void ContourScene::applyLevelOfDetail(size_t firstChanged, size_t lastChanged)
+{
+    const bool wanted = wantsLevelOfDetail();
+    if (wanted != m_lodActive) {
+        CONTOUR_INFO(contour::log::Render, "Level of detail " << (wanted ? "on" : "off") << " at zoom " << m_viewZoom);
+        m_lodActive = wanted;
+        setDetailItemsVisible(!wanted);
+        if (!wanted) {
+            removeLodTiles();
+            return;
+        }
+        m_lodZoom = m_viewZoom;
+        rebuildLodTiles(0, m_contour.size());
+        return;
+    }
+    if (!m_lodActive) {
+        return;
+    }
+    
+    // Tiles are only as fine as the zoom they were built for
+    const double ratio = m_viewZoom / m_lodZoom;
+    if (ratio > LOD_REBUILD_RATIO || ratio < 1.0 / LOD_REBUILD_RATIO) {
+        m_lodZoom = m_viewZoom;
+        rebuildLodTiles(0, m_contour.size());
+    } else {
+        rebuildLodTiles(firstChanged, lastChanged);
+    }
+}
+
+void ContourScene::setDetailItemsVisible(bool visible)
+{
+    for (auto& entry : m_segmentVisuals) {
+        if (entry.second.visualItem) {
+            entry.second.visualItem->setVisible(visible);
+        }
+    }
+    for (auto& vertex : m_vertices) {
+        if (vertex.marker) {
+            vertex.marker->setVisible(visible);
+        }
+    }
+    if (m_contourItem) {
+        m_contourItem->setVisible(visible);
+    }
+}
+
+void ContourScene::rebuildLodTiles(size_t firstChanged, size_t lastChanged)
+{
+    // Tile t draws segments [t * LOD_TILE_SEGMENTS, (t + 1) * LOD_TILE_SEGMENTS)
+    const size_t segmentCount = m_contour.size();
+    const size_t tileCount = (segmentCount + LOD_TILE_SEGMENTS - 1) / LOD_TILE_SEGMENTS;
+    const size_t oldTileCount = m_lodTiles.size();
+    while (m_lodTiles.size() > tileCount) {
+        removeItem(m_lodTiles.back());
+        delete m_lodTiles.back();
+        m_lodTiles.pop_back();
+    }
+    m_lodTiles.resize(tileCount, nullptr);
+    
+    // Tiles touching the changed range, plus any new ones at the end
+    const size_t firstTile = std::min(firstChanged, lastChanged) / LOD_TILE_SEGMENTS;
+    const size_t lastTile = std::min(tileCount, (lastChanged + LOD_TILE_SEGMENTS - 1) / LOD_TILE_SEGMENTS);
+    const double tolerance = LOD_TOLERANCE_PIXELS / m_lodZoom;
+    
+    std::vector<geometry::Point2D> points;
+    std::vector<size_t> starts;
+    for (size_t tile = 0; tile < tileCount; ++tile) {
+        const bool changed = tile >= firstTile && tile < lastTile;
+        if (!changed && tile < oldTileCount) {
+            continue;
+        }
+        
+        const size_t first = tile * LOD_TILE_SEGMENTS;
+        const size_t last = std::min(segmentCount, first + LOD_TILE_SEGMENTS);
+        try {
+            contour::utilities::simplifyForDisplay(m_contour, first, last, tolerance, points, starts);
+        } catch (const std::exception& e) {
+            CONTOUR_ERROR(contour::log::Render, "Error simplifying segments " << first << "-" << last << ": " << e.what());
+            continue;
+        }
+        
+        QPainterPath path;
+        for (size_t k = 0; k < starts.size(); ++k) {
+            const size_t end = k + 1 < starts.size() ? starts[k + 1] : points.size();
+            path.moveTo(points[starts[k]].x, points[starts[k]].y);
+            for (size_t i = starts[k] + 1; i < end; ++i) {
+                path.lineTo(points[i].x, points[i].y);
+            }
+        }
+        
+        if (!m_lodTiles[tile]) {
+            m_lodTiles[tile] = new QGraphicsPathItem();
+            m_lodTiles[tile]->setPen(QPen(Qt::darkGray, 0)); // cosmetic, one pixel at any zoom
+            addItem(m_lodTiles[tile]);
+        }
+        m_lodTiles[tile]->setPath(path);
+    }
+}
+
+void ContourScene::removeLodTiles()
+{
+    for (QGraphicsPathItem* tile : m_lodTiles) {
+        if (tile) {
+            removeItem(tile);
+            delete tile;
+        }
+    }
+    m_lodTiles.clear();
+}
+
 void ContourScene::cleanupPreviewItem()
 {
     if (m_previewItem) {
@@ -740,7 +1045,7 @@ void ContourScene::cleanupPreviewItem()
             }
             delete m_previewItem;
         } catch (const std::exception& e) {
-            std::cerr << "Error cleaning up preview item: " << e.what() << std::endl;
+            CONTOUR_ERROR(contour::log::Scene, "Error cleaning up preview item: " << e.what());
         }
         m_previewItem = nullptr;
     }
@@ -755,7 +1060,7 @@ void ContourScene::cleanupArcDrawing()
             }
             delete m_arcCenterMarker;
         } catch (const std::exception& e) {
-            std::cerr << "Error cleaning up arc center marker: " << e.what() << std::endl;
+            CONTOUR_ERROR(contour::log::Scene, "Error cleaning up arc center marker: " << e.what());
         }
         m_arcCenterMarker = nullptr;
     }
@@ -767,7 +1072,7 @@ void ContourScene::cleanupArcDrawing()
             }
             delete m_arcRadiusMarker;
         } catch (const std::exception& e) {
-            std::cerr << "Error cleaning up arc radius marker: " << e.what() << std::endl;
+            CONTOUR_ERROR(contour::log::Scene, "Error cleaning up arc radius marker: " << e.what());
         }
         m_arcRadiusMarker = nullptr;
     }
@@ -777,7 +1082,7 @@ void ContourScene::cleanupArcDrawing()
 
 void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    std::cout << "[TRACE] mousePressEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode << std::endl;
+    CONTOUR_TRACE(contour::log::Input, "mousePressEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode);
     if (!event || event->button() != Qt::LeftButton) {
         QGraphicsScene::mousePressEvent(event);
                 return;
@@ -794,10 +1099,17 @@ void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                 startVertexEdit(vertex->segmentIndex, vertex->isStartPoint);
                 m_editStartPos = pos;
                 m_lastMousePos = pos;
-                m_mouseUpdateCounter = 0;
+                m_hasPendingMove = false;
                 m_isMouseDragging = true;
                 return;
             }
+            
+            // Otherwise pick the segment under the unsnapped cursor
+            int segmentIndex = findSegmentAt(event->scenePos());
+            if (segmentIndex >= 0) {
+                CONTOUR_TRACE(contour::log::Input, "emit segmentPicked");
+                emit segmentPicked(static_cast<size_t>(segmentIndex));
+            }
         } else if (m_editMode == EditMode::Draw) {
             if (m_drawingMode == DrawingMode::Line) {
                 // Line drawing
@@ -813,7 +1125,7 @@ void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                 m_previewItem = lineItem;
             }
                 
-                std::cout << "Started drawing line at: (" << m_lastPoint.x() << "," << m_lastPoint.y() << ")" << std::endl;
+                CONTOUR_DEBUG(contour::log::Input, "Started drawing line at: (" << m_lastPoint.x() << "," << m_lastPoint.y() << ")");
             } else if (m_drawingMode == DrawingMode::Arc) {
                 if (!m_isDrawingArc) {
                     // Klik 1: set center
@@ -826,7 +1138,7 @@ void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                     m_arcCenterMarker->setBrush(Qt::yellow);
                     m_arcCenterMarker->setPen(QPen(Qt::black));
                     addItem(m_arcCenterMarker);
-                    std::cout << "[TRACE] Arc center set at: (" << pos.x() << "," << pos.y() << ")" << std::endl;
+                    CONTOUR_TRACE(contour::log::Input, "Arc center set at: (" << pos.x() << "," << pos.y() << ")");
                 } else if (m_arcStep == 1) {
                     // Klik 2: set start
                     m_arcStartPoint = pos;
@@ -846,12 +1158,12 @@ void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                     arcItem->setPen(QPen(Qt::blue, 2, Qt::DashLine));
                     addItem(arcItem);
                     m_previewItem = arcItem;
-                    std::cout << "[TRACE] Arc start set at: (" << pos.x() << "," << pos.y() << ")" << std::endl;
+                    CONTOUR_TRACE(contour::log::Input, "Arc start set at: (" << pos.x() << "," << pos.y() << ")");
                 }
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in mousePressEvent: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Input, "Error in mousePressEvent: " << e.what());
         m_isDrawing = false;
         if (m_isDrawingArc) {
             cleanupArcDrawing();
@@ -861,46 +1173,72 @@ void ContourScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 
 void ContourScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
-    std::cout << "[TRACE] mouseMoveEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode << std::endl;
+    CONTOUR_TRACE(contour::log::Input, "mouseMoveEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode);
     if (!event) {
         QGraphicsScene::mouseMoveEvent(event);
         return;
     }
     try {
-            QPointF currentPos = event->scenePos();
+        QPointF currentPos = event->scenePos();
         if (m_snapToGrid) {
             currentPos = snapToGrid(currentPos);
         }
+        
+        const bool draggingVertex = m_editMode == EditMode::Edit && m_editingVertex;
+        const bool drawingPreview = m_editMode == EditMode::Draw && m_previewItem
+            && ((m_drawingMode == DrawingMode::Line && m_isDrawing)
+                || (m_drawingMode == DrawingMode::Arc && m_isDrawingArc && m_arcStep == 2));
+        if (!draggingVertex && !drawingPreview) {
+            return;
+        }
+        
+        // Keep only the newest position; a move after a quiet frame is applied
+        // at once, faster moves wait for the end of the current frame
+        m_pendingMovePos = currentPos;
+        m_hasPendingMove = true;
+        const qint64 elapsed = m_moveClock.isValid() ? m_moveClock.elapsed() : MOVE_FRAME_INTERVAL_MS;
+        if (elapsed >= MOVE_FRAME_INTERVAL_MS) {
+            m_moveTimer.stop();
+            applyPendingMove();
+        } else if (!m_moveTimer.isActive()) {
+            m_moveTimer.start(static_cast<int>(MOVE_FRAME_INTERVAL_MS - elapsed));
+        }
+    } catch (const std::exception& e) {
+        CONTOUR_ERROR(contour::log::Input, "Error in mouseMoveEvent: " << e.what());
+    }
+}
+
+void ContourScene::applyPendingMove()
+{
+    if (!m_hasPendingMove) {
+        return;
+    }
+    m_hasPendingMove = false;
+    m_moveClock.start();
+    const QPointF currentPos = m_pendingMovePos;
+    
+    try {
         if (m_editMode == EditMode::Edit && m_editingVertex) {
             // Prevent excessive updates during vertex editing
             if (m_isUpdatingScene || m_isInVertexUpdate || m_vertexUpdateInProgress) {
                 return; // Skip if we're already updating
             }
-            
-            // Throttle updates to prevent recursion - more aggressive
-            m_mouseUpdateCounter++;
-            if (m_mouseUpdateCounter % 20 != 0) { // Update every 20th mouse move
+            if (currentPos == m_lastMousePos) {
                 return;
             }
-            
-            // Check if position has changed significantly
-            QPointF diff = currentPos - m_lastMousePos;
-            if (std::abs(diff.x()) < 10.0 && std::abs(diff.y()) < 10.0) { // Larger threshold
-                return; // Skip small movements
-            }
-            
             m_lastMousePos = currentPos;
             
-            // Set vertex update flag to prevent recursion
-            m_vertexUpdateInProgress = true;
-            
             // Temporarily disable signal emission during vertex editing
             bool wasEmittingSignals = m_isEmittingSignals;
             m_isEmittingSignals = false;
             
-            // Update vertex position during editing
+            // Update vertex position during editing. The segment edit raises
+            // and clears its own recursion flags, so it must run before ours
             geometry::Point2D newPoint(currentPos.x(), currentPos.y());
             updateSegmentAfterVertexEdit(m_editingVertex->segmentIndex, m_editingVertex->isStartPoint, newPoint);
+            
+            // Set vertex update flag to prevent recursion
+            m_vertexUpdateInProgress = true;
             updateVertexMarker(m_editingVertex->segmentIndex, m_editingVertex->isStartPoint, currentPos);
             
             // Restore signal emission
@@ -910,8 +1248,8 @@ void ContourScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
         } else if (m_editMode == EditMode::Draw) {
             if (m_drawingMode == DrawingMode::Line && m_isDrawing && m_previewItem) {
                 // Line drawing - update preview line
-            QGraphicsLineItem* lineItem = qgraphicsitem_cast<QGraphicsLineItem*>(m_previewItem);
-            if (lineItem) {
+                QGraphicsLineItem* lineItem = qgraphicsitem_cast<QGraphicsLineItem*>(m_previewItem);
+                if (lineItem) {
                     lineItem->setLine(QLineF(m_lastPoint, currentPos));
                 }
             } else if (m_drawingMode == DrawingMode::Arc && m_isDrawingArc && m_arcStep == 2 && m_previewItem) {
@@ -930,27 +1268,31 @@ void ContourScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in mouseMoveEvent: " << e.what() << std::endl;
+        m_vertexUpdateInProgress = false;
+        CONTOUR_ERROR(contour::log::Input, "Error applying mouse move: " << e.what());
     }
 }
 
 void ContourScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 {
-    std::cout << "[TRACE] mouseReleaseEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode << std::endl;
+    CONTOUR_TRACE(contour::log::Input, "mouseReleaseEvent: m_editMode=" << (int)m_editMode << ", m_drawingMode=" << (int)m_drawingMode);
     if (!event || event->button() != Qt::LeftButton) {
         QGraphicsScene::mouseReleaseEvent(event);
         return;
     }
     try {
+        // Land on the release position before finishing the drag or drawing
+        m_moveTimer.stop();
+        applyPendingMove();
+        
         if (m_editMode == EditMode::Edit && m_editingVertex) {
             // Finish vertex editing
             finishVertexEdit();
             m_isMouseDragging = false;
-            m_mouseUpdateCounter = 0;
             
             // Emit signal after vertex editing is complete
             if (m_isEmittingSignals && !m_isUpdatingScene && !m_updateInProgress) {
-                std::cout << "[TRACE] emit contourModified" << std::endl;
+                CONTOUR_TRACE(contour::log::Input, "emit contourModified");
                 emit contourModified();
             }
         } else if (m_editMode == EditMode::Draw) {
@@ -974,7 +1316,7 @@ void ContourScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
                 cleanupPreviewItem();
             m_isDrawing = false;
                 
-                std::cout << "Finished drawing line to: (" << endPos.x() << "," << endPos.y() << ")" << std::endl;
+                CONTOUR_DEBUG(contour::log::Input, "Finished drawing line to: (" << endPos.x() << "," << endPos.y() << ")");
             } else if (m_drawingMode == DrawingMode::Arc && m_isDrawingArc && m_arcStep == 2) {
                 // Arc drawing - finish drawing
                 QPointF endPos = event->scenePos();
@@ -1008,11 +1350,11 @@ void ContourScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
                 m_isDrawingArc = false;
                 m_arcStep = 0;
                 
-                std::cout << "Finished drawing arc to: (" << endPos.x() << "," << endPos.y() << ")" << std::endl;
+                CONTOUR_DEBUG(contour::log::Input, "Finished drawing arc to: (" << endPos.x() << "," << endPos.y() << ")");
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in mouseReleaseEvent: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Input, "Error in mouseReleaseEvent: " << e.what());
         cleanupPreviewItem();
         m_isDrawing = false;
         if (m_isDrawingArc) {
@@ -1032,34 +1374,100 @@ void ContourScene::drawBackground(QPainter *painter, const QRectF &rect)
     
     QGraphicsScene::drawBackground(painter, rect);
     
-    if (m_showGrid) {
-        QPen pen(Qt::lightGray, 0);
-        painter->setPen(pen);
-        
-        qreal left = int(rect.left()) - std::fmod(int(rect.left()), m_gridSize);
-        qreal top = int(rect.top()) - std::fmod(int(rect.top()), m_gridSize);
-        
-        QVarLengthArray<QLineF, 100> lines;
-        
-        for (qreal x = left; x < rect.right(); x += m_gridSize)
-            lines.append(QLineF(x, rect.top(), x, rect.bottom()));
-        for (qreal y = top; y < rect.bottom(); y += m_gridSize)
-            lines.append(QLineF(rect.left(), y, rect.right(), y));
-        
-        if (!lines.isEmpty()) {
-            painter->drawLines(lines.data(), lines.size());
-        }
+    if (!m_showGrid) {
+        return;
+    }
+    
+    // Views only scale and translate, so m11 is the zoom in pixels per unit
+    const double pixelsPerUnit = std::abs(painter->worldTransform().m11());
+    if (!(pixelsPerUnit > 0.0) || std::isinf(pixelsPerUnit)) {
+        return;
+    }
+    if (!updateGridTile(pixelsPerUnit)) {
+        drawGridLines(painter, rect);
+        return;
+    }
+    
+    // The brush tiles from the scene origin, so cached tiles stay on the grid while panning
+    painter->fillRect(rect, m_gridBrush);
+}
+
+bool ContourScene::updateGridTile(double pixelsPerUnit)
+{
+    if (pixelsPerUnit == m_gridTileZoom && m_gridSize == m_gridTileSize) {
+        return m_gridTileUsable;
+    }
+    m_gridTileZoom = pixelsPerUnit;
+    m_gridTileSize = m_gridSize;
+    
+    // Coarsen until minor lines are at least GRID_MIN_PIXELS apart
+    m_gridMinorStep = m_gridSize;
+    while (m_gridMinorStep * pixelsPerUnit < GRID_MIN_PIXELS) {
+        m_gridMinorStep *= GRID_MAJOR_EVERY;
+    }
+    
+    // One tile holds a major cell; close in, the grid is drawn directly
+    const double period = m_gridMinorStep * GRID_MAJOR_EVERY;
+    const int tilePixels = static_cast<int>(std::lround(period * pixelsPerUnit));
+    m_gridTileUsable = tilePixels <= GRID_MAX_TILE_PIXELS;
+    if (!m_gridTileUsable) {
+        m_gridBrush = QBrush();
+        return false;
+    }
+    
+    QPixmap tile(tilePixels, tilePixels);
+    tile.fill(Qt::transparent);
+    QPainter tilePainter(&tile);
+    for (int k = GRID_MAJOR_EVERY - 1; k >= 0; --k) {
+        // Minor lines first so the major line on the tile edge is drawn over them
+        tilePainter.setPen(QPen(k == 0 ? GRID_MAJOR_COLOR : GRID_MINOR_COLOR, 0));
+        const double offset = std::floor(k * tilePixels / static_cast<double>(GRID_MAJOR_EVERY));
+        tilePainter.drawLine(QLineF(offset, 0, offset, tilePixels));
+        tilePainter.drawLine(QLineF(0, offset, tilePixels, offset));
+    }
+    tilePainter.end();
+    
+    // Scale the tile from its whole pixels back to exactly one period in scene units
+    m_gridBrush = QBrush(tile);
+    m_gridBrush.setTransform(QTransform::fromScale(period / tilePixels, period / tilePixels));
+    CONTOUR_DEBUG(contour::log::Render, "Grid tile rebuilt: " << tilePixels << " px, minor step " << m_gridMinorStep);
+    return true;
+}
+
+void ContourScene::drawGridLines(QPainter *painter, const QRectF &rect)
+{
+    // Only used close in, where the exposed rect spans few grid cells
+    const double major = m_gridMinorStep * GRID_MAJOR_EVERY;
+    QVarLengthArray<QLineF, 100> minorLines;
+    QVarLengthArray<QLineF, 100> majorLines;
+    
+    for (double x = std::floor(rect.left() / m_gridMinorStep) * m_gridMinorStep; x < rect.right(); x += m_gridMinorStep) {
+        auto& lines = std::fmod(std::abs(x), major) < 0.5 * m_gridMinorStep ? majorLines : minorLines;
+        lines.append(QLineF(x, rect.top(), x, rect.bottom()));
+    }
+    for (double y = std::floor(rect.top() / m_gridMinorStep) * m_gridMinorStep; y < rect.bottom(); y += m_gridMinorStep) {
+        auto& lines = std::fmod(std::abs(y), major) < 0.5 * m_gridMinorStep ? majorLines : minorLines;
+        lines.append(QLineF(rect.left(), y, rect.right(), y));
+    }
+    
+    if (!minorLines.isEmpty()) {
+        painter->setPen(QPen(GRID_MINOR_COLOR, 0));
+        painter->drawLines(minorLines.data(), minorLines.size());
+    }
+    if (!majorLines.isEmpty()) {
+        painter->setPen(QPen(GRID_MAJOR_COLOR, 0));
+        painter->drawLines(majorLines.data(), majorLines.size());
     }
 }
 
 void ContourScene::updateScene()
 {
-    std::cout << "[TRACE] updateScene called. Flags: isUpdatingScene=" << m_isUpdatingScene
-              << ", updateInProgress=" << m_updateInProgress
-              << ", isInVertexUpdate=" << m_isInVertexUpdate
-              << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "updateScene called. Flags: isUpdatingScene=" << m_isUpdatingScene
+                                       << ", updateInProgress=" << m_updateInProgress
+                                       << ", isInVertexUpdate=" << m_isInVertexUpdate
+                                       << ", vertexUpdateInProgress=" << m_vertexUpdateInProgress);
     if (m_isUpdatingScene || m_updateInProgress) {
-        std::cout << "Preventing recursive updateScene call" << std::endl;
+        CONTOUR_TRACE(contour::log::Scene, "Preventing recursive updateScene call");
             return;
         }
     m_isUpdatingScene = true;
@@ -1067,41 +1475,135 @@ void ContourScene::updateScene()
 
     QSignalBlocker blocker(this); // Blokir signal Qt internal selama update
 
-    // Hapus semua item secara manual, jangan pakai QGraphicsScene::clear()
-    QList<QGraphicsItem*> itemsToRemove = items();
-    for (QGraphicsItem* item : itemsToRemove) {
-        removeItem(item);
-        delete item;
+    // Diff against the contour the items were built from. Segments in the
+    // common prefix and suffix keep their items and markers; only the range
+    // between is rebuilt. Chunks the two snapshots still share are skipped
+    // without reading their segments, so only the edited chunks are
+    // compared. A shifted suffix is still renumbered entry by entry. The
+    // grid, preview items and arc markers are left alone.
+    const size_t oldCount = m_shownContour.size();
+    const size_t newCount = m_contour.size();
+    const size_t common = std::min(oldCount, newCount);
+    const auto shared = m_contour.sharedEnds(m_shownContour);
+    size_t prefix = std::min(shared.first, common);
+    while (prefix < common && isSameGeometry(m_shownContour[prefix], m_contour[prefix])) {
+        ++prefix;
     }
-    
-    // Reset preview item pointer karena item sudah dihapus
-    m_previewItem = nullptr;
-    
-    // Reset arc drawing markers
-    m_arcCenterMarker = nullptr;
-    m_arcRadiusMarker = nullptr;
-    
-    m_segmentVisuals.clear();
-    m_vertices.clear(); // Clear vertex markers too
+    size_t suffix = std::min(shared.second, common - prefix);
+    while (suffix < common - prefix
+           && isSameGeometry(m_shownContour[oldCount - 1 - suffix], m_contour[newCount - 1 - suffix])) {
+        ++suffix;
+    }
+    const size_t oldEnd = oldCount - suffix;
+    const size_t newEnd = newCount - suffix;
+    const bool shifted = suffix > 0 && oldCount != newCount;
 
-    std::cout << "Updating scene with " << m_contour.size() << " segments" << std::endl;
+    CONTOUR_TRACE(contour::log::Scene, "Updating scene: segments [" << prefix << ", " << oldEnd << ") of " << oldCount
+                                       << " replaced by [" << prefix << ", " << newEnd << ") of " << newCount);
 
-    // Create items for each segment
-    for (size_t i = 0; i < m_contour.size(); ++i) {
-            try {
-                const auto& segment = m_contour.at(i);
-            createSegmentItem(segment, i);
-            } catch (const std::exception& e) {
-                std::cerr << "Error processing segment " << i << ": " << e.what() << std::endl;
+    // Remove the items of segments that changed
+    for (size_t i = prefix; i < oldEnd; ++i) {
+        auto it = m_segmentVisuals.find(i);
+        if (it != m_segmentVisuals.end()) {
+            if (it->second.visualItem) {
+                removeItem(it->second.visualItem);
+                delete it->second.visualItem;
+            }
+            m_segmentVisuals.erase(it);
+        }
+    }
+
+    if (m_contourItem) {
+        m_contourItem->replaceSegments(m_contour, prefix, oldEnd, newEnd);
+    }
+
+    // Renumber the suffix; its default colors follow the new index as a
+    // rebuild would, custom colors stay with the segment
+    if (shifted) {
+        std::vector<std::pair<size_t, SegmentVisualInfo>> moved(m_segmentVisuals.lower_bound(oldEnd), m_segmentVisuals.end());
+        m_segmentVisuals.erase(m_segmentVisuals.lower_bound(oldEnd), m_segmentVisuals.end());
+        for (auto& entry : moved) {
+            const size_t index = entry.first - oldEnd + newEnd;
+            SegmentVisualInfo& info = entry.second;
+            if (info.color == getDefaultSegmentColor(entry.first) && info.thickness == getDefaultSegmentThickness(entry.first)) {
+                info.color = getDefaultSegmentColor(index);
+                info.thickness = getDefaultSegmentThickness(index);
+                if (QGraphicsLineItem* lineItem = qgraphicsitem_cast<QGraphicsLineItem*>(info.visualItem)) {
+                    lineItem->setPen(QPen(info.color, info.thickness));
+                } else if (QGraphicsPathItem* pathItem = qgraphicsitem_cast<QGraphicsPathItem*>(info.visualItem)) {
+                    pathItem->setPen(QPen(info.color, info.thickness));
+                }
+            }
+            m_segmentVisuals.emplace(index, info);
+            if (m_contourItem) {
+                m_contourItem->setSegmentStyle(index, info.color, info.thickness);
+            }
+        }
+    }
+
+    // Create items for the changed range
+    for (size_t i = prefix; i < newEnd; ++i) {
+        try {
+            createSegmentItem(m_contour.at(i), i);
+        } catch (const std::exception& e) {
+            CONTOUR_ERROR(contour::log::Scene, "Error processing segment " << i << ": " << e.what());
+        }
+    }
+
+    // Segment boxes: renumbering invalidates every key after the change
+    if (shifted) {
+        rebuildSegmentIndex();
+    } else {
+        for (size_t i = prefix; i < oldEnd && i < m_segmentBoxes.size(); ++i) {
+            m_segmentGrid.erase(i, m_segmentBoxes[i]);
+        }
+        m_segmentBoxes.resize(newCount);
+        for (size_t i = prefix; i < newEnd; ++i) {
+            m_segmentBoxes[i] = m_contour[i].getBoundingBox();
+            m_segmentGrid.insert(i, m_segmentBoxes[i]);
         }
     }
 
-    // Recreate vertex markers if in edit mode
+    // Vertex markers follow the same diff when they mirror the old contour
     if (m_editMode == EditMode::Edit) {
-        createVertexMarkers();
+        if (m_vertices.size() == 2 * oldCount) {
+            for (size_t slot = 2 * prefix; slot < 2 * oldEnd; ++slot) {
+                deleteVertexMarker(slot);
+            }
+            if (shifted) {
+                std::vector<VertexInfo> vertices(2 * newCount, VertexInfo{0, true, nullptr, geometry::Point2D()});
+                std::copy(m_vertices.begin(), m_vertices.begin() + 2 * prefix, vertices.begin());
+                std::copy(m_vertices.begin() + 2 * oldEnd, m_vertices.end(), vertices.begin() + 2 * newEnd);
+                m_vertices.swap(vertices);
+                m_vertexGrid.clear();
+                for (size_t slot = 0; slot < m_vertices.size(); ++slot) {
+                    m_vertices[slot].segmentIndex = slot / 2;
+                    if (m_vertices[slot].marker) {
+                        m_vertexGrid.insert(slot, m_vertices[slot].originalPoint);
+                    }
+                }
+            } else {
+                m_vertices.resize(2 * newCount, VertexInfo{0, true, nullptr, geometry::Point2D()});
+            }
+            for (size_t i = prefix; i < newEnd; ++i) {
+                addVertexMarkers(i);
+            }
+        } else {
+            for (size_t slot = 0; slot < m_vertices.size(); ++slot) {
+                deleteVertexMarker(slot);
+            }
+            m_vertices.assign(2 * newCount, VertexInfo{0, true, nullptr, geometry::Point2D()});
+            m_vertexGrid.clear();
+            for (size_t i = 0; i < newCount; ++i) {
+                addVertexMarkers(i);
+            }
+        }
     }
 
-    std::cout << "Scene updated successfully" << std::endl;
+    m_shownContour = m_contour;
+    applyLevelOfDetail(prefix, shifted ? newCount : newEnd);
+
+    CONTOUR_TRACE(contour::log::Scene, "Scene updated successfully");
     m_isUpdatingScene = false;
     m_updateInProgress = false;
 }
@@ -1113,6 +1615,15 @@ void ContourScene::createSegmentItem(const contour::Segment& segment, size_t seg
         QColor color = getSegmentColor(segmentIndex);
         double thickness = getSegmentThickness(segmentIndex);
         
+        // The batched item draws the segment; only its style is recorded
+        if (m_renderBackend == RenderBackend::Batched) {
+            m_segmentVisuals[segmentIndex] = {nullptr, color, thickness};
+            if (m_contourItem) {
+                m_contourItem->setSegmentStyle(segmentIndex, color, thickness);
+            }
+            return;
+        }
+        
         switch (segmentType) {
             case contour::SegmentType::Line: {
                 auto start = segment.getStartPoint();
@@ -1122,13 +1633,14 @@ void ContourScene::createSegmentItem(const contour::Segment& segment, size_t seg
                 QGraphicsLineItem* lineItem = new QGraphicsLineItem(start.x, start.y, end.x, end.y);
                 lineItem->setPen(QPen(color, thickness));
                 addItem(lineItem);
+                lineItem->setVisible(!m_lodActive);
                 
                 // Store visual info
                 m_segmentVisuals[segmentIndex] = {lineItem, color, thickness};
                 
-                std::cout << "Created line segment: (" << start.x << "," << start.y 
-                          << ") to (" << end.x << "," << end.y << ") with color " 
-                          << color.name().toStdString() << std::endl;
+                CONTOUR_TRACE(contour::log::Scene, "Created line segment: (" << start.x << "," << start.y 
+                                                   << ") to (" << end.x << "," << end.y << ") with color "
+                                                   << color.name().toStdString());
                 break;
             }
             case contour::SegmentType::Arc: {
@@ -1155,24 +1667,25 @@ void ContourScene::createSegmentItem(const contour::Segment& segment, size_t seg
                     QGraphicsPathItem* pathItem = new QGraphicsPathItem(path);
                     pathItem->setPen(QPen(color, thickness));
                     addItem(pathItem);
+                    pathItem->setVisible(!m_lodActive);
                     
                     // Store visual info
                     m_segmentVisuals[segmentIndex] = {pathItem, color, thickness};
                     
-                    std::cout << "Created arc segment: center(" << center.x << "," << center.y 
-                              << "), radius=" << radius << " with color " 
-                              << color.name().toStdString() << std::endl;
+                    CONTOUR_TRACE(contour::log::Scene, "Created arc segment: center(" << center.x << "," << center.y 
+                                                       << "), radius=" << radius << " with color "
+                                                       << color.name().toStdString());
                 } catch (const std::bad_cast& e) {
-                    std::cerr << "Failed to cast to ArcSegment: " << e.what() << std::endl;
+                    CONTOUR_ERROR(contour::log::Scene, "Failed to cast to ArcSegment: " << e.what());
                 }
                 break;
             }
             default:
-                std::cerr << "Unknown segment type: " << static_cast<int>(segmentType) << std::endl;
+                CONTOUR_ERROR(contour::log::Scene, "Unknown segment type: " << static_cast<int>(segmentType));
                 break;
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error creating segment item: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error creating segment item: " << e.what());
     }
 }
 
@@ -1203,13 +1716,14 @@ void ContourScene::createSegmentItemOnly(const contour::Segment& segment, size_t
                 QGraphicsLineItem* lineItem = new QGraphicsLineItem(start.x, start.y, end.x, end.y);
                 lineItem->setPen(QPen(color, thickness));
                 addItem(lineItem);
+                lineItem->setVisible(!m_lodActive);
                 
                 // Store visual info
                 m_segmentVisuals[segmentIndex] = {lineItem, color, thickness};
                 
-                std::cout << "Updated line segment: (" << start.x << "," << start.y 
-                          << ") to (" << end.x << "," << end.y << ") with color " 
-                          << color.name().toStdString() << std::endl;
+                CONTOUR_TRACE(contour::log::Scene, "Updated line segment: (" << start.x << "," << start.y 
+                                                   << ") to (" << end.x << "," << end.y << ") with color "
+                                                   << color.name().toStdString());
                 break;
             }
             case contour::SegmentType::Arc: {
@@ -1236,23 +1750,24 @@ void ContourScene::createSegmentItemOnly(const contour::Segment& segment, size_t
                     QGraphicsPathItem* pathItem = new QGraphicsPathItem(path);
                     pathItem->setPen(QPen(color, thickness));
                     addItem(pathItem);
+                    pathItem->setVisible(!m_lodActive);
                     
                     // Store visual info
                     m_segmentVisuals[segmentIndex] = {pathItem, color, thickness};
                     
-                    std::cout << "Updated arc segment: center(" << center.x << "," << center.y 
-                              << "), radius=" << radius << " with color " 
-                              << color.name().toStdString() << std::endl;
+                    CONTOUR_TRACE(contour::log::Scene, "Updated arc segment: center(" << center.x << "," << center.y 
+                                                       << "), radius=" << radius << " with color "
+                                                       << color.name().toStdString());
                 } catch (const std::bad_cast& e) {
-                    std::cerr << "Failed to cast to ArcSegment: " << e.what() << std::endl;
+                    CONTOUR_ERROR(contour::log::Scene, "Failed to cast to ArcSegment: " << e.what());
                 }
                 break;
             }
             default:
-                std::cerr << "Unknown segment type: " << static_cast<int>(segmentType) << std::endl;
+                CONTOUR_ERROR(contour::log::Scene, "Unknown segment type: " << static_cast<int>(segmentType));
                 break;
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error creating segment item: " << e.what() << std::endl;
+        CONTOUR_ERROR(contour::log::Scene, "Error creating segment item: " << e.what());
     }
 } 
\ No newline at end of file
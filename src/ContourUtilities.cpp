@@ -18,19 +18,26 @@ namespace contour::utilities
     }
 
     Contour createPolylineContour(const std::vector<geometry::Point2D>& points)
+    {
+        return createPolylineContour(points, nullptr);
+    }
+
+    Contour createPolylineContour(const std::vector<geometry::Point2D>& points,
+                                  std::pmr::memory_resource* resource)
     {
         if (points.size() < 2)
         {
             throw std::invalid_argument("createPolylineContour: need at least 2 points");
         }
 
-        Contour contour;
+        Contour contour(resource);
+        contour.reserve(points.size() - 1);
         for (size_t i = 0; i < points.size() - 1; ++i)
         {
             // Skip zero-length segments
             if (!points[i].isEqual(points[i + 1]))
             {
-                contour.addSegment(createLineSegment(points[i], points[i + 1]));
+                contour.addSegment(createLineSegment(points[i], points[i + 1], contour.getResource()));
             }
         }
 
@@ -56,6 +63,13 @@ namespace contour::utilities
     // Advanced polyline creation with options
     Contour createPolylineContour(const std::vector<geometry::Point2D>& points, 
                                  const PolylineOptions& options)
+    {
+        return createPolylineContour(points, options, nullptr);
+    }
+
+    Contour createPolylineContour(const std::vector<geometry::Point2D>& points,
+                                  const PolylineOptions& options,
+                                  std::pmr::memory_resource* resource)
     {
         if (points.size() < 2)
         {
@@ -89,7 +103,7 @@ namespace contour::utilities
         }
 
         // Create the contour
-        Contour contour;
+        Contour contour(resource);
         size_t endIndex = processedPoints.size();
         
         // If closing path, add one more segment
@@ -112,7 +126,8 @@ namespace contour::utilities
             
             if (!processedPoints[i].isEqual(processedPoints[nextIndex]))
             {
-                contour.addSegment(createLineSegment(processedPoints[i], processedPoints[nextIndex]));
+                contour.addSegment(createLineSegment(processedPoints[i], processedPoints[nextIndex],
+                                                     contour.getResource()));
             }
         }
 
@@ -137,9 +152,9 @@ namespace contour::utilities
         points.push_back(contour[0].getStartPoint());
 
         // Add end points of all segments
-        for (size_t i = 0; i < contour.size(); ++i)
+        for (const auto& segment : contour)
         {
-            points.push_back(contour[i].getEndPoint());
+            points.push_back(segment->getEndPoint());
         }
 
         return points;
@@ -288,6 +303,248 @@ namespace contour::utilities
 
         return sum > 0.0;
     }
+
+    namespace
+    {
+        // Writes the points at distances k * spacing for k in [0, count) in one
+        // pass; samples past the end (rounding) land on the last segment
+        void sampleAtSpacing(const Contour& contour, double spacing, size_t count, geometry::Point2D* out)
+        {
+            const size_t lastSegment = contour.size() - 1;
+            double segmentStart = 0.0;
+            size_t k = 0;
+
+            // Walk the chunks with the iterator rather than indexing each segment
+            size_t i = 0;
+            for (auto it = contour.begin(); it != contour.end() && k < count; ++it, ++i)
+            {
+                const Segment& segment = **it;
+                const double length = segment.getLength();
+                const double segmentEnd = segmentStart + length;
+
+                // Samples [k, end) fall on this segment
+                size_t end = k;
+                while (end < count && (i == lastSegment || static_cast<double>(end) * spacing <= segmentEnd))
+                {
+                    ++end;
+                }
+
+                if (segment.getType() == SegmentType::Arc)
+                {
+                    const auto& arc = static_cast<const ArcSegment&>(segment);
+                    const geometry::Point2D center = arc.getCenter();
+                    const double radius = arc.getRadius();
+                    const double direction = arc.isClockwise() ? -1.0 : 1.0;
+
+                    // Trig once for the first sample and once for the step angle,
+                    // then rotate (c, s) by the step for every following sample
+                    const double offset = std::min(static_cast<double>(k) * spacing - segmentStart, length);
+                    const double angle = arc.getStartAngle() + direction * offset / radius;
+                    const double stepAngle = direction * spacing / radius;
+                    const double cosStep = std::cos(stepAngle);
+                    const double sinStep = std::sin(stepAngle);
+                    double c = std::cos(angle);
+                    double s = std::sin(angle);
+
+                    for (; k < end; ++k)
+                    {
+                        out[k] = geometry::Point2D(center.x + radius * c, center.y + radius * s);
+                        const double rotated = c * cosStep - s * sinStep;
+                        s = s * cosStep + c * sinStep;
+                        c = rotated;
+                    }
+                }
+                else
+                {
+                    const geometry::Point2D start = segment.getStartPoint();
+                    const geometry::Vector2D delta = segment.getEndPoint() - start;
+                    for (; k < end; ++k)
+                    {
+                        const double t = std::min((static_cast<double>(k) * spacing - segmentStart) / length, 1.0);
+                        out[k] = start + delta * t;
+                    }
+                }
+
+                segmentStart = segmentEnd;
+            }
+        }
+    }
+
+    void resampleUniform(const Contour& contour, size_t n, geometry::Point2D* out)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        if (contour.empty())
+        {
+            throw std::invalid_argument("resampleUniform: contour is empty");
+        }
+        if (!out)
+        {
+            throw std::invalid_argument("resampleUniform: output buffer cannot be null");
+        }
+
+        if (n == 1)
+        {
+            out[0] = contour[0].getStartPoint();
+            return;
+        }
+
+        sampleAtSpacing(contour, contour.getTotalLength() / static_cast<double>(n - 1), n, out);
+
+        // Pin the last sample to the end point instead of the accumulated step
+        out[n - 1] = contour[contour.size() - 1].getEndPoint();
+    }
+
+    size_t resampleByStep(const Contour& contour, double step,
+                          geometry::Point2D* out, size_t capacity)
+    {
+        size_t count = std::min(resampleByStepCount(contour, step), capacity);
+        if (count > 0 && !out)
+        {
+            throw std::invalid_argument("resampleByStep: output buffer cannot be null");
+        }
+
+        if (count > 0)
+        {
+            sampleAtSpacing(contour, step, count, out);
+        }
+        return count;
+    }
+
+    size_t resampleByStepCount(const Contour& contour, double step)
+    {
+        if (std::isnan(step) || step <= 0.0)
+        {
+            throw std::invalid_argument("resampleByStep: step must be positive");
+        }
+        if (contour.empty())
+        {
+            return 0;
+        }
+        return static_cast<size_t>(std::floor(contour.getTotalLength() / step)) + 1;
+    }
+
+    namespace
+    {
+        // Builds the polylines of simplifyForDisplay one vertex at a time
+        class DisplayPolylines
+        {
+        public:
+            DisplayPolylines(double tolerance, std::vector<geometry::Point2D>& points, std::vector<size_t>& starts)
+                : m_tolerance(tolerance), m_points(points), m_starts(starts)
+            {
+            }
+
+            // Starts a polyline at point unless it continues the current one
+            void moveTo(const geometry::Point2D& point)
+            {
+                if (m_open && m_end.distanceTo(point) <= m_tolerance)
+                {
+                    return;
+                }
+                finish();
+                m_starts.push_back(m_points.size());
+                m_points.push_back(point);
+                m_end = point;
+                m_open = true;
+            }
+
+            // Vertices closer than tolerance to the last kept one are dropped
+            void lineTo(const geometry::Point2D& point)
+            {
+                if (m_points.back().distanceTo(point) >= m_tolerance)
+                {
+                    m_points.push_back(point);
+                }
+                m_end = point;
+            }
+
+            // Closes the current polyline on its exact end point
+            void finish()
+            {
+                if (!m_open)
+                {
+                    return;
+                }
+                m_open = false;
+
+                const geometry::Point2D& last = m_points.back();
+                if (last.x != m_end.x || last.y != m_end.y)
+                {
+                    m_points.push_back(m_end);
+                }
+
+                // Polylines below tolerance in size are invisible at this level
+                const size_t start = m_starts.back();
+                if (m_points.size() - start < 3 && m_points[start].distanceTo(m_end) < m_tolerance)
+                {
+                    m_points.resize(start);
+                    m_starts.pop_back();
+                }
+            }
+
+        private:
+            double m_tolerance;
+            std::vector<geometry::Point2D>& m_points;
+            std::vector<size_t>& m_starts;
+            geometry::Point2D m_end;
+            bool m_open = false;
+        };
+    }
+
+    void simplifyForDisplay(const Contour& contour, size_t first, size_t last, double tolerance,
+                            std::vector<geometry::Point2D>& points, std::vector<size_t>& starts)
+    {
+        if (std::isnan(tolerance) || tolerance <= 0.0)
+        {
+            throw std::invalid_argument("simplifyForDisplay: tolerance must be positive");
+        }
+        if (first > last || last > contour.size())
+        {
+            throw std::out_of_range("simplifyForDisplay: segment range out of bounds");
+        }
+
+        points.clear();
+        starts.clear();
+        DisplayPolylines polylines(tolerance, points, starts);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const Segment& segment = contour[i];
+            polylines.moveTo(segment.getStartPoint());
+
+            if (segment.getType() == SegmentType::Arc)
+            {
+                const auto& arc = static_cast<const ArcSegment&>(segment);
+                const double radius = arc.getRadius();
+                const double span = arc.getAngleSpan();
+                if (!std::isnan(span) && radius > 0.0)
+                {
+                    // The chord of angle a strays radius * (1 - cos(a / 2)) from the arc
+                    const double maxStep = 2.0 * std::acos(std::max(-1.0, 1.0 - tolerance / radius));
+                    const size_t steps = static_cast<size_t>(std::max(1.0, std::ceil(span / maxStep)));
+
+                    const geometry::Point2D center = arc.getCenter();
+                    const double stepAngle = (arc.isClockwise() ? -span : span) / static_cast<double>(steps);
+                    const double cosStep = std::cos(stepAngle);
+                    const double sinStep = std::sin(stepAngle);
+                    double c = std::cos(arc.getStartAngle());
+                    double s = std::sin(arc.getStartAngle());
+                    for (size_t k = 1; k < steps; ++k)
+                    {
+                        const double rotated = c * cosStep - s * sinStep;
+                        s = s * cosStep + c * sinStep;
+                        c = rotated;
+                        polylines.lineTo(geometry::Point2D(center.x + radius * c, center.y + radius * s));
+                    }
+                }
+            }
+            polylines.lineTo(segment.getEndPoint());
+        }
+        polylines.finish();
+    }
 } 
 
 namespace contour {
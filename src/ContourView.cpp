@@ -25,6 +25,7 @@ ContourView::ContourView(ContourScene* scene, QWidget* parent)
     // Set initial view
     setSceneRect(-500, -500, 1000, 1000);
     centerOn(0, 0);
+    m_scene->setViewZoom(m_zoomFactor);
 }
 
 ContourView::~ContourView()
@@ -131,12 +132,14 @@ void ContourView::zoomIn()
 {
     m_zoomFactor *= 1.2;
     scale(1.2, 1.2);
+    m_scene->setViewZoom(m_zoomFactor);
 }
 
 void ContourView::zoomOut()
 {
     m_zoomFactor /= 1.2;
     scale(1.0 / 1.2, 1.0 / 1.2);
+    m_scene->setViewZoom(m_zoomFactor);
 }
 
 void ContourView::zoomFit()
@@ -151,6 +154,7 @@ void ContourView::zoomFit()
     // Update zoom factor
     QTransform transform = this->transform();
     m_zoomFactor = transform.m11(); // Use horizontal scale as zoom factor
+    m_scene->setViewZoom(m_zoomFactor);
 }
 
 void ContourView::panView(const QPointF& delta)
@@ -171,39 +171,14 @@ namespace contour::visualization
             return {geometry::Point2D(0, 0), geometry::Point2D(1, 1)};
         }
         
-        double minX = std::numeric_limits<double>::max();
-        double minY = std::numeric_limits<double>::max();
-        double maxX = std::numeric_limits<double>::lowest();
-        double maxY = std::numeric_limits<double>::lowest();
-        
-        for (size_t i = 0; i < contour.size(); ++i)
+        // Cached exact bounds; arcs only count the part of the circle they sweep
+        const geometry::BoundingBox box = contour.getBoundingBox();
+        if (box.isEmpty())
         {
-            const auto& segment = contour[i];
-            
-            // Check start and end points
-            auto start = segment.getStartPoint();
-            auto end = segment.getEndPoint();
-            
-            minX = std::min({minX, start.x, end.x});
-            minY = std::min({minY, start.y, end.y});
-            maxX = std::max({maxX, start.x, end.x});
-            maxY = std::max({maxY, start.y, end.y});
-            
-            // For arcs, also consider the bounding box of the full arc
-            if (segment.getType() == SegmentType::Arc)
-            {
-                const auto& arc = static_cast<const ArcSegment&>(segment);
-                auto center = arc.getCenter();
-                double radius = arc.getRadius();
-                
-                minX = std::min(minX, center.x - radius);
-                minY = std::min(minY, center.y - radius);
-                maxX = std::max(maxX, center.x + radius);
-                maxY = std::max(maxY, center.y + radius);
-            }
+            return {geometry::Point2D(0, 0), geometry::Point2D(1, 1)};
         }
         
-        return {geometry::Point2D(minX, minY), geometry::Point2D(maxX, maxY)};
+        return {box.minPoint, box.maxPoint};
     }
 
     std::pair<geometry::Point2D, geometry::Point2D>
@@ -0,0 +1,553 @@
+#include "../include/DxfIO.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <variant>
+
+namespace contour
+{
+    namespace io
+    {
+        namespace
+        {
+            // Size of the tokenizer buffer and of the writer's output batches;
+            // DXF lines are at most 2049 characters
+            constexpr std::size_t BUFFER_BYTES = 64 * 1024;
+
+            // Largest arc angle accepted, in degrees either way of zero; real
+            // drawings stay within a turn or two
+            constexpr double MAX_ANGLE_DEGREES = 1e6;
+
+            std::string_view trim(std::string_view text)
+            {
+                while (!text.empty() && (text.back() == '\r' || text.back() == ' ' || text.back() == '\t'))
+                {
+                    text.remove_suffix(1);
+                }
+                while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+                {
+                    text.remove_prefix(1);
+                }
+                return text;
+            }
+
+            double normalizeDegrees(double degrees)
+            {
+                const double normalized = std::fmod(degrees, 360.0);
+                return normalized < 0.0 ? normalized + 360.0 : normalized;
+            }
+
+            // Group code and value on alternate lines, batched into large writes
+            class PairWriter
+            {
+            public:
+                explicit PairWriter(std::ostream& out)
+                    : m_out(out)
+                {
+                    m_text.reserve(BUFFER_BYTES + 64);
+                }
+
+                void pair(int code, std::string_view value)
+                {
+                    // Codes are right-aligned in three columns, as CAD programs write them
+                    if (code < 100)
+                    {
+                        m_text.append(code < 10 ? 2 : 1, ' ');
+                    }
+                    m_text += std::to_string(code);
+                    m_text += '\n';
+                    m_text += value;
+                    m_text += '\n';
+                    if (m_text.size() >= BUFFER_BYTES)
+                    {
+                        flush();
+                    }
+                }
+
+                void pair(int code, double value)
+                {
+                    // Shortest text that reads back as the same double
+                    char digits[32];
+                    const auto result = std::to_chars(digits, digits + sizeof digits, value);
+                    pair(code, std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+                }
+
+                void flush()
+                {
+                    m_out.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+                    if (!m_out)
+                    {
+                        throw std::runtime_error("writeDxf: write failed");
+                    }
+                    m_text.clear();
+                }
+
+            private:
+                std::ostream& m_out;
+                std::string m_text;
+            };
+        }
+
+        // DxfReader implementation
+        DxfReader::DxfReader(std::istream& in)
+            : m_in(in)
+            , m_buffer(BUFFER_BYTES)
+        {
+        }
+
+        void DxfReader::fail(const std::string& what, std::size_t line) const
+        {
+            throw std::runtime_error("DxfReader: line " + std::to_string(line != 0 ? line : m_lineNumber) + ": " + what);
+        }
+
+        bool DxfReader::readLine(std::string_view& line)
+        {
+            for (;;)
+            {
+                const char* start = m_buffer.data() + m_begin;
+                const char* newline = static_cast<const char*>(std::memchr(start, '\n', m_end - m_begin));
+                if (newline || (m_endOfFile && m_begin < m_end))
+                {
+                    const char* stop = newline ? newline : m_buffer.data() + m_end;
+                    m_begin = static_cast<std::size_t>(stop - m_buffer.data()) + (newline ? 1 : 0);
+                    ++m_lineNumber;
+                    line = trim(std::string_view(start, static_cast<std::size_t>(stop - start)));
+                    return true;
+                }
+                if (m_endOfFile)
+                {
+                    return false;
+                }
+
+                // Keep the partial line and refill the buffer behind it
+                if (m_begin == 0 && m_end == m_buffer.size())
+                {
+                    fail("line is too long", m_lineNumber + 1);
+                }
+                std::memmove(m_buffer.data(), start, m_end - m_begin);
+                m_end -= m_begin;
+                m_begin = 0;
+                m_in.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+                const std::size_t count = static_cast<std::size_t>(m_in.gcount());
+                if (count == 0)
+                {
+                    if (m_in.bad())
+                    {
+                        fail("read failed", m_lineNumber + 1);
+                    }
+                    m_endOfFile = true;
+                }
+                m_end += count;
+            }
+        }
+
+        bool DxfReader::nextPair()
+        {
+            std::string_view codeLine;
+            if (!readLine(codeLine))
+            {
+                return false;
+            }
+            const auto result = std::from_chars(codeLine.data(), codeLine.data() + codeLine.size(), m_code);
+            if (codeLine.empty() || result.ec != std::errc() || result.ptr != codeLine.data() + codeLine.size())
+            {
+                if (m_lineNumber == 1 && codeLine.substr(0, 18) == "AutoCAD Binary DXF")
+                {
+                    fail("binary DXF is not supported");
+                }
+                fail("expected a group code");
+            }
+            if (!readLine(m_value))
+            {
+                fail("unexpected end of file", m_lineNumber + 1);
+            }
+            return true;
+        }
+
+        double DxfReader::number() const
+        {
+            std::string_view text = m_value;
+            if (!text.empty() && text.front() == '+')
+            {
+                text.remove_prefix(1);
+            }
+            double value = 0.0;
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+            {
+                fail("expected a number");
+            }
+            if (!std::isfinite(value))
+            {
+                fail("number is not finite");
+            }
+            return value;
+        }
+
+        long DxfReader::integer() const
+        {
+            std::string_view text = m_value;
+            if (!text.empty() && text.front() == '+')
+            {
+                text.remove_prefix(1);
+            }
+            long value = 0;
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+            {
+                fail("expected an integer");
+            }
+            return value;
+        }
+
+        double DxfReader::angle() const
+        {
+            const double degrees = number();
+            if (std::fabs(degrees) > MAX_ANGLE_DEGREES)
+            {
+                fail("angle out of range");
+            }
+            return degrees;
+        }
+
+        bool DxfReader::findEntities()
+        {
+            bool sectionStart = false;
+            while (nextPair())
+            {
+                if (sectionStart && m_code == 2 && m_value == "ENTITIES")
+                {
+                    do
+                    {
+                        if (!nextPair())
+                        {
+                            fail("unexpected end of file in ENTITIES", m_lineNumber + 1);
+                        }
+                    } while (m_code != 0);
+                    return true;
+                }
+                sectionStart = m_code == 0 && m_value == "SECTION";
+            }
+            return false;
+        }
+
+        bool DxfReader::readEntity()
+        {
+            if (m_value == "ENDSEC" || m_value == "EOF")
+            {
+                return false;
+            }
+
+            enum class Kind { Line, Arc, Polyline, Other };
+            const Kind kind = m_value == "LINE" ? Kind::Line
+                : m_value == "ARC" ? Kind::Arc
+                : m_value == "LWPOLYLINE" ? Kind::Polyline : Kind::Other;
+            const std::size_t entityLine = m_lineNumber;
+
+            // Only the groups of supported entities are parsed; everything
+            // else is stepped over as raw text
+            geometry::Point2D first;
+            geometry::Point2D second;
+            double radius = 0.0;
+            double startAngle = 0.0;
+            double endAngle = 0.0;
+            double normalX = 0.0;
+            double normalY = 0.0;
+            double normalZ = 1.0;
+            bool closed = false;
+            m_vertices.clear();
+            m_bulges.clear();
+            for (;;)
+            {
+                if (!nextPair())
+                {
+                    fail("unexpected end of file in ENTITIES", m_lineNumber + 1);
+                }
+                if (m_code == 0)
+                {
+                    break;
+                }
+                if (kind == Kind::Other)
+                {
+                    continue;
+                }
+
+                switch (m_code)
+                {
+                case 10:
+                    if (kind == Kind::Polyline)
+                    {
+                        m_vertices.emplace_back(number(), 0.0);
+                        m_bulges.push_back(0.0);
+                    }
+                    else
+                    {
+                        first.x = number();
+                    }
+                    break;
+                case 20:
+                    if (kind == Kind::Polyline)
+                    {
+                        if (m_vertices.empty())
+                        {
+                            fail("vertex Y before its X");
+                        }
+                        m_vertices.back().y = number();
+                    }
+                    else
+                    {
+                        first.y = number();
+                    }
+                    break;
+                case 11:
+                    second.x = kind == Kind::Line ? number() : second.x;
+                    break;
+                case 21:
+                    second.y = kind == Kind::Line ? number() : second.y;
+                    break;
+                case 40:
+                    radius = kind == Kind::Arc ? number() : radius;
+                    if (kind == Kind::Arc && radius <= 0.0)
+                    {
+                        fail("arc radius must be positive");
+                    }
+                    break;
+                case 42:
+                    if (kind == Kind::Polyline)
+                    {
+                        if (m_vertices.empty())
+                        {
+                            fail("bulge before its vertex");
+                        }
+                        m_bulges.back() = number();
+                    }
+                    break;
+                case 50:
+                    startAngle = kind == Kind::Arc ? angle() : startAngle;
+                    break;
+                case 51:
+                    endAngle = kind == Kind::Arc ? angle() : endAngle;
+                    break;
+                case 70:
+                    closed = kind == Kind::Polyline ? (integer() & 1) != 0 : closed;
+                    break;
+                case 210:
+                    normalX = number();
+                    break;
+                case 220:
+                    normalY = number();
+                    break;
+                case 230:
+                    normalZ = number();
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // Arcs and polylines are drawn in the plane of their normal; only
+            // the XY plane seen from above or below maps onto the contour.
+            // Zero-length lines add nothing, like repeated polyline vertices
+            if (kind == Kind::Other
+                || (kind == Kind::Line && first.isEqual(second))
+                || (kind != Kind::Line && (std::fabs(normalX) > geometry::EPSILON || std::fabs(normalY) > geometry::EPSILON
+                                           || normalZ == 0.0)))
+            {
+                ++m_skippedCount;
+                return true;
+            }
+            const bool mirrored = normalZ < 0.0;
+
+            try
+            {
+                if (kind == Kind::Line)
+                {
+                    m_pending.emplace_back(LineSegment(first, second));
+                }
+                else if (kind == Kind::Arc)
+                {
+                    // Seen from below, a counter-clockwise arc runs clockwise
+                    // with its x axis reversed
+                    const double start = geometry::degreesToRadians(startAngle);
+                    const double end = geometry::degreesToRadians(endAngle);
+                    if (mirrored)
+                    {
+                        m_pending.emplace_back(ArcSegment(geometry::Point2D(-first.x, first.y), radius,
+                                                          geometry::PI - start, geometry::PI - end, true));
+                    }
+                    else
+                    {
+                        m_pending.emplace_back(ArcSegment(first, radius, start, end, false));
+                    }
+                }
+                else
+                {
+                    if (mirrored)
+                    {
+                        for (std::size_t i = 0; i < m_vertices.size(); ++i)
+                        {
+                            m_vertices[i].x = -m_vertices[i].x;
+                            m_bulges[i] = -m_bulges[i];
+                        }
+                    }
+                    const std::size_t count = m_vertices.size();
+                    const std::size_t edges = count < 2 ? 0 : closed ? count : count - 1;
+                    for (std::size_t i = 0; i < edges; ++i)
+                    {
+                        addPolylineEdge(m_vertices[i], m_vertices[(i + 1) % count], m_bulges[i]);
+                    }
+                }
+            }
+            catch (const std::invalid_argument& e)
+            {
+                fail(e.what(), entityLine);
+            }
+            ++m_entityCount;
+            return true;
+        }
+
+        void DxfReader::addPolylineEdge(const geometry::Point2D& start, const geometry::Point2D& end, double bulge)
+        {
+            // Repeated vertices add nothing, as in createPolylineContour
+            if (start.isEqual(end))
+            {
+                return;
+            }
+            if (bulge == 0.0)
+            {
+                m_pending.emplace_back(LineSegment(start, end));
+                return;
+            }
+
+            // The bulge is tan(sweep / 4), positive for counter-clockwise; the
+            // center lies off the chord midpoint along the chord's left normal
+            const double offset = (1.0 - bulge * bulge) / (4.0 * bulge);
+            const geometry::Point2D center((start.x + end.x) / 2.0 - (end.y - start.y) * offset,
+                                           (start.y + end.y) / 2.0 + (end.x - start.x) * offset);
+            m_pending.emplace_back(ArcSegment(center, center.distanceTo(start),
+                                              std::atan2(start.y - center.y, start.x - center.x),
+                                              std::atan2(end.y - center.y, end.x - center.x), bulge < 0.0));
+        }
+
+        std::size_t DxfReader::readSegments(std::vector<SegmentVariant>& block, std::size_t maxSegments)
+        {
+            block.clear();
+            while (block.size() < maxSegments)
+            {
+                if (m_nextPending < m_pending.size())
+                {
+                    block.push_back(std::move(m_pending[m_nextPending++]));
+                    continue;
+                }
+                m_pending.clear();
+                m_nextPending = 0;
+                if (m_finished)
+                {
+                    break;
+                }
+                if (!m_started)
+                {
+                    m_started = true;
+                    if (!findEntities())
+                    {
+                        fail("no ENTITIES section");
+                    }
+                }
+                m_finished = !readEntity();
+            }
+            return block.size();
+        }
+
+        Contour readDxf(std::istream& in, std::pmr::memory_resource* resource)
+        {
+            DxfReader reader(in);
+            Contour contour(resource);
+            std::vector<SegmentVariant> block;
+            while (reader.readSegments(block, 4096) > 0)
+            {
+                for (const SegmentVariant& segment : block)
+                {
+                    contour.addSegment(std::visit([resource](const auto& concrete) { return cloneSegment(concrete, resource); }, segment));
+                }
+            }
+            return contour;
+        }
+
+        Contour readDxf(const std::string& path, std::pmr::memory_resource* resource)
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                throw std::runtime_error("readDxf: cannot open " + path);
+            }
+            return readDxf(in, resource);
+        }
+
+        void writeDxf(std::ostream& out, const Contour& contour)
+        {
+            PairWriter writer(out);
+            writer.pair(0, "SECTION");
+            writer.pair(2, "ENTITIES");
+            for (const auto& segment : contour)
+            {
+                if (segment->getType() == SegmentType::Line)
+                {
+                    const geometry::Point2D start = segment->getStartPoint();
+                    const geometry::Point2D end = segment->getEndPoint();
+                    writer.pair(0, "LINE");
+                    writer.pair(8, "0");
+                    writer.pair(10, start.x);
+                    writer.pair(20, start.y);
+                    writer.pair(30, 0.0);
+                    writer.pair(11, end.x);
+                    writer.pair(21, end.y);
+                    writer.pair(31, 0.0);
+                    continue;
+                }
+
+                // DXF arcs run counter-clockwise, so a clockwise arc is written
+                // as seen from below the plane
+                const auto& arc = static_cast<const ArcSegment&>(*segment);
+                const bool clockwise = arc.isClockwise();
+                const double startAngle = geometry::radiansToDegrees(arc.getStartAngle());
+                const double endAngle = geometry::radiansToDegrees(arc.getEndAngle());
+                writer.pair(0, "ARC");
+                writer.pair(8, "0");
+                writer.pair(10, clockwise ? -arc.getCenter().x : arc.getCenter().x);
+                writer.pair(20, arc.getCenter().y);
+                writer.pair(30, 0.0);
+                writer.pair(40, arc.getRadius());
+                writer.pair(50, clockwise ? normalizeDegrees(180.0 - startAngle) : startAngle);
+                writer.pair(51, clockwise ? normalizeDegrees(180.0 - endAngle) : endAngle);
+                if (clockwise)
+                {
+                    writer.pair(210, 0.0);
+                    writer.pair(220, 0.0);
+                    writer.pair(230, -1.0);
+                }
+            }
+            writer.pair(0, "ENDSEC");
+            writer.pair(0, "EOF");
+            writer.flush();
+        }
+
+        void writeDxf(const std::string& path, const Contour& contour)
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                throw std::runtime_error("writeDxf: cannot open " + path);
+            }
+            writeDxf(out, contour);
+            out.close();
+            if (!out)
+            {
+                throw std::runtime_error("writeDxf: write failed for " + path);
+            }
+        }
+    }
+}
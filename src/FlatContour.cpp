@@ -0,0 +1,261 @@
+#include "../include/FlatContour.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace contour
+{
+    namespace
+    {
+        constexpr std::uint8_t LINE_TAG = static_cast<std::uint8_t>(SegmentType::Line);
+        constexpr std::uint8_t ARC_TAG = static_cast<std::uint8_t>(SegmentType::Arc);
+    }
+
+    FlatContour::FlatContour(const Contour& contour)
+    {
+        reserve(contour.size());
+        for (const auto& segment : contour)
+        {
+            addSegment(*segment);
+        }
+    }
+
+    void FlatContour::reserve(size_type segmentCount)
+    {
+        m_startX.reserve(segmentCount);
+        m_startY.reserve(segmentCount);
+        m_endX.reserve(segmentCount);
+        m_endY.reserve(segmentCount);
+        m_types.reserve(segmentCount);
+    }
+
+    void FlatContour::addLine(const geometry::Point2D& start, const geometry::Point2D& end)
+    {
+        if (start.isEqual(end))
+        {
+            throw std::invalid_argument("FlatContour::addLine: start and end points cannot be the same");
+        }
+        m_startX.push_back(start.x);
+        m_startY.push_back(start.y);
+        m_endX.push_back(end.x);
+        m_endY.push_back(end.y);
+        m_types.push_back(LINE_TAG);
+    }
+
+    void FlatContour::addArc(const geometry::Point2D& center, double radius,
+                             double startAngle, double endAngle, bool clockwise)
+    {
+        // ArcSegment validates the radius and normalizes the angles
+        ArcSegment arc(center, radius, startAngle, endAngle, clockwise);
+        auto start = arc.getStartPoint();
+        auto end = arc.getEndPoint();
+
+        m_arcs.centerX.push_back(center.x);
+        m_arcs.centerY.push_back(center.y);
+        m_arcs.radius.push_back(radius);
+        m_arcs.startAngle.push_back(arc.getStartAngle());
+        m_arcs.endAngle.push_back(arc.getEndAngle());
+        m_arcs.angleSpan.push_back(arc.getAngleSpan());
+        m_arcs.clockwise.push_back(clockwise ? 1 : 0);
+        m_arcs.segmentIndex.push_back(m_types.size());
+
+        m_startX.push_back(start.x);
+        m_startY.push_back(start.y);
+        m_endX.push_back(end.x);
+        m_endY.push_back(end.y);
+        m_types.push_back(ARC_TAG);
+    }
+
+    void FlatContour::addSegment(const Segment& segment)
+    {
+        switch (segment.getType())
+        {
+            case SegmentType::Line:
+                addLine(segment.getStartPoint(), segment.getEndPoint());
+                break;
+            case SegmentType::Arc:
+            {
+                const auto& arc = static_cast<const ArcSegment&>(segment);
+                addArc(arc.getCenter(), arc.getRadius(), arc.getStartAngle(), arc.getEndAngle(), arc.isClockwise());
+                break;
+            }
+        }
+    }
+
+    void FlatContour::clear()
+    {
+        m_startX.clear();
+        m_startY.clear();
+        m_endX.clear();
+        m_endY.clear();
+        m_types.clear();
+        m_arcs = ArcTable();
+    }
+
+    SegmentType FlatContour::typeAt(size_type index) const
+    {
+        if (index >= m_types.size())
+        {
+            throw std::out_of_range("FlatContour::typeAt: index out of range");
+        }
+        return static_cast<SegmentType>(m_types[index]);
+    }
+
+    Contour FlatContour::toContour() const
+    {
+        Contour::SegmentContainer segments;
+        segments.reserve(size());
+
+        size_type arc = 0;
+        for (size_type i = 0; i < size(); ++i)
+        {
+            if (m_types[i] == ARC_TAG)
+            {
+                segments.push_back(createArcSegment(
+                    geometry::Point2D(m_arcs.centerX[arc], m_arcs.centerY[arc]), m_arcs.radius[arc],
+                    m_arcs.startAngle[arc], m_arcs.endAngle[arc], m_arcs.clockwise[arc] != 0));
+                ++arc;
+            }
+            else
+            {
+                segments.push_back(createLineSegment(
+                    geometry::Point2D(m_startX[i], m_startY[i]), geometry::Point2D(m_endX[i], m_endY[i])));
+            }
+        }
+
+        return Contour(std::move(segments));
+    }
+
+    namespace kernels
+    {
+        using size_type = FlatContour::size_type;
+
+        double totalLength(const FlatContour& contour)
+        {
+            const size_type count = contour.size();
+            const double* sx = contour.startX();
+            const double* sy = contour.startY();
+            const double* ex = contour.endX();
+            const double* ey = contour.endY();
+            const std::uint8_t* types = contour.types();
+
+            // Branch-free over all segments: the chord is masked out for arcs
+            double lineLength = 0.0;
+            for (size_type i = 0; i < count; ++i)
+            {
+                const double dx = ex[i] - sx[i];
+                const double dy = ey[i] - sy[i];
+                const double isLine = (types[i] == LINE_TAG) ? 1.0 : 0.0;
+                lineLength += isLine * std::sqrt(dx * dx + dy * dy);
+            }
+
+            const auto& arcs = contour.arcs();
+            const size_type arcCount = contour.arcCount();
+            const double* radius = arcs.radius.data();
+            const double* span = arcs.angleSpan.data();
+
+            double arcLength = 0.0;
+            for (size_type i = 0; i < arcCount; ++i)
+            {
+                arcLength += radius[i] * span[i];
+            }
+
+            return lineLength + arcLength;
+        }
+
+        geometry::BoundingBox bounds(const FlatContour& contour)
+        {
+            const size_type count = contour.size();
+            if (count == 0)
+            {
+                return geometry::BoundingBox();
+            }
+
+            const double* sx = contour.startX();
+            const double* sy = contour.startY();
+            const double* ex = contour.endX();
+            const double* ey = contour.endY();
+
+            // Every segment's endpoints are on its boundary
+            double minX = sx[0], minY = sy[0], maxX = sx[0], maxY = sy[0];
+            for (size_type i = 0; i < count; ++i)
+            {
+                minX = std::min(minX, std::min(sx[i], ex[i]));
+                minY = std::min(minY, std::min(sy[i], ey[i]));
+                maxX = std::max(maxX, std::max(sx[i], ex[i]));
+                maxY = std::max(maxY, std::max(sy[i], ey[i]));
+            }
+
+            geometry::BoundingBox box(geometry::Point2D(minX, minY), geometry::Point2D(maxX, maxY));
+
+            // Arcs can also bulge past their endpoints at the axis crossings
+            const auto& arcs = contour.arcs();
+            for (size_type i = 0; i < contour.arcCount(); ++i)
+            {
+                expandByArcExtremes(box, geometry::Point2D(arcs.centerX[i], arcs.centerY[i]), arcs.radius[i],
+                                    arcs.startAngle[i], arcs.angleSpan[i], arcs.clockwise[i] != 0);
+            }
+
+            return box;
+        }
+
+        bool isValid(const FlatContour& contour, double epsilon)
+        {
+            const size_type count = contour.size();
+
+            // Same rules as Contour: empty is invalid, a single segment is valid
+            if (count == 0)
+            {
+                return false;
+            }
+            if (count == 1)
+            {
+                return true;
+            }
+            if (std::isnan(epsilon) || epsilon < 0)
+            {
+                return false;
+            }
+
+            const double* sx = contour.startX();
+            const double* sy = contour.startY();
+            const double* ex = contour.endX();
+            const double* ey = contour.endY();
+
+            // Accumulate without early exit so the loop stays vectorizable;
+            // the negated comparison also counts NaN joints as broken
+            unsigned broken = 0;
+            for (size_type i = 1; i < count; ++i)
+            {
+                const bool connected = std::abs(ex[i - 1] - sx[i]) < epsilon &&
+                                       std::abs(ey[i - 1] - sy[i]) < epsilon;
+                broken |= connected ? 0u : 1u;
+            }
+
+            return broken == 0;
+        }
+
+        void extractVertices(const FlatContour& contour, std::vector<geometry::Point2D>& out)
+        {
+            const size_type count = contour.size();
+            if (count == 0)
+            {
+                out.clear();
+                return;
+            }
+
+            out.resize(count + 1);
+            const double* ex = contour.endX();
+            const double* ey = contour.endY();
+
+            out[0] = geometry::Point2D(contour.startX()[0], contour.startY()[0]);
+            geometry::Point2D* vertices = out.data() + 1;
+            for (size_type i = 0; i < count; ++i)
+            {
+                vertices[i].x = ex[i];
+                vertices[i].y = ey[i];
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <cmath> // Required for std::sqrt and std::abs
 #include <limits> // Required for std::numeric_limits
+#include <algorithm> // Required for std::min and std::max
 
 namespace geometry
 {
@@ -106,6 +107,69 @@ namespace geometry
         return x * other.x + y * other.y;
     }
 
+    // BoundingBox implementation
+    BoundingBox::BoundingBox()
+        : minPoint(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
+          maxPoint(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity())
+    {
+    }
+
+    BoundingBox::BoundingBox(const Point2D& minPoint, const Point2D& maxPoint)
+        : minPoint(minPoint), maxPoint(maxPoint)
+    {
+    }
+
+    bool BoundingBox::isEmpty() const
+    {
+        // Also true for boxes holding NaN coordinates
+        return !(minPoint.x <= maxPoint.x && minPoint.y <= maxPoint.y);
+    }
+
+    double BoundingBox::width() const
+    {
+        return isEmpty() ? 0.0 : maxPoint.x - minPoint.x;
+    }
+
+    double BoundingBox::height() const
+    {
+        return isEmpty() ? 0.0 : maxPoint.y - minPoint.y;
+    }
+
+    Point2D BoundingBox::center() const
+    {
+        return Point2D((minPoint.x + maxPoint.x) * 0.5, (minPoint.y + maxPoint.y) * 0.5);
+    }
+
+    void BoundingBox::expand(const Point2D& point)
+    {
+        minPoint.x = std::min(minPoint.x, point.x);
+        minPoint.y = std::min(minPoint.y, point.y);
+        maxPoint.x = std::max(maxPoint.x, point.x);
+        maxPoint.y = std::max(maxPoint.y, point.y);
+    }
+
+    void BoundingBox::expand(const BoundingBox& other)
+    {
+        if (other.isEmpty())
+        {
+            return;
+        }
+        expand(other.minPoint);
+        expand(other.maxPoint);
+    }
+
+    bool BoundingBox::contains(const Point2D& point) const
+    {
+        return point.x >= minPoint.x && point.x <= maxPoint.x &&
+               point.y >= minPoint.y && point.y <= maxPoint.y;
+    }
+
+    bool BoundingBox::intersects(const BoundingBox& other) const
+    {
+        return minPoint.x <= other.maxPoint.x && other.minPoint.x <= maxPoint.x &&
+               minPoint.y <= other.maxPoint.y && other.minPoint.y <= maxPoint.y;
+    }
+
     // Global utility functions
     bool isEqual(double a, double b, double epsilon)
     {
@@ -0,0 +1,149 @@
+#include "../include/GridHash.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace contour
+{
+    namespace spatial
+    {
+        GridHash::GridHash(double cellSize)
+            : m_cellSize(1.0)
+        {
+            setCellSize(cellSize);
+        }
+
+        void GridHash::setCellSize(double cellSize)
+        {
+            if (!(cellSize > 0.0) || !std::isfinite(cellSize))
+            {
+                throw std::invalid_argument("GridHash::setCellSize: cell size must be positive and finite");
+            }
+            m_cellSize = cellSize;
+            clear();
+        }
+
+        void GridHash::insert(size_type item, const geometry::Point2D& point)
+        {
+            m_cells[pack(cellOf(point.x), cellOf(point.y))].push_back(item);
+        }
+
+        void GridHash::insert(size_type item, const geometry::BoundingBox& box)
+        {
+            if (box.isEmpty())
+            {
+                return;
+            }
+
+            std::int32_t minX, minY, maxX, maxY;
+            cellRange(box, minX, minY, maxX, maxY);
+            if (cellsSpanned(minX, minY, maxX, maxY) > MAX_ITEM_CELLS)
+            {
+                m_oversized.push_back(item);
+                return;
+            }
+            for (std::int32_t cx = minX; cx <= maxX; ++cx)
+            {
+                for (std::int32_t cy = minY; cy <= maxY; ++cy)
+                {
+                    m_cells[pack(cx, cy)].push_back(item);
+                }
+            }
+        }
+
+        void GridHash::erase(size_type item, const geometry::Point2D& point)
+        {
+            eraseFromCell(pack(cellOf(point.x), cellOf(point.y)), item);
+        }
+
+        void GridHash::erase(size_type item, const geometry::BoundingBox& box)
+        {
+            if (box.isEmpty())
+            {
+                return;
+            }
+
+            std::int32_t minX, minY, maxX, maxY;
+            cellRange(box, minX, minY, maxX, maxY);
+            if (cellsSpanned(minX, minY, maxX, maxY) > MAX_ITEM_CELLS)
+            {
+                auto found = std::find(m_oversized.begin(), m_oversized.end(), item);
+                if (found != m_oversized.end())
+                {
+                    *found = m_oversized.back();
+                    m_oversized.pop_back();
+                }
+                return;
+            }
+            for (std::int32_t cx = minX; cx <= maxX; ++cx)
+            {
+                for (std::int32_t cy = minY; cy <= maxY; ++cy)
+                {
+                    eraseFromCell(pack(cx, cy), item);
+                }
+            }
+        }
+
+        void GridHash::clear()
+        {
+            m_cells.clear();
+            m_oversized.clear();
+        }
+
+        std::int32_t GridHash::cellOf(double coordinate) const
+        {
+            // Clamp before converting so huge or non-finite coordinates land in the edge cells
+            const double cell = std::floor(coordinate / m_cellSize);
+            const double limit = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+            if (std::isnan(cell))
+            {
+                return 0;
+            }
+            return static_cast<std::int32_t>(std::clamp(cell, -limit, limit));
+        }
+
+        std::uint64_t GridHash::pack(std::int32_t cx, std::int32_t cy)
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32)
+                 | static_cast<std::uint64_t>(static_cast<std::uint32_t>(cy));
+        }
+
+        void GridHash::cellRange(const geometry::BoundingBox& box, std::int32_t& minX, std::int32_t& minY,
+                                 std::int32_t& maxX, std::int32_t& maxY) const
+        {
+            minX = cellOf(box.minPoint.x);
+            minY = cellOf(box.minPoint.y);
+            maxX = cellOf(box.maxPoint.x);
+            maxY = cellOf(box.maxPoint.y);
+        }
+
+        double GridHash::cellsSpanned(std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY)
+        {
+            // In double: a full-range product overflows 64 bits
+            return (static_cast<double>(maxX) - minX + 1.0) * (static_cast<double>(maxY) - minY + 1.0);
+        }
+
+        void GridHash::eraseFromCell(std::uint64_t cell, size_type item)
+        {
+            auto it = m_cells.find(cell);
+            if (it == m_cells.end())
+            {
+                return;
+            }
+
+            // Order within a cell carries no meaning, so swap-and-pop
+            std::vector<size_type>& items = it->second;
+            auto found = std::find(items.begin(), items.end(), item);
+            if (found != items.end())
+            {
+                *found = items.back();
+                items.pop_back();
+            }
+            if (items.empty())
+            {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
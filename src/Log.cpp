@@ -0,0 +1,246 @@
+#include "../include/Log.h"
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace contour
+{
+    namespace log
+    {
+        namespace detail
+        {
+#ifdef NDEBUG
+            std::atomic<int> g_level(static_cast<int>(Level::Info));
+#else
+            std::atomic<int> g_level(static_cast<int>(Level::Debug));
+#endif
+            std::atomic<std::uint32_t> g_categories(AllCategories);
+        }
+
+        namespace
+        {
+            void writeToClog(const Record& record)
+            {
+                std::clog << '[' << levelName(record.level) << "] ["
+                          << categoryName(record.category) << "] " << record.message << '\n';
+            }
+
+            // Single-consumer ring buffer drained by a worker thread that is
+            // started by the first record, so programs that never log never
+            // pay for the thread
+            class Logger
+            {
+            public:
+                static Logger& instance()
+                {
+                    static Logger logger;
+                    return logger;
+                }
+
+                ~Logger()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stopping = true;
+                    }
+                    m_wake.notify_all();
+                    if (m_worker.joinable())
+                    {
+                        m_worker.join();
+                    }
+                }
+
+                void push(Record record)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!m_worker.joinable())
+                        {
+                            m_ring.resize(RING_CAPACITY);
+                            m_worker = std::thread(&Logger::run, this);
+                        }
+                        if (m_count == RING_CAPACITY)
+                        {
+                            // Overwrite the oldest record; it counts as delivered for flush()
+                            m_head = (m_head + 1) % RING_CAPACITY;
+                            --m_count;
+                            ++m_dropped;
+                            ++m_delivered;
+                        }
+                        m_ring[(m_head + m_count) % RING_CAPACITY] = std::move(record);
+                        ++m_count;
+                        ++m_queued;
+                    }
+                    m_wake.notify_one();
+                }
+
+                void flush()
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    const std::size_t target = m_queued;
+                    m_drained.wait(lock, [this, target] { return m_delivered >= target; });
+                }
+
+                void setSink(Sink sink)
+                {
+                    std::lock_guard<std::mutex> lock(m_sinkMutex);
+                    m_sink = std::move(sink);
+                }
+
+                std::size_t droppedCount()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_dropped;
+                }
+
+            private:
+                static constexpr std::size_t RING_CAPACITY = 4096;
+
+                Logger() = default;
+
+                void run()
+                {
+                    std::vector<Record> batch;
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    for (;;)
+                    {
+                        m_wake.wait(lock, [this] { return m_stopping || m_count > 0; });
+                        if (m_count == 0)
+                        {
+                            break;
+                        }
+
+                        batch.clear();
+                        while (m_count > 0)
+                        {
+                            batch.push_back(std::move(m_ring[m_head]));
+                            m_head = (m_head + 1) % RING_CAPACITY;
+                            --m_count;
+                        }
+                        lock.unlock();
+                        deliver(batch);
+                        lock.lock();
+
+                        m_delivered += batch.size();
+                        m_drained.notify_all();
+                    }
+                }
+
+                void deliver(const std::vector<Record>& batch)
+                {
+                    std::lock_guard<std::mutex> lock(m_sinkMutex);
+                    for (const Record& record : batch)
+                    {
+                        // A throwing sink loses its record, not the logger
+                        try
+                        {
+                            if (m_sink)
+                            {
+                                m_sink(record);
+                            }
+                            else
+                            {
+                                writeToClog(record);
+                            }
+                        }
+                        catch (...)
+                        {
+                        }
+                    }
+                    if (!m_sink)
+                    {
+                        std::clog.flush();
+                    }
+                }
+
+                std::mutex m_mutex;
+                std::condition_variable m_wake;
+                std::condition_variable m_drained;
+                std::vector<Record> m_ring;
+                std::size_t m_head = 0;
+                std::size_t m_count = 0;
+                std::size_t m_queued = 0;
+                std::size_t m_delivered = 0;
+                std::size_t m_dropped = 0;
+                bool m_stopping = false;
+                std::thread m_worker;
+
+                std::mutex m_sinkMutex;
+                Sink m_sink;
+            };
+        }
+
+        void setLevel(Level level)
+        {
+            detail::g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+
+        Level getLevel()
+        {
+            return static_cast<Level>(detail::g_level.load(std::memory_order_relaxed));
+        }
+
+        void setCategories(std::uint32_t mask)
+        {
+            detail::g_categories.store(mask, std::memory_order_relaxed);
+        }
+
+        std::uint32_t getCategories()
+        {
+            return detail::g_categories.load(std::memory_order_relaxed);
+        }
+
+        void write(Level level, std::uint32_t category, std::string message)
+        {
+            if (level == Level::Off)
+            {
+                return;
+            }
+            Logger::instance().push(Record{ level, category, std::chrono::system_clock::now(), std::move(message) });
+        }
+
+        void setSink(Sink sink)
+        {
+            Logger::instance().setSink(std::move(sink));
+        }
+
+        void flush()
+        {
+            Logger::instance().flush();
+        }
+
+        std::size_t getDroppedCount()
+        {
+            return Logger::instance().droppedCount();
+        }
+
+        const char* levelName(Level level)
+        {
+            switch (level)
+            {
+            case Level::Trace: return "TRACE";
+            case Level::Debug: return "DEBUG";
+            case Level::Info: return "INFO";
+            case Level::Warning: return "WARNING";
+            case Level::Error: return "ERROR";
+            case Level::Off: return "OFF";
+            }
+            return "UNKNOWN";
+        }
+
+        const char* categoryName(std::uint32_t category)
+        {
+            switch (category)
+            {
+            case Core: return "core";
+            case Scene: return "scene";
+            case Input: return "input";
+            case Render: return "render";
+            default: return "general";
+            }
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include "../include/MainWindow.h"
 #include "../include/ContourScene.h"
+#include "../include/ContourIO.h"
+#include "../include/DxfIO.h"
 #include <QApplication>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -16,6 +18,7 @@
 #include <QStyle>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QColorDialog>
 #include <QSignalBlocker>
 #include <QGroupBox>
@@ -28,6 +31,15 @@
 #include <math.h>
 #include "Segment.h"
 
+namespace
+{
+    // DXF drawings are picked by their suffix; everything else is .cnt
+    bool isDxfFile(const QString& fileName)
+    {
+        return QFileInfo(fileName).suffix().compare("dxf", Qt::CaseInsensitive) == 0;
+    }
+}
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_scene(nullptr)
@@ -60,6 +72,7 @@ MainWindow::MainWindow(QWidget* parent)
     , m_clearAction(nullptr)
     , m_gridAction(nullptr)
     , m_snapAction(nullptr)
+    , m_batchedRenderingAction(nullptr)
     , m_aboutAction(nullptr)
 {
     setupUI();
@@ -224,6 +237,11 @@ void MainWindow::createActions()
     m_snapAction->setChecked(true);
     m_snapAction->setStatusTip("Snap drawing to grid");
     
+    m_batchedRenderingAction = new QAction("&Batched Rendering", this);
+    m_batchedRenderingAction->setCheckable(true);
+    m_batchedRenderingAction->setChecked(false);
+    m_batchedRenderingAction->setStatusTip("Paint the whole contour as one item");
+    
     // Help actions
     m_aboutAction = new QAction("&About", this);
     m_aboutAction->setStatusTip("About ContourSegment");
@@ -251,6 +269,7 @@ void MainWindow::setupMenuBar()
     QMenu* viewMenu = menuBar()->addMenu("&View");
     viewMenu->addAction(m_gridAction);
     viewMenu->addAction(m_snapAction);
+    viewMenu->addAction(m_batchedRenderingAction);
     
     // Help menu
     QMenu* helpMenu = menuBar()->addMenu("&Help");
@@ -409,10 +428,12 @@ void MainWindow::connectSignals()
     connect(m_clearAction, &QAction::triggered, this, &MainWindow::onClearContour);
     connect(m_gridAction, &QAction::triggered, this, &MainWindow::onToggleGrid);
     connect(m_snapAction, &QAction::triggered, this, &MainWindow::onToggleSnap);
+    connect(m_batchedRenderingAction, &QAction::triggered, this, &MainWindow::onToggleBatchedRendering);
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
     
     // Connect scene signals
     connect(m_scene, &ContourScene::contourModified, this, &MainWindow::onContourModified);
+    connect(m_scene, &ContourScene::segmentPicked, this, &MainWindow::onSegmentPicked);
     
     connect(m_addSegmentButton, &QPushButton::clicked, this, &MainWindow::onAddSegmentClicked);
     connect(m_insertSegmentButton, &QPushButton::clicked, this, &MainWindow::onInsertSegmentClicked);
@@ -469,23 +490,47 @@ void MainWindow::onOpenContour()
 {
     QString fileName = QFileDialog::getOpenFileName(this, "Open Contour File", 
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
-        "Contour Files (*.cnt);;All Files (*)");
+        "Contour Files (*.cnt *.dxf);;DXF Drawings (*.dxf);;All Files (*)");
     
-    if (!fileName.isEmpty()) {
-        // TODO: Implement file loading
-        m_statusBar->showMessage("File opened: " + fileName, 2000);
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    try {
+        const std::string path = fileName.toLocal8Bit().toStdString();
+        contour::Contour contour = isDxfFile(fileName) ? contour::io::readDxf(path) : contour::io::readContour(path);
+        m_scene->setContour(contour);
+        updateSegmentManagementPanel();
+        m_statusBar->showMessage(QString("File opened: %1 (%2 segments)").arg(fileName).arg(contour.size()), 2000);
+    } catch (const std::exception& e) {
+        QMessageBox::warning(this, "Open Failed", QString("Could not open %1:\n%2").arg(fileName, QString::fromUtf8(e.what())));
     }
 }
 
 void MainWindow::onSaveContour()
 {
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this, "Save Contour File", 
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
-        "Contour Files (*.cnt);;All Files (*)");
+        "Contour Files (*.cnt);;DXF Drawings (*.dxf);;All Files (*)", &selectedFilter);
+    
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (QFileInfo(fileName).suffix().isEmpty()) {
+        fileName += selectedFilter.contains("*.dxf") ? ".dxf" : ".cnt";
+    }
     
-    if (!fileName.isEmpty()) {
-        // TODO: Implement file saving
+    try {
+        const std::string path = fileName.toLocal8Bit().toStdString();
+        if (isDxfFile(fileName)) {
+            contour::io::writeDxf(path, m_scene->getContour());
+        } else {
+            contour::io::writeContour(path, m_scene->getContour());
+        }
         m_statusBar->showMessage("File saved: " + fileName, 2000);
+    } catch (const std::exception& e) {
+        QMessageBox::warning(this, "Save Failed", QString("Could not save %1:\n%2").arg(fileName, QString::fromUtf8(e.what())));
     }
 }
 
@@ -502,6 +547,13 @@ void MainWindow::onToggleGrid()
     m_statusBar->showMessage(m_gridAction->isChecked() ? "Grid shown" : "Grid hidden", 1000);
 }
 
+void MainWindow::onToggleBatchedRendering()
+{
+    const bool batched = m_batchedRenderingAction->isChecked();
+    m_scene->setRenderBackend(batched ? RenderBackend::Batched : RenderBackend::Items);
+    m_statusBar->showMessage(batched ? "Batched rendering enabled" : "Batched rendering disabled", 1000);
+}
+
 void MainWindow::onToggleSnap()
 {
     m_scene->setSnapToGrid(m_snapAction->isChecked());
@@ -622,7 +674,17 @@ void MainWindow::updateValidationStatus()
             m_validationStatusLabel->setStyleSheet("QLabel { color: #ffff00; }"); // Yellow
         }
     } else {
-        status = "Invalid";
+        // Point straight at the gaps instead of just flagging the contour
+        const auto& gaps = m_scene->getDisconnectedJoints();
+        if (gaps.empty()) {
+            status = "Invalid";
+        } else {
+            status = QString("Invalid (%1 gap%2, first between segments %3 and %4)")
+                         .arg(gaps.size())
+                         .arg(gaps.size() == 1 ? "" : "s")
+                         .arg(gaps.front() + 1)
+                         .arg(gaps.front() + 2);
+        }
         m_validationStatusLabel->setStyleSheet("QLabel { color: #ff0000; }"); // Red
     }
     
@@ -634,6 +696,13 @@ void MainWindow::onSegmentSelectChanged(int index) {
     updateButtonStates();
 }
 
+void MainWindow::onSegmentPicked(size_t segmentIndex) {
+    // Selecting in the combo fills the form through onSegmentSelectChanged
+    if (segmentIndex < (size_t)m_segmentSelectCombo->count()) {
+        m_segmentSelectCombo->setCurrentIndex((int)segmentIndex);
+    }
+}
+
 void MainWindow::onUpdateSegmentClicked() {
     int idx = m_segmentSelectCombo->currentIndex();
     
@@ -644,7 +713,7 @@ void MainWindow::onUpdateSegmentClicked() {
     
     // Check segment type compatibility
     auto& contour = m_scene->getContour();
-    auto& seg = contour[idx];
+    const auto& seg = contour[idx];
     
     if (seg.getType() == contour::SegmentType::Line && m_segmentTypeCombo->currentIndex() == 0) {
         bool ok1, ok2, ok3, ok4;
@@ -0,0 +1,426 @@
+#include "../include/MappedContour.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace contour
+{
+    namespace io
+    {
+        // MappedFile implementation
+#ifdef _WIN32
+        MappedFile::MappedFile(const std::string& path)
+        {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("MappedFile: cannot open " + path);
+            }
+            m_file = file;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                release();
+                throw std::runtime_error("MappedFile: cannot read the size of " + path);
+            }
+            m_size = static_cast<std::size_t>(size.QuadPart);
+            if (m_size == 0)
+            {
+                return; // an empty file cannot be mapped, and has nothing to read
+            }
+
+            m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping)
+            {
+                release();
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+            m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!m_data)
+            {
+                release();
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+        }
+
+        void MappedFile::release() noexcept
+        {
+            if (m_data)
+            {
+                UnmapViewOfFile(m_data);
+            }
+            if (m_mapping)
+            {
+                CloseHandle(m_mapping);
+            }
+            if (m_file)
+            {
+                CloseHandle(m_file);
+            }
+            m_data = nullptr;
+            m_size = 0;
+            m_mapping = nullptr;
+            m_file = nullptr;
+        }
+
+        MappedFile::MappedFile(MappedFile&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+            , m_file(std::exchange(other.m_file, nullptr))
+            , m_mapping(std::exchange(other.m_mapping, nullptr))
+        {
+        }
+
+        MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+                m_file = std::exchange(other.m_file, nullptr);
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+            }
+            return *this;
+        }
+#else
+        MappedFile::MappedFile(const std::string& path)
+        {
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            if (descriptor < 0)
+            {
+                throw std::runtime_error("MappedFile: cannot open " + path);
+            }
+
+            struct stat status;
+            if (::fstat(descriptor, &status) != 0)
+            {
+                ::close(descriptor);
+                throw std::runtime_error("MappedFile: cannot read the size of " + path);
+            }
+            m_size = static_cast<std::size_t>(status.st_size);
+            if (m_size > 0)
+            {
+                void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (data == MAP_FAILED)
+                {
+                    ::close(descriptor);
+                    throw std::runtime_error("MappedFile: cannot map " + path);
+                }
+                m_data = static_cast<const unsigned char*>(data);
+            }
+            // The mapping keeps the file alive on its own
+            ::close(descriptor);
+        }
+
+        void MappedFile::release() noexcept
+        {
+            if (m_data)
+            {
+                ::munmap(const_cast<unsigned char*>(m_data), m_size);
+            }
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        MappedFile::MappedFile(MappedFile&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+        {
+        }
+
+        MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+#endif
+
+        MappedFile::~MappedFile()
+        {
+            release();
+        }
+
+        // MappedContour implementation
+        MappedContour::Record MappedContour::recordAt(const unsigned char* start, const unsigned char* limit)
+        {
+            if (static_cast<std::size_t>(limit - start) < CNT_HEADER_SIZE)
+            {
+                throw std::runtime_error("MappedContour: unexpected end of file");
+            }
+            unsigned char headerBytes[CNT_HEADER_SIZE];
+            std::copy(start, start + CNT_HEADER_SIZE, headerBytes);
+            const CntHeader header = parseHeader(headerBytes, "MappedContour");
+            if ((header.flags & CNT_FLAG_COMPRESSED) != 0)
+            {
+                throw std::runtime_error("MappedContour: compressed records must be read with readContour");
+            }
+
+            // Only sizes are checked here; tags are validated as they are decoded
+            const std::uint64_t available = static_cast<std::uint64_t>(limit - start) - CNT_HEADER_SIZE;
+            const std::uint64_t tagBytes = tagColumnSize(header.segmentCount);
+            if (tagBytes < header.segmentCount || tagBytes > available
+                || header.payloadSize > available - tagBytes || header.payloadSize % sizeof(double) != 0)
+            {
+                throw std::runtime_error("MappedContour: unexpected end of file");
+            }
+
+            Record record;
+            record.tags = start + CNT_HEADER_SIZE;
+            record.tagsEnd = record.tags + header.segmentCount;
+            record.payload = record.tags + tagBytes;
+            record.payloadEnd = record.payload + header.payloadSize;
+            record.next = (header.flags & CNT_FLAG_CONTINUED) != 0 ? record.payloadEnd : nullptr;
+            return record;
+        }
+
+        MappedContour::MappedContour(const MappedFile& file, std::size_t offset)
+        {
+            if (offset > file.size())
+            {
+                throw std::runtime_error("MappedContour: unexpected end of file");
+            }
+            m_limit = file.data() + file.size();
+            m_first = recordAt(file.data() + offset, m_limit);
+
+            // Walk the headers of continued records for the size and the end
+            Record record = m_first;
+            m_size = static_cast<size_type>(record.tagsEnd - record.tags);
+            while (record.next)
+            {
+                record = recordAt(record.next, m_limit);
+                m_size += static_cast<size_type>(record.tagsEnd - record.tags);
+            }
+            m_lastTagsEnd = record.tagsEnd;
+            m_endOffset = static_cast<std::size_t>(record.payloadEnd - file.data());
+        }
+
+        MappedContour::const_iterator MappedContour::begin() const
+        {
+            return const_iterator(m_first, m_limit);
+        }
+
+        MappedContour::const_iterator MappedContour::end() const
+        {
+            return const_iterator(m_lastTagsEnd);
+        }
+
+        MappedContour::const_iterator::const_iterator(const Record& record, const unsigned char* limit)
+            : m_tag(record.tags)
+            , m_tagsEnd(record.tagsEnd)
+            , m_values(record.payload)
+            , m_valuesEnd(record.payloadEnd)
+            , m_next(record.next)
+            , m_limit(limit)
+        {
+            skipFinishedRecords();
+        }
+
+        void MappedContour::const_iterator::skipFinishedRecords()
+        {
+            while (m_tag == m_tagsEnd && m_next)
+            {
+                const Record record = recordAt(m_next, m_limit);
+                m_tag = record.tags;
+                m_tagsEnd = record.tagsEnd;
+                m_values = record.payload;
+                m_valuesEnd = record.payloadEnd;
+                m_next = record.next;
+            }
+        }
+
+        SegmentVariant MappedContour::const_iterator::operator*() const
+        {
+            const std::size_t doubles = doublesForTag(*m_tag);
+            if (doubles == 0)
+            {
+                throw std::runtime_error("MappedContour: unknown segment tag " + std::to_string(*m_tag));
+            }
+            if (static_cast<std::size_t>(m_valuesEnd - m_values) < doubles * sizeof(double))
+            {
+                throw std::runtime_error("MappedContour: payload shorter than the segment tags");
+            }
+
+            double values[ARC_DOUBLES];
+            for (std::size_t k = 0; k < doubles; ++k)
+            {
+                values[k] = detail::loadDouble(m_values + k * sizeof(double));
+            }
+            if (const char* problem = invalidSegmentValues(*m_tag, values))
+            {
+                throw std::runtime_error(std::string("MappedContour: ") + problem);
+            }
+            try
+            {
+                if (*m_tag == static_cast<unsigned char>(SegmentTag::Line))
+                {
+                    return LineSegment(geometry::Point2D(values[0], values[1]), geometry::Point2D(values[2], values[3]));
+                }
+                const bool clockwise = *m_tag == static_cast<unsigned char>(SegmentTag::ArcClockwise);
+                return ArcSegment(geometry::Point2D(values[0], values[1]), values[2], values[3], values[4], clockwise);
+            }
+            catch (const std::invalid_argument& e)
+            {
+                throw std::runtime_error(std::string("MappedContour: ") + e.what());
+            }
+        }
+
+        MappedContour::const_iterator& MappedContour::const_iterator::operator++()
+        {
+            const std::size_t doubles = doublesForTag(*m_tag);
+            if (doubles == 0)
+            {
+                throw std::runtime_error("MappedContour: unknown segment tag " + std::to_string(*m_tag));
+            }
+            ++m_tag;
+            m_values += std::min<std::size_t>(doubles * sizeof(double), static_cast<std::size_t>(m_valuesEnd - m_values));
+            skipFinishedRecords();
+            return *this;
+        }
+
+        double MappedContour::getTotalLength() const
+        {
+            double total = 0.0;
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                total += std::visit([](const auto& segment) { return segment.getLength(); }, *it);
+            }
+            return total;
+        }
+
+        bool MappedContour::isValid(double epsilon) const
+        {
+            if (empty())
+            {
+                return false;
+            }
+            if (size() == 1)
+            {
+                return true;
+            }
+            if (std::isnan(epsilon) || epsilon < 0)
+            {
+                return false;
+            }
+
+            // Same joint metric as Contour::getMaxJointGap
+            bool first = true;
+            geometry::Point2D previousEnd;
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                const SegmentVariant segment = *it;
+                const geometry::Point2D start = std::visit([](const auto& s) { return s.getStartPoint(); }, segment);
+                if (!first)
+                {
+                    const double gap = std::max(std::abs(previousEnd.x - start.x), std::abs(previousEnd.y - start.y));
+                    if (!(gap < epsilon))
+                    {
+                        return false;
+                    }
+                }
+                previousEnd = std::visit([](const auto& s) { return s.getEndPoint(); }, segment);
+                first = false;
+            }
+            return true;
+        }
+
+        bool MappedContour::isClosed(double epsilon) const
+        {
+            if (empty())
+            {
+                return false;
+            }
+
+            geometry::Point2D firstStart;
+            geometry::Point2D lastEnd;
+            bool first = true;
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                const SegmentVariant segment = *it;
+                if (first)
+                {
+                    firstStart = std::visit([](const auto& s) { return s.getStartPoint(); }, segment);
+                    first = false;
+                }
+                lastEnd = std::visit([](const auto& s) { return s.getEndPoint(); }, segment);
+            }
+            return firstStart.isEqual(lastEnd, epsilon);
+        }
+
+        std::vector<geometry::Point2D> MappedContour::getVertices() const
+        {
+            std::vector<geometry::Point2D> vertices;
+            if (empty())
+            {
+                return vertices;
+            }
+
+            vertices.reserve(size() + 1);
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                const SegmentVariant segment = *it;
+                if (vertices.empty())
+                {
+                    vertices.push_back(std::visit([](const auto& s) { return s.getStartPoint(); }, segment));
+                }
+                vertices.push_back(std::visit([](const auto& s) { return s.getEndPoint(); }, segment));
+            }
+            return vertices;
+        }
+
+        geometry::BoundingBox MappedContour::getBoundingBox() const
+        {
+            geometry::BoundingBox box;
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                box.expand(std::visit([](const auto& segment) { return segment.getBoundingBox(); }, *it));
+            }
+            return box;
+        }
+
+        Contour MappedContour::toContour(std::pmr::memory_resource* resource) const
+        {
+            Contour contour(resource);
+            contour.reserve(size());
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                const SegmentVariant segment = *it;
+                if (const auto* line = std::get_if<LineSegment>(&segment))
+                {
+                    contour.addSegment(createLineSegment(line->getStartPoint(), line->getEndPoint(), resource));
+                }
+                else
+                {
+                    const auto& arc = std::get<ArcSegment>(segment);
+                    contour.addSegment(createArcSegment(arc.getCenter(), arc.getRadius(), arc.getStartAngle(),
+                                                        arc.getEndAngle(), arc.isClockwise(), resource));
+                }
+            }
+            return contour;
+        }
+    }
+}
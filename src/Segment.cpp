@@ -1,8 +1,12 @@
 #include "../include/Segment.h"
+#include "../include/Log.h"
 #include <stdexcept>
 #include <cmath>
 #include <limits> // Added for std::numeric_limits
-#include <iostream> // Added for std::cerr
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <variant>
 
 namespace contour
 {
@@ -17,7 +21,7 @@ namespace contour
         try {
             return getEndPoint().isEqual(other.getStartPoint(), epsilon);
         } catch (const std::exception& e) {
-            std::cerr << "Error in isConnectedTo: " << e.what() << std::endl;
+            CONTOUR_ERROR(log::Core, "Error in isConnectedTo: " << e.what());
             return false;
         }
     }
@@ -84,15 +88,19 @@ namespace contour
         }
 
         try {
-            const auto& otherLine = dynamic_cast<const LineSegment&>(other);
-            return m_start.isEqual(otherLine.m_start, epsilon) && 
-                   m_end.isEqual(otherLine.m_end, epsilon);
+            return isEqual(dynamic_cast<const LineSegment&>(other), epsilon);
         } catch (const std::bad_cast& e) {
-            std::cerr << "Failed to cast to LineSegment: " << e.what() << std::endl;
+            CONTOUR_ERROR(log::Core, "Failed to cast to LineSegment: " << e.what());
             return false;
         }
     }
 
+    bool LineSegment::isEqual(const LineSegment& other, double epsilon) const
+    {
+        return m_start.isEqual(other.m_start, epsilon) && 
+               m_end.isEqual(other.m_end, epsilon);
+    }
+
     geometry::Vector2D LineSegment::getDirection() const
     {
         // Validate points
@@ -129,6 +137,36 @@ namespace contour
         return m_start + (m_end - m_start) * t;
     }
 
+    geometry::Vector2D LineSegment::getTangentAt(double t) const
+    {
+        if (t < 0.0 || t > 1.0)
+        {
+            throw std::invalid_argument("LineSegment::getTangentAt: t must be in range [0,1]");
+        }
+        return getDirection();
+    }
+
+    geometry::BoundingBox LineSegment::getBoundingBox() const
+    {
+        geometry::BoundingBox box;
+        box.expand(m_start);
+        box.expand(m_end);
+        return box;
+    }
+
+    double LineSegment::distanceTo(const geometry::Point2D& point) const
+    {
+        // Project onto the line and clamp to the segment
+        const geometry::Vector2D direction = m_end - m_start;
+        const double lengthSquared = direction.dot(direction);
+        if (!(lengthSquared > 0.0))
+        {
+            return m_start.distanceTo(point);
+        }
+        const double t = std::clamp((point - m_start).dot(direction) / lengthSquared, 0.0, 1.0);
+        return (m_start + direction * t).distanceTo(point);
+    }
+
     // ArcSegment implementation
     ArcSegment::ArcSegment(const geometry::Point2D& center, double radius, 
                            double startAngle, double endAngle, bool clockwise)
@@ -210,18 +248,22 @@ namespace contour
         }
 
         try {
-            const auto& otherArc = dynamic_cast<const ArcSegment&>(other);
-            return m_center.isEqual(otherArc.m_center, epsilon) &&
-                   geometry::isEqual(m_radius, otherArc.m_radius, epsilon) &&
-                   geometry::isEqual(m_startAngle, otherArc.m_startAngle, epsilon) &&
-                   geometry::isEqual(m_endAngle, otherArc.m_endAngle, epsilon) &&
-                   m_clockwise == otherArc.m_clockwise;
+            return isEqual(dynamic_cast<const ArcSegment&>(other), epsilon);
         } catch (const std::bad_cast& e) {
-            std::cerr << "Failed to cast to ArcSegment: " << e.what() << std::endl;
+            CONTOUR_ERROR(log::Core, "Failed to cast to ArcSegment: " << e.what());
             return false;
         }
     }
 
+    bool ArcSegment::isEqual(const ArcSegment& other, double epsilon) const
+    {
+        return m_center.isEqual(other.m_center, epsilon) &&
+               geometry::isEqual(m_radius, other.m_radius, epsilon) &&
+               geometry::isEqual(m_startAngle, other.m_startAngle, epsilon) &&
+               geometry::isEqual(m_endAngle, other.m_endAngle, epsilon) &&
+               m_clockwise == other.m_clockwise;
+    }
+
     double ArcSegment::getAngleSpan() const
     {
         // Validate angles
@@ -276,6 +318,58 @@ namespace contour
                                    std::numeric_limits<double>::quiet_NaN());
         }
 
+        return pointFromAngle(angleAt(t));
+    }
+
+    geometry::Vector2D ArcSegment::getTangentAt(double t) const
+    {
+        if (t < 0.0 || t > 1.0)
+        {
+            throw std::invalid_argument("ArcSegment::getTangentAt: t must be in range [0,1]");
+        }
+
+        double angle = angleAt(t);
+        if (std::isnan(angle)) {
+            return geometry::Vector2D(std::numeric_limits<double>::quiet_NaN(), 
+                                    std::numeric_limits<double>::quiet_NaN());
+        }
+
+        // Perpendicular to the radius, turned in the direction of travel
+        double cosAngle = std::cos(angle);
+        double sinAngle = std::sin(angle);
+        return m_clockwise ? geometry::Vector2D(sinAngle, -cosAngle)
+                           : geometry::Vector2D(-sinAngle, cosAngle);
+    }
+
+    geometry::BoundingBox ArcSegment::getBoundingBox() const
+    {
+        // Endpoints bound the arc except where it crosses an axis direction
+        geometry::BoundingBox box;
+        box.expand(getStartPoint());
+        box.expand(getEndPoint());
+        expandByArcExtremes(box, m_center, m_radius, m_startAngle, getAngleSpan(), m_clockwise);
+        return box;
+    }
+
+    double ArcSegment::distanceTo(const geometry::Point2D& point) const
+    {
+        // Inside the sweep the closest point is radial, otherwise it is an endpoint
+        const double angle = std::atan2(point.y - m_center.y, point.x - m_center.x);
+        double offset = m_clockwise ? m_startAngle - angle : angle - m_startAngle;
+        offset = std::fmod(offset, 2.0 * geometry::PI);
+        if (offset < 0.0)
+        {
+            offset += 2.0 * geometry::PI;
+        }
+        if (offset <= getAngleSpan())
+        {
+            return std::abs(m_center.distanceTo(point) - m_radius);
+        }
+        return std::min(getStartPoint().distanceTo(point), getEndPoint().distanceTo(point));
+    }
+
+    double ArcSegment::angleAt(double t) const
+    {
         double angle;
         if (m_clockwise)
         {
@@ -286,7 +380,7 @@ namespace contour
             angle = m_startAngle + t * getAngleSpan();
         }
         
-        return pointFromAngle(normalizeAngle(angle));
+        return normalizeAngle(angle);
     }
 
     geometry::Point2D ArcSegment::pointFromAngle(double angle) const
@@ -320,18 +414,98 @@ namespace contour
             return std::numeric_limits<double>::quiet_NaN();
         }
         
-        while (angle < 0.0)
+        // fmod is exact and bounded, so huge or infinite angles cannot
+        // stall the way repeated subtraction did; infinity gives NaN
+        angle = std::fmod(angle, 2.0 * geometry::PI);
+        if (angle < 0.0)
         {
             angle += 2.0 * geometry::PI;
         }
-        while (angle >= 2.0 * geometry::PI)
+        if (angle >= 2.0 * geometry::PI)
         {
+            // A tiny negative angle rounds up to 2*PI above
             angle -= 2.0 * geometry::PI;
         }
         return angle;
     }
 
     // Factory functions
+    namespace
+    {
+        template<typename T, typename... Args>
+        SegmentPtr makeSegment(std::pmr::memory_resource* resource, Args&&... args)
+        {
+            if (!resource)
+            {
+                return SegmentPtr(new T(std::forward<Args>(args)...));
+            }
+
+            void* memory = resource->allocate(sizeof(T), alignof(T));
+            try
+            {
+                return SegmentPtr(new (memory) T(std::forward<Args>(args)...), SegmentDeleter(resource));
+            }
+            catch (...)
+            {
+                resource->deallocate(memory, sizeof(T), alignof(T));
+                throw;
+            }
+        }
+
+        template<typename T>
+        void destroySegment(std::pmr::memory_resource* resource, Segment* segment)
+        {
+            T* concrete = static_cast<T*>(segment);
+            concrete->~T();
+            resource->deallocate(concrete, sizeof(T), alignof(T));
+        }
+    }
+
+    void SegmentDeleter::operator()(Segment* segment) const
+    {
+        if (!resource)
+        {
+            delete segment;
+            return;
+        }
+
+        // The resource needs the allocation size back, which depends on the concrete type
+        switch (segment->getType())
+        {
+            case SegmentType::Line:
+                destroySegment<LineSegment>(resource, segment);
+                break;
+            case SegmentType::Arc:
+                destroySegment<ArcSegment>(resource, segment);
+                break;
+        }
+    }
+
+    SegmentPtr createLineSegment(const geometry::Point2D& start, const geometry::Point2D& end,
+                                 std::pmr::memory_resource* resource)
+    {
+        return makeSegment<LineSegment>(resource, start, end);
+    }
+
+    SegmentPtr createArcSegment(const geometry::Point2D& center, double radius,
+                                double startAngle, double endAngle, bool clockwise,
+                                std::pmr::memory_resource* resource)
+    {
+        return makeSegment<ArcSegment>(resource, center, radius, startAngle, endAngle, clockwise);
+    }
+
+    SegmentPtr cloneSegment(const Segment& segment, std::pmr::memory_resource* resource)
+    {
+        switch (segment.getType())
+        {
+            case SegmentType::Line:
+                return makeSegment<LineSegment>(resource, static_cast<const LineSegment&>(segment));
+            case SegmentType::Arc:
+                return makeSegment<ArcSegment>(resource, static_cast<const ArcSegment&>(segment));
+        }
+        throw std::invalid_argument("cloneSegment: unsupported segment type");
+    }
+
     std::unique_ptr<Segment> createLineSegment(const geometry::Point2D& start, const geometry::Point2D& end)
     {
         return std::make_unique<LineSegment>(start, end);
@@ -342,4 +516,315 @@ namespace contour
     {
         return std::make_unique<ArcSegment>(center, radius, startAngle, endAngle, clockwise);
     }
+
+    SegmentVariant toSegmentVariant(const Segment& segment)
+    {
+        switch (segment.getType())
+        {
+            case SegmentType::Line:
+                return static_cast<const LineSegment&>(segment);
+            case SegmentType::Arc:
+                return static_cast<const ArcSegment&>(segment);
+        }
+        throw std::invalid_argument("toSegmentVariant: unsupported segment type");
+    }
+
+    void expandByArcExtremes(geometry::BoundingBox& box, const geometry::Point2D& center, double radius,
+                             double startAngle, double angleSpan, bool clockwise)
+    {
+        // Extremes at 0, 90, 180 and 270 degrees, in that order
+        const double dx[4] = { radius, 0.0, -radius, 0.0 };
+        const double dy[4] = { 0.0, radius, 0.0, -radius };
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+        {
+            // Angle travelled from the start to this axis direction
+            const double angle = quadrant * (geometry::PI / 2.0);
+            double offset = clockwise ? startAngle - angle : angle - startAngle;
+            offset = std::fmod(offset, 2.0 * geometry::PI);
+            if (offset < 0.0)
+            {
+                offset += 2.0 * geometry::PI;
+            }
+            if (offset <= angleSpan)
+            {
+                box.expand(geometry::Point2D(center.x + dx[quadrant], center.y + dy[quadrant]));
+            }
+        }
+    }
+
+    // Intersection kernels. Both operands are first reduced to a prepared
+    // form holding everything the tests need, so the batch forms pay for
+    // the trigonometry of the fixed segment once.
+    namespace
+    {
+        double cross(const geometry::Vector2D& a, const geometry::Vector2D& b)
+        {
+            return a.x * b.y - a.y * b.x;
+        }
+
+        struct PreparedLine
+        {
+            geometry::Point2D start;
+            geometry::Vector2D direction; // end - start
+            double lengthSquared;
+            double length;
+        };
+
+        // Arcs are stored counter-clockwise: from and to are the unit
+        // directions of the ends, middle the direction halfway along
+        struct PreparedArc
+        {
+            geometry::Point2D center;
+            double radius;
+            geometry::Vector2D from;
+            geometry::Vector2D to;
+            geometry::Vector2D middle;
+            bool reflex;                  // span above 180 degrees
+        };
+
+        PreparedLine prepare(const LineSegment& line)
+        {
+            const geometry::Point2D start = line.getStartPoint();
+            const geometry::Vector2D direction = line.getEndPoint() - start;
+            const double lengthSquared = direction.dot(direction);
+            return PreparedLine{ start, direction, lengthSquared, std::sqrt(lengthSquared) };
+        }
+
+        PreparedArc prepare(const ArcSegment& arc)
+        {
+            const double span = arc.getAngleSpan();
+            const double low = arc.isClockwise() ? arc.getEndAngle() : arc.getStartAngle();
+            const double middle = low + 0.5 * span;
+            const double high = low + span;
+            return PreparedArc{ arc.getCenter(), arc.getRadius(),
+                                geometry::Vector2D(std::cos(low), std::sin(low)),
+                                geometry::Vector2D(std::cos(high), std::sin(high)),
+                                geometry::Vector2D(std::cos(middle), std::sin(middle)),
+                                span > geometry::PI };
+        }
+
+        // Sweep test for a point on the arc's circle, without trigonometry.
+        // Each cross or dot product is a distance, so the slack is tolerance.
+        // A minor arc is where all three half-planes agree; a reflex arc is
+        // anywhere at least one does
+        bool onArc(const PreparedArc& arc, const geometry::Point2D& point, double tolerance)
+        {
+            const geometry::Vector2D offset = point - arc.center;
+            const bool afterFrom = cross(arc.from, offset) >= -tolerance;
+            const bool beforeTo = cross(offset, arc.to) >= -tolerance;
+            const bool facing = offset.dot(arc.middle) >= -tolerance;
+            return arc.reflex ? (afterFrom || beforeTo || facing) : (afterFrom && beforeTo && facing);
+        }
+
+        Intersection intersectPrepared(const PreparedLine& first, const PreparedLine& second, double tolerance)
+        {
+            Intersection result;
+            const geometry::Vector2D offset = second.start - first.start;
+            const double denominator = cross(first.direction, second.direction);
+            const double slack1 = tolerance / first.length;
+
+            if (std::abs(denominator) > geometry::EPSILON * first.length * second.length)
+            {
+                const double t = cross(offset, second.direction) / denominator;
+                const double u = cross(offset, first.direction) / denominator;
+                const double slack2 = tolerance / second.length;
+                const bool hit = t >= -slack1 && t <= 1.0 + slack1 && u >= -slack2 && u <= 1.0 + slack2;
+                result.points[0] = first.start + first.direction * std::clamp(t, 0.0, 1.0);
+                result.count = hit ? 1 : 0;
+                return result;
+            }
+
+            // Parallel: only collinear lines meet, along their shared interval
+            if (std::abs(cross(offset, first.direction)) > tolerance * first.length)
+            {
+                return result;
+            }
+            const double t0 = offset.dot(first.direction) / first.lengthSquared;
+            const double t1 = (offset + second.direction).dot(first.direction) / first.lengthSquared;
+            const double low = std::max(0.0, std::min(t0, t1));
+            const double high = std::min(1.0, std::max(t0, t1));
+            if (low > high + slack1)
+            {
+                return result;
+            }
+            result.points[0] = first.start + first.direction * std::min(low, 1.0);
+            result.points[1] = first.start + first.direction * high;
+            result.count = high - low > slack1 ? 2 : 1;
+            return result;
+        }
+
+        Intersection intersectPrepared(const PreparedLine& line, const PreparedArc& arc, double tolerance)
+        {
+            Intersection result;
+
+            // Closest approach of the line to the center, then the half chord
+            const double t0 = (arc.center - line.start).dot(line.direction) / line.lengthSquared;
+            const double h2 = arc.radius * arc.radius - (line.start + line.direction * t0).distanceSquaredTo(arc.center);
+            const double tangentBand = 2.0 * arc.radius * tolerance;
+            if (h2 < -tangentBand)
+            {
+                return result;
+            }
+
+            // Within the band the two roots are indistinguishable: a tangency
+            const double dt = h2 > tangentBand ? std::sqrt(h2 / line.lengthSquared) : 0.0;
+            const double slack = tolerance / line.length;
+            const int roots = h2 > tangentBand ? 2 : 1;
+            for (int i = 0; i < roots; ++i)
+            {
+                const double t = i == 0 ? t0 - dt : t0 + dt;
+                const geometry::Point2D point = line.start + line.direction * std::clamp(t, 0.0, 1.0);
+                if (t >= -slack && t <= 1.0 + slack && onArc(arc, point, tolerance))
+                {
+                    result.points[result.count++] = point;
+                }
+            }
+            return result;
+        }
+
+        Intersection intersectPrepared(const PreparedArc& arc, const PreparedLine& line, double tolerance)
+        {
+            return intersectPrepared(line, arc, tolerance);
+        }
+
+        Intersection intersectPrepared(const PreparedArc& first, const PreparedArc& second, double tolerance)
+        {
+            Intersection result;
+            const geometry::Vector2D delta = second.center - first.center;
+            const double distance = delta.magnitude();
+
+            if (distance <= tolerance)
+            {
+                if (std::abs(first.radius - second.radius) > tolerance)
+                {
+                    return result;
+                }
+
+                // Same circle: the shared stretch is bounded by endpoints lying on the other arc
+                const geometry::Point2D ends[4] = { first.center + first.from * first.radius,
+                                                    first.center + first.to * first.radius,
+                                                    second.center + second.from * second.radius,
+                                                    second.center + second.to * second.radius };
+                for (int i = 0; i < 4 && result.count < 2; ++i)
+                {
+                    const bool duplicate = result.count > 0 && result.points[0].isEqual(ends[i], tolerance);
+                    if (!duplicate && onArc(i < 2 ? second : first, ends[i], tolerance))
+                    {
+                        result.points[result.count++] = ends[i];
+                    }
+                }
+                return result;
+            }
+            if (distance > first.radius + second.radius + tolerance ||
+                distance < std::abs(first.radius - second.radius) - tolerance)
+            {
+                return result;
+            }
+
+            // Radical line: along is the foot on the center line, h2 the squared half chord
+            const double along = (first.radius * first.radius - second.radius * second.radius + distance * distance) / (2.0 * distance);
+            const double h2 = first.radius * first.radius - along * along;
+            const geometry::Point2D foot = first.center + delta * (along / distance);
+            const bool tangent = h2 <= 2.0 * std::min(first.radius, second.radius) * tolerance;
+            const double h = tangent ? 0.0 : std::sqrt(h2) / distance;
+            const geometry::Vector2D across(-delta.y * h, delta.x * h);
+            const int roots = tangent ? 1 : 2;
+            for (int i = 0; i < roots; ++i)
+            {
+                const geometry::Point2D point = i == 0 ? foot + across : foot - across;
+                if (onArc(first, point, tolerance) && onArc(second, point, tolerance))
+                {
+                    result.points[result.count++] = point;
+                }
+            }
+            return result;
+        }
+
+        template<typename Shape, typename Candidate>
+        std::size_t intersectEach(const Shape& segment, const Candidate* candidates, std::size_t count,
+                                  Intersection* results, double tolerance)
+        {
+            const auto prepared = prepare(segment);
+            std::size_t hits = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                results[i] = intersectPrepared(prepared, prepare(candidates[i]), tolerance);
+                hits += results[i].count > 0 ? 1 : 0;
+            }
+            return hits;
+        }
+    }
+
+    Intersection intersect(const LineSegment& first, const LineSegment& second, double tolerance)
+    {
+        return intersectPrepared(prepare(first), prepare(second), tolerance);
+    }
+
+    Intersection intersect(const LineSegment& line, const ArcSegment& arc, double tolerance)
+    {
+        return intersectPrepared(prepare(line), prepare(arc), tolerance);
+    }
+
+    Intersection intersect(const ArcSegment& arc, const LineSegment& line, double tolerance)
+    {
+        return intersectPrepared(prepare(line), prepare(arc), tolerance);
+    }
+
+    Intersection intersect(const ArcSegment& first, const ArcSegment& second, double tolerance)
+    {
+        return intersectPrepared(prepare(first), prepare(second), tolerance);
+    }
+
+    Intersection intersect(const SegmentVariant& first, const SegmentVariant& second, double tolerance)
+    {
+        return std::visit([tolerance](const auto& a, const auto& b) {
+            return intersectPrepared(prepare(a), prepare(b), tolerance);
+        }, first, second);
+    }
+
+    Intersection intersect(const Segment& first, const Segment& second, double tolerance)
+    {
+        return intersect(toSegmentVariant(first), toSegmentVariant(second), tolerance);
+    }
+
+    std::size_t intersectBatch(const LineSegment& segment, const LineSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance)
+    {
+        return intersectEach(segment, candidates, count, results, tolerance);
+    }
+
+    std::size_t intersectBatch(const LineSegment& segment, const ArcSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance)
+    {
+        return intersectEach(segment, candidates, count, results, tolerance);
+    }
+
+    std::size_t intersectBatch(const ArcSegment& segment, const LineSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance)
+    {
+        return intersectEach(segment, candidates, count, results, tolerance);
+    }
+
+    std::size_t intersectBatch(const ArcSegment& segment, const ArcSegment* candidates, std::size_t count,
+                               Intersection* results, double tolerance)
+    {
+        return intersectEach(segment, candidates, count, results, tolerance);
+    }
+
+    std::size_t intersectBatch(const SegmentVariant& segment, const SegmentVariant* candidates, std::size_t count,
+                               Intersection* results, double tolerance)
+    {
+        return std::visit([&](const auto& shape) {
+            const auto prepared = prepare(shape);
+            std::size_t hits = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                results[i] = std::visit([&](const auto& candidate) {
+                    return intersectPrepared(prepared, prepare(candidate), tolerance);
+                }, candidates[i]);
+                hits += results[i].count > 0 ? 1 : 0;
+            }
+            return hits;
+        }, segment);
+    }
 } 
\ No newline at end of file
@@ -0,0 +1,529 @@
+#include "../include/SweepLine.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <variant>
+
+namespace contour
+{
+    namespace sweep
+    {
+        namespace
+        {
+            using size_type = Contour::size_type;
+            using geometry::Point2D;
+
+            constexpr double INF = std::numeric_limits<double>::infinity();
+
+            // Angle margin that keeps arc pieces well clear of ArcSegment's
+            // equal-angle check
+            constexpr double MIN_PIECE_ANGLE = 1e-7;
+
+            // An x-monotone part of one segment
+            struct Piece
+            {
+                SegmentVariant shape; // the part as its own primitive, for the kernels
+                size_type segment;
+                Point2D left;         // lexicographically smaller endpoint
+                Point2D right;
+                double side;          // arcs: +1 on the upper half circle, -1 on the lower; 0 for lines
+            };
+
+            bool isBefore(const Point2D& a, const Point2D& b)
+            {
+                return a.x < b.x || (a.x == b.x && a.y < b.y);
+            }
+
+            // Signed height above an arc piece's center at x, taken from the
+            // circle rather than the endpoints so it has the piece's sign
+            // even where an endpoint sits a rounding error off the center line
+            double riseAt(const Piece& piece, double x)
+            {
+                const auto& arc = std::get<ArcSegment>(piece.shape);
+                const double dx = x - arc.getCenter().x;
+                const double radius = arc.getRadius();
+                return piece.side * std::sqrt(std::max(0.0, radius * radius - dx * dx));
+            }
+
+            double yAt(const Piece& piece, double x)
+            {
+                // Endpoints are returned exactly so events and keys agree
+                if (x <= piece.left.x)
+                {
+                    return piece.left.y;
+                }
+                if (x >= piece.right.x)
+                {
+                    return piece.right.y;
+                }
+                if (piece.side == 0.0)
+                {
+                    const double t = (x - piece.left.x) / (piece.right.x - piece.left.x);
+                    return piece.left.y + t * (piece.right.y - piece.left.y);
+                }
+                return std::get<ArcSegment>(piece.shape).getCenter().y + riseAt(piece, x);
+            }
+
+            // First and second derivative just right of x; orders pieces leaving a common point
+            double slopeAt(const Piece& piece, double x)
+            {
+                if (piece.left.x == piece.right.x)
+                {
+                    return INF;
+                }
+                if (piece.side == 0.0)
+                {
+                    return (piece.right.y - piece.left.y) / (piece.right.x - piece.left.x);
+                }
+                const double dx = x - std::get<ArcSegment>(piece.shape).getCenter().x;
+                const double dy = riseAt(piece, x);
+                if (dy == 0.0)
+                {
+                    return ((dx < 0.0) == (piece.side > 0.0)) ? INF : -INF;
+                }
+                return -dx / dy;
+            }
+
+            double curvatureOf(const Piece& piece)
+            {
+                return piece.side == 0.0 ? 0.0 : 1.0 / std::get<ArcSegment>(piece.shape).getRadius();
+            }
+
+            double bendAt(const Piece& piece, double x)
+            {
+                if (piece.side == 0.0)
+                {
+                    return 0.0;
+                }
+                const double dy = riseAt(piece, x);
+                if (dy == 0.0)
+                {
+                    return piece.side > 0.0 ? -INF : INF;
+                }
+                const double radius = std::get<ArcSegment>(piece.shape).getRadius();
+                return -(radius * radius) / (dy * dy * dy);
+            }
+
+            class Sweep
+            {
+            public:
+                Sweep(const Contour& contour, bool stopAtFirst);
+                std::vector<Contour::Crossing> run();
+
+            private:
+                struct Probe
+                {
+                    double y;
+                };
+
+                // Status order: height at the sweep point, then direction of travel
+                struct StatusOrder
+                {
+                    using is_transparent = void;
+                    const Sweep* sweep;
+
+                    bool operator()(size_type a, size_type b) const { return sweep->below(a, b); }
+                    bool operator()(size_type a, Probe b) const { return sweep->key(a) < b.y; }
+                    bool operator()(Probe a, size_type b) const { return a.y < sweep->key(b); }
+                };
+
+                using Status = std::set<size_type, StatusOrder>;
+                using EventKey = std::pair<double, double>;
+
+                struct Event
+                {
+                    std::vector<size_type> upper;    // pieces starting here
+                    std::vector<size_type> crossing; // pieces found to meet here
+                };
+
+                std::vector<Piece> m_pieces;
+                std::map<EventKey, Event> m_events;
+                Status m_status;
+                std::vector<Status::iterator> m_positions;
+                std::vector<char> m_active;         // piece is in the status
+                std::vector<char> m_pinned;         // piece is held at the event height
+                std::vector<Point2D> m_joints;      // end of segment i, for connected joints
+                std::vector<bool> m_connected;      // joint i joins segment i to i + 1 (mod n)
+                std::vector<Contour::Crossing> m_crossings;
+                std::vector<size_type> m_through;
+                std::vector<size_type> m_segments;
+                Point2D m_point;
+                double m_tolerance = geometry::EPSILON;
+                size_type m_segmentCount = 0;
+                bool m_stopAtFirst;
+
+                void addPieces(const Segment& segment, size_type index, const Point2D& start, const Point2D& end);
+                void addPiece(const SegmentVariant& shape, size_type index, const Point2D& from, const Point2D& to, double side);
+                EventKey eventKey(const Point2D& point) const;
+                double key(size_type piece) const;
+                bool below(size_type a, size_type b) const;
+                bool report(const std::vector<size_type>& upper);
+                bool isSharedJoint(size_type first, size_type second) const;
+                void check(size_type a, size_type b);
+                void checkRun();
+            };
+
+            Sweep::Sweep(const Contour& contour, bool stopAtFirst)
+                : m_status(StatusOrder{ this })
+                , m_stopAtFirst(stopAtFirst)
+            {
+                m_segmentCount = contour.size();
+                if (m_segmentCount == 0)
+                {
+                    return;
+                }
+
+                // Coordinates are compared with a tolerance scaled to the drawing
+                const geometry::BoundingBox bounds = contour.getBoundingBox();
+                if (!bounds.isEmpty())
+                {
+                    const double scale = std::max({ 1.0, std::abs(bounds.minPoint.x), std::abs(bounds.minPoint.y),
+                                                    std::abs(bounds.maxPoint.x), std::abs(bounds.maxPoint.y) });
+                    m_tolerance = geometry::EPSILON * scale;
+                }
+
+                // Joints connected within the tolerance are snapped to one point so
+                // both pieces share an event; the contour's own EPSILON test would
+                // miss rounding in endpoints far from the origin
+                m_joints.resize(m_segmentCount);
+                m_connected.assign(m_segmentCount, false);
+                const Point2D firstStart = contour[0].getStartPoint();
+                Point2D start = firstStart;
+                size_type index = 0;
+                for (auto it = contour.begin(); it != contour.end(); ++it, ++index)
+                {
+                    const Segment& segment = **it;
+                    Point2D end = segment.getEndPoint();
+                    auto next = std::next(it);
+                    const Segment* following = next != contour.end() ? next->get() : nullptr;
+                    const Point2D nextStart = following ? following->getStartPoint() : firstStart;
+                    if ((following || m_segmentCount > 1) && end.isEqual(nextStart, m_tolerance))
+                    {
+                        end = following ? end : firstStart;
+                        m_connected[index] = true;
+                    }
+                    m_joints[index] = end;
+
+                    if (!segment.getBoundingBox().isEmpty())
+                    {
+                        addPieces(segment, index, start, end);
+                    }
+                    start = m_connected[index] ? end : nextStart;
+                }
+
+                m_positions.resize(m_pieces.size());
+                m_active.assign(m_pieces.size(), 0);
+                m_pinned.assign(m_pieces.size(), 0);
+            }
+
+            void Sweep::addPieces(const Segment& segment, size_type index, const Point2D& start, const Point2D& end)
+            {
+                if (segment.getType() == SegmentType::Line)
+                {
+                    addPiece(toSegmentVariant(segment), index, start, end, 0.0);
+                    return;
+                }
+
+                // Cut the sweep where it passes the right (0 deg) or left (180 deg) of the circle
+                const auto& arc = static_cast<const ArcSegment&>(segment);
+                const double span = arc.getAngleSpan();
+                const double direction = arc.isClockwise() ? -1.0 : 1.0;
+                const double startAngle = arc.getStartAngle();
+                double cuts[4] = { 0.0 };
+                int cutCount = 1;
+                for (double extreme : { 0.0, geometry::PI })
+                {
+                    double travel = std::fmod(direction * (extreme - startAngle), 2.0 * geometry::PI);
+                    if (travel < 0.0)
+                    {
+                        travel += 2.0 * geometry::PI;
+                    }
+                    if (travel > MIN_PIECE_ANGLE && travel < span - MIN_PIECE_ANGLE)
+                    {
+                        cuts[cutCount++] = travel;
+                    }
+                }
+                if (cutCount == 3 && cuts[2] < cuts[1])
+                {
+                    std::swap(cuts[1], cuts[2]);
+                }
+                cuts[cutCount] = span;
+
+                Point2D from = start;
+                for (int i = 0; i < cutCount; ++i)
+                {
+                    ArcSegment part(arc.getCenter(), arc.getRadius(), startAngle + direction * cuts[i],
+                                    startAngle + direction * cuts[i + 1], arc.isClockwise());
+                    const Point2D to = (i + 1 == cutCount) ? end : part.getEndPoint();
+                    const double side = part.getPointAt(0.5).y >= arc.getCenter().y ? 1.0 : -1.0;
+                    addPiece(part, index, from, to, side);
+                    from = to;
+                }
+            }
+
+            void Sweep::addPiece(const SegmentVariant& shape, size_type index, const Point2D& from, const Point2D& to, double side)
+            {
+                // Ends take the point of the event they join, so the sweep can
+                // test them against the event point exactly
+                const EventKey first = eventKey(from);
+                const EventKey second = eventKey(to);
+                if (first == second)
+                {
+                    return;
+                }
+                const EventKey left = std::min(first, second);
+                const EventKey right = std::max(first, second);
+                m_pieces.push_back(Piece{ shape, index, Point2D(left.first, left.second),
+                                          Point2D(right.first, right.second), side });
+                m_events[left].upper.push_back(m_pieces.size() - 1);
+                m_events[right];
+            }
+
+            Sweep::EventKey Sweep::eventKey(const Point2D& point) const
+            {
+                // A point within the tolerance of a queued event joins it, so ends
+                // that differ by rounding meet at one event; the x values in the
+                // window are visited once each
+                auto it = m_events.lower_bound({ point.x - m_tolerance, -INF });
+                while (it != m_events.end() && it->first.first <= point.x + m_tolerance)
+                {
+                    const double x = it->first.first;
+                    it = m_events.lower_bound({ x, point.y - m_tolerance });
+                    if (it != m_events.end() && it->first.first == x && it->first.second <= point.y + m_tolerance)
+                    {
+                        return it->first;
+                    }
+                    it = m_events.upper_bound({ x, INF });
+                }
+                return { point.x, point.y };
+            }
+
+            double Sweep::key(size_type index) const
+            {
+                if (m_pinned[index])
+                {
+                    return m_point.y;
+                }
+                const Piece& piece = m_pieces[index];
+
+                // A vertical piece sits at the sweep point while the sweep runs up it
+                const double y = piece.left.x == piece.right.x ? std::clamp(m_point.y, piece.left.y, piece.right.y)
+                                                              : yAt(piece, m_point.x);
+                return std::abs(y - m_point.y) <= m_tolerance ? m_point.y : y;
+            }
+
+            bool Sweep::below(size_type a, size_type b) const
+            {
+                const double keyA = key(a);
+                const double keyB = key(b);
+                if (keyA != keyB)
+                {
+                    return keyA < keyB;
+                }
+                // A curve within tolerance of another over a short stretch meets it
+                // at a merged tangency where their directions agree only to
+                // sqrt(2 * tolerance * curvature); inside that slack the bend decides
+                const double slopeA = slopeAt(m_pieces[a], m_point.x);
+                const double slopeB = slopeAt(m_pieces[b], m_point.x);
+                const double curvature = std::max(curvatureOf(m_pieces[a]), curvatureOf(m_pieces[b]));
+                const double slack = std::sqrt(2.0 * m_tolerance * curvature);
+                if (slopeA != slopeB && std::abs(std::atan(slopeA) - std::atan(slopeB)) > slack)
+                {
+                    return slopeA < slopeB;
+                }
+                const double bendA = bendAt(m_pieces[a], m_point.x);
+                const double bendB = bendAt(m_pieces[b], m_point.x);
+                if (bendA != bendB)
+                {
+                    return bendA < bendB;
+                }
+                return a < b;
+            }
+
+            bool Sweep::isSharedJoint(size_type first, size_type second) const
+            {
+                const double reach = 4.0 * m_tolerance;
+                if (second == first + 1 && m_connected[first] && m_joints[first].isEqual(m_point, reach))
+                {
+                    return true;
+                }
+                const size_type last = m_segmentCount - 1;
+                return first == 0 && second == last && m_connected[last] && m_joints[last].isEqual(m_point, reach);
+            }
+
+            bool Sweep::report(const std::vector<size_type>& upper)
+            {
+                m_segments.clear();
+                for (size_type piece : upper)
+                {
+                    m_segments.push_back(m_pieces[piece].segment);
+                }
+                for (size_type piece : m_through)
+                {
+                    m_segments.push_back(m_pieces[piece].segment);
+                }
+                std::sort(m_segments.begin(), m_segments.end());
+                m_segments.erase(std::unique(m_segments.begin(), m_segments.end()), m_segments.end());
+
+                bool found = false;
+                for (size_type i = 0; i < m_segments.size(); ++i)
+                {
+                    for (size_type j = i + 1; j < m_segments.size(); ++j)
+                    {
+                        if (!isSharedJoint(m_segments[i], m_segments[j]))
+                        {
+                            m_crossings.push_back(Contour::Crossing{ m_segments[i], m_segments[j], m_point });
+                            found = true;
+                        }
+                    }
+                }
+                return found;
+            }
+
+            void Sweep::check(size_type a, size_type b)
+            {
+                if (m_pieces[a].segment == m_pieces[b].segment)
+                {
+                    return;
+                }
+
+                const Intersection hits = intersect(m_pieces[a].shape, m_pieces[b].shape, m_tolerance);
+
+                // Only meetings still ahead of the sweep become events; a joint
+                // being processed can come back a rounding error ahead of itself
+                const bool atJoint = isSharedJoint(std::min(m_pieces[a].segment, m_pieces[b].segment),
+                                                   std::max(m_pieces[a].segment, m_pieces[b].segment));
+                for (int i = 0; i < hits.count; ++i)
+                {
+                    const Point2D& point = hits.points[i];
+                    if (isBefore(m_point, point) && !(atJoint && point.isEqual(m_point, 4.0 * m_tolerance)))
+                    {
+                        Event& event = m_events[eventKey(point)];
+                        event.crossing.push_back(a);
+                        event.crossing.push_back(b);
+                    }
+                }
+            }
+
+            // Checks the run of pieces at the sweep point against each other and its two neighbours
+            void Sweep::checkRun()
+            {
+                auto lowest = m_status.lower_bound(Probe{ m_point.y });
+                auto highest = std::prev(m_status.upper_bound(Probe{ m_point.y }));
+                if (lowest != m_status.begin())
+                {
+                    check(*std::prev(lowest), *lowest);
+                }
+
+                // Unlike lines, curves leaving one point can meet again further on
+                for (auto it = lowest; it != highest; ++it)
+                {
+                    check(*it, *std::next(it));
+                }
+                auto after = std::next(highest);
+                if (after != m_status.end())
+                {
+                    check(*highest, *after);
+                }
+            }
+
+            std::vector<Contour::Crossing> Sweep::run()
+            {
+                while (!m_events.empty())
+                {
+                    auto event = m_events.begin();
+                    m_point = Point2D(event->first.first, event->first.second);
+                    const std::vector<size_type> upper = std::move(event->second.upper);
+                    const std::vector<size_type> crossing = std::move(event->second.crossing);
+                    m_events.erase(event);
+
+                    // Pieces computed to cross here are held at this height even when
+                    // evaluating them gives a slightly different one (near tangencies)
+                    for (size_type piece : crossing)
+                    {
+                        m_pinned[piece] = m_active[piece];
+                    }
+
+                    // Pieces ending at or passing through the point form one run in the status
+                    m_through.clear();
+                    for (auto it = m_status.lower_bound(Probe{ m_point.y }); it != m_status.end() && key(*it) == m_point.y; ++it)
+                    {
+                        m_through.push_back(*it);
+                    }
+
+                    if (report(upper) && m_stopAtFirst)
+                    {
+                        break;
+                    }
+
+                    // Re-inserting the continuing pieces at the point swaps crossing pairs
+                    for (size_type piece : m_through)
+                    {
+                        m_status.erase(m_positions[piece]);
+                        m_active[piece] = 0;
+                    }
+                    size_type inserted = 0;
+                    for (size_type piece : upper)
+                    {
+                        m_positions[piece] = m_status.insert(piece).first;
+                        m_active[piece] = 1;
+                        ++inserted;
+                    }
+                    for (size_type piece : m_through)
+                    {
+                        const Point2D& right = m_pieces[piece].right;
+                        if (right.x != m_point.x || right.y != m_point.y)
+                        {
+                            m_positions[piece] = m_status.insert(piece).first;
+                            m_active[piece] = 1;
+                            ++inserted;
+                        }
+                    }
+
+                    if (inserted == 0)
+                    {
+                        auto above = m_status.lower_bound(Probe{ m_point.y });
+                        if (above != m_status.begin() && above != m_status.end())
+                        {
+                            check(*std::prev(above), *above);
+                        }
+                    }
+                    else
+                    {
+                        checkRun();
+                    }
+
+                    for (size_type piece : crossing)
+                    {
+                        m_pinned[piece] = 0;
+                    }
+                }
+
+                // Near-coincident events can report the same meeting twice
+                std::sort(m_crossings.begin(), m_crossings.end(), [](const Contour::Crossing& a, const Contour::Crossing& b) {
+                    if (a.first != b.first) return a.first < b.first;
+                    if (a.second != b.second) return a.second < b.second;
+                    return isBefore(a.point, b.point);
+                });
+                const double reach = 4.0 * m_tolerance;
+                m_crossings.erase(std::unique(m_crossings.begin(), m_crossings.end(),
+                                              [reach](const Contour::Crossing& a, const Contour::Crossing& b) {
+                                                  return a.first == b.first && a.second == b.second &&
+                                                         a.point.isEqual(b.point, reach);
+                                              }),
+                                  m_crossings.end());
+                return std::move(m_crossings);
+            }
+        }
+
+        std::vector<Contour::Crossing> findCrossings(const Contour& contour, bool stopAtFirst)
+        {
+            Sweep sweep(contour, stopAtFirst);
+            return sweep.run();
+        }
+    }
+}
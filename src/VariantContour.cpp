@@ -0,0 +1,259 @@
+#include "../include/VariantContour.h"
+#include <stdexcept>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace contour
+{
+    namespace
+    {
+        // Concrete-type endpoint accessors; LineSegment and ArcSegment are final,
+        // so these calls resolve statically instead of through the vtable
+        geometry::Point2D startPointOf(const SegmentVariant& segment)
+        {
+            return std::visit([](const auto& s) { return s.getStartPoint(); }, segment);
+        }
+
+        geometry::Point2D endPointOf(const SegmentVariant& segment)
+        {
+            return std::visit([](const auto& s) { return s.getEndPoint(); }, segment);
+        }
+    }
+
+    // Constructors
+    VariantContour::VariantContour(SegmentContainer segments) : m_segments(std::move(segments))
+    {
+    }
+
+    VariantContour::VariantContour(const Contour& contour)
+    {
+        m_segments.reserve(contour.size());
+        for (const auto& segment : contour)
+        {
+            m_segments.push_back(toSegmentVariant(*segment));
+        }
+    }
+
+    // Segment management
+    void VariantContour::addSegment(SegmentVariant segment)
+    {
+        m_segments.push_back(std::move(segment));
+        invalidateCache();
+    }
+
+    void VariantContour::addLine(const geometry::Point2D& start, const geometry::Point2D& end)
+    {
+        m_segments.emplace_back(std::in_place_type<LineSegment>, start, end);
+        invalidateCache();
+    }
+
+    void VariantContour::addArc(const geometry::Point2D& center, double radius,
+                                double startAngle, double endAngle, bool clockwise)
+    {
+        m_segments.emplace_back(std::in_place_type<ArcSegment>, center, radius, startAngle, endAngle, clockwise);
+        invalidateCache();
+    }
+
+    void VariantContour::insertSegment(size_type index, SegmentVariant segment)
+    {
+        if (index > m_segments.size())
+        {
+            throw std::out_of_range("VariantContour::insertSegment: index out of range");
+        }
+        m_segments.insert(m_segments.begin() + index, std::move(segment));
+        invalidateCache();
+    }
+
+    void VariantContour::removeSegment(size_type index)
+    {
+        if (index >= m_segments.size())
+        {
+            throw std::out_of_range("VariantContour::removeSegment: index out of range");
+        }
+        m_segments.erase(m_segments.begin() + index);
+        invalidateCache();
+    }
+
+    void VariantContour::replaceSegment(size_type index, SegmentVariant segment)
+    {
+        if (index >= m_segments.size())
+        {
+            throw std::out_of_range("VariantContour::replaceSegment: index out of range");
+        }
+        m_segments[index] = std::move(segment);
+        invalidateCache();
+    }
+
+    void VariantContour::clear()
+    {
+        m_segments.clear();
+        invalidateCache();
+    }
+
+    // Access methods
+    const SegmentVariant& VariantContour::operator[](size_type index) const
+    {
+        if (index >= m_segments.size())
+        {
+            throw std::out_of_range("VariantContour::operator[]: index out of range");
+        }
+        return m_segments[index];
+    }
+
+    const SegmentVariant& VariantContour::at(size_type index) const
+    {
+        if (index >= m_segments.size())
+        {
+            throw std::out_of_range("VariantContour::at: index out of range");
+        }
+        return m_segments[index];
+    }
+
+    const Segment& VariantContour::segmentAt(size_type index) const
+    {
+        return std::visit([](const auto& s) -> const Segment& { return s; }, at(index));
+    }
+
+    // Validation with caching
+    bool VariantContour::isValid(double epsilon) const
+    {
+        if (m_validityCache.has_value() && geometry::isEqual(m_lastEpsilon, epsilon))
+        {
+            return m_validityCache.value();
+        }
+
+        bool isValid = calculateValidity(epsilon);
+        m_validityCache = isValid;
+        m_lastEpsilon = epsilon;
+
+        return isValid;
+    }
+
+    // Utility methods
+    double VariantContour::getTotalLength() const
+    {
+        double totalLength = 0.0;
+        for (const auto& segment : m_segments)
+        {
+            totalLength += std::visit([](const auto& s) { return s.getLength(); }, segment);
+        }
+        return totalLength;
+    }
+
+    std::vector<geometry::Point2D> VariantContour::getVertices() const
+    {
+        std::vector<geometry::Point2D> vertices;
+        if (m_segments.empty())
+        {
+            return vertices;
+        }
+
+        vertices.reserve(m_segments.size() + 1);
+        vertices.push_back(startPointOf(m_segments.front()));
+        for (const auto& segment : m_segments)
+        {
+            vertices.push_back(endPointOf(segment));
+        }
+
+        return vertices;
+    }
+
+    bool VariantContour::isClosed(double epsilon) const
+    {
+        if (m_segments.empty())
+        {
+            return false;
+        }
+        return startPointOf(m_segments.front()).isEqual(endPointOf(m_segments.back()), epsilon);
+    }
+
+    bool VariantContour::isEqual(const VariantContour& other, double epsilon) const
+    {
+        if (m_segments.size() != other.m_segments.size())
+        {
+            return false;
+        }
+
+        for (size_type i = 0; i < m_segments.size(); ++i)
+        {
+            bool equal = std::visit([epsilon](const auto& lhs, const auto& rhs) {
+                using Lhs = std::decay_t<decltype(lhs)>;
+                using Rhs = std::decay_t<decltype(rhs)>;
+                if constexpr (std::is_same_v<Lhs, Rhs>)
+                {
+                    return lhs.isEqual(rhs, epsilon);
+                }
+                else
+                {
+                    return false;
+                }
+            }, m_segments[i], other.m_segments[i]);
+
+            if (!equal)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    Contour VariantContour::toContour() const
+    {
+        Contour::SegmentContainer segments;
+        segments.reserve(m_segments.size());
+        for (const auto& segment : m_segments)
+        {
+            segments.push_back(std::visit([](const auto& s) { return s.clone(); }, segment));
+        }
+        return Contour(std::move(segments));
+    }
+
+    // Private helper methods
+    void VariantContour::invalidateCache() const
+    {
+        m_validityCache.reset();
+        m_lastEpsilon = -1.0;
+    }
+
+    bool VariantContour::calculateValidity(double epsilon) const
+    {
+        // Same rules as Contour: empty is invalid, a single segment is valid
+        if (m_segments.empty())
+        {
+            return false;
+        }
+        if (m_segments.size() == 1)
+        {
+            return true;
+        }
+        if (std::isnan(epsilon) || epsilon < 0)
+        {
+            return false;
+        }
+
+        geometry::Point2D previousEnd = endPointOf(m_segments.front());
+        for (size_type i = 1; i < m_segments.size(); ++i)
+        {
+            if (!previousEnd.isEqual(startPointOf(m_segments[i]), epsilon))
+            {
+                return false;
+            }
+            previousEnd = endPointOf(m_segments[i]);
+        }
+
+        return true;
+    }
+
+    // Global operators
+    bool operator==(const VariantContour& lhs, const VariantContour& rhs)
+    {
+        return lhs.isEqual(rhs);
+    }
+
+    bool operator!=(const VariantContour& lhs, const VariantContour& rhs)
+    {
+        return !lhs.isEqual(rhs);
+    }
+}
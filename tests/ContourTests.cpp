@@ -2,19 +2,34 @@
 #include "../include/ContourUtilities.h"
 #include "../include/ContourVisualizer.h"
 #include "../include/Geometry.h"
+#include "../include/VariantContour.h"
+#include "../include/FlatContour.h"
+#include "../include/GridHash.h"
+#include "../include/Log.h"
+#include "../include/ContourIO.h"
+#include "../include/MappedContour.h"
+#include "../include/DxfIO.h"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <future>
 #include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <chrono>
 #include <thread>
+#include <mutex>
 #include <set>
 #include <iterator>
 #include <functional>
 #include <string>
 #include <utility>
+#include <limits>
+#include <random>
+#include <filesystem>
+#include <cstdio>
+#include <sstream>
+#include <fstream>
 
 using namespace contour;
 using namespace geometry;
@@ -98,6 +113,198 @@ void testSegments(TestSuite& suite)
     suite.runTest("Segment cloning", line1->isEqual(*clonedLine));
 }
 
+// Test exact segment bounds and the cached contour bounds
+void testBoundingBoxes(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Bounding Boxes ===" << std::endl;
+    
+    auto line = createLineSegment(Point2D(3.0, -1.0), Point2D(1.0, 2.0));
+    BoundingBox lineBox = line->getBoundingBox();
+    suite.runTest("Line bounds", lineBox.minPoint.isEqual(Point2D(1.0, -1.0)) && lineBox.maxPoint.isEqual(Point2D(3.0, 2.0)));
+    
+    // A short arc stays near its endpoints instead of covering the circle
+    auto shortArc = createArcSegment(Point2D(0.0, 0.0), 10.0, PI/6, PI/3, false);
+    BoundingBox shortBox = shortArc->getBoundingBox();
+    suite.runTest("Short arc bounds", isEqual(shortBox.minPoint.x, 5.0) && isEqual(shortBox.maxPoint.x, 10.0 * std::cos(PI/6)) &&
+                  isEqual(shortBox.minPoint.y, 5.0) && isEqual(shortBox.maxPoint.y, 10.0 * std::sin(PI/3)));
+    
+    // Counter-clockwise from 45 to 135 degrees crosses the +y axis
+    auto topArc = createArcSegment(Point2D(1.0, 1.0), 2.0, PI/4, 3*PI/4, false);
+    BoundingBox topBox = topArc->getBoundingBox();
+    suite.runTest("Arc crossing one axis", isEqual(topBox.maxPoint.y, 3.0) && isEqual(topBox.minPoint.y, 1.0 + std::sqrt(2.0)));
+    
+    // Clockwise from 45 to 135 degrees sweeps the other 270 degrees
+    auto wideArc = createArcSegment(Point2D(0.0, 0.0), 1.0, PI/4, 3*PI/4, true);
+    BoundingBox wideBox = wideArc->getBoundingBox();
+    suite.runTest("Clockwise arc crossing three axes", isEqual(wideBox.minPoint.x, -1.0) && isEqual(wideBox.maxPoint.x, 1.0) &&
+                  isEqual(wideBox.minPoint.y, -1.0) && isEqual(wideBox.maxPoint.y, std::sqrt(0.5)));
+    
+    // The contour box follows every kind of edit
+    Contour contour = std::move(ContourBuilder()
+        .addLine(Point2D(0.0, 0.0), Point2D(4.0, 0.0))
+        .addArc(Point2D(4.0, 1.0), 1.0, -PI/2, PI/2, false)
+        .addLine(Point2D(4.0, 2.0), Point2D(0.0, 2.0)))
+        .build();
+    BoundingBox box = contour.getBoundingBox();
+    suite.runTest("Contour bounds include the arc bulge", isEqual(box.maxPoint.x, 5.0) && isEqual(box.maxPoint.y, 2.0) &&
+                  box.minPoint.isEqual(Point2D(0.0, 0.0)));
+    
+    Contour snapshot = contour;
+    contour.removeSegment(1);
+    contour.replaceSegment(0, createLineSegment(Point2D(-3.0, 0.0), Point2D(4.0, 0.0)));
+    box = contour.getBoundingBox();
+    suite.runTest("Contour bounds shrink and grow with edits", isEqual(box.maxPoint.x, 4.0) && isEqual(box.minPoint.x, -3.0) &&
+                  isEqual(snapshot.getBoundingBox().maxPoint.x, 5.0));
+    suite.runTest("Empty contour has empty bounds", Contour().getBoundingBox().isEmpty());
+}
+
+// Test line/arc intersection kernels
+void testIntersections(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Intersections ===" << std::endl;
+    
+    LineSegment diagonal(Point2D(0.0, 0.0), Point2D(2.0, 2.0));
+    LineSegment antiDiagonal(Point2D(0.0, 2.0), Point2D(2.0, 0.0));
+    Intersection cross = intersect(diagonal, antiDiagonal);
+    suite.runTest("Crossing lines", cross.count == 1 && cross.points[0].isEqual(Point2D(1.0, 1.0)));
+    suite.runTest("Parallel lines miss",
+                  intersect(diagonal, LineSegment(Point2D(1.0, 0.0), Point2D(3.0, 2.0))).count == 0);
+    Intersection overlap = intersect(diagonal, LineSegment(Point2D(3.0, 3.0), Point2D(1.0, 1.0)));
+    suite.runTest("Collinear overlap gives its ends", overlap.count == 2 &&
+                  overlap.points[0].isEqual(Point2D(1.0, 1.0)) && overlap.points[1].isEqual(Point2D(2.0, 2.0)));
+    Intersection touch = intersect(diagonal, LineSegment(Point2D(2.0, 2.0), Point2D(3.0, 0.0)));
+    suite.runTest("Lines touching at an end", touch.count == 1 && touch.points[0].isEqual(Point2D(2.0, 2.0)));
+    
+    // The same angles cover the upper half counter-clockwise and the lower half clockwise
+    ArcSegment upper(Point2D(0.0, 0.0), 1.0, 0.0, PI, false);
+    ArcSegment lower(Point2D(0.0, 0.0), 1.0, 0.0, PI, true);
+    LineSegment chord(Point2D(-2.0, -0.5), Point2D(2.0, -0.5));
+    Intersection below = intersect(chord, lower);
+    suite.runTest("Arc direction is respected", intersect(chord, upper).count == 0 && below.count == 2 &&
+                  isEqual(below.points[0].magnitude(), 1.0) && isEqual(below.points[1].magnitude(), 1.0));
+    Intersection tangent = intersect(upper, LineSegment(Point2D(-1.0, 1.0), Point2D(1.0, 1.0)));
+    suite.runTest("Tangent line touches once", tangent.count == 1 && tangent.points[0].isEqual(Point2D(0.0, 1.0)));
+    suite.runTest("Arc span is respected",
+                  intersect(ArcSegment(Point2D(0.0, 0.0), 1.0, PI / 4, PI / 2, false), chord).count == 0 &&
+                  intersect(ArcSegment(Point2D(0.0, 0.0), 1.0, PI / 4, 3 * PI / 4, true), chord).count == 2);
+    
+    ArcSegment shifted(Point2D(1.0, 0.0), 1.0, 0.0, PI, false);
+    Intersection arcs = intersect(upper, shifted);
+    suite.runTest("Arcs crossing", arcs.count == 1 && arcs.points[0].isEqual(Point2D(0.5, std::sqrt(3.0) / 2.0)));
+    Intersection shared = intersect(upper, ArcSegment(Point2D(0.0, 0.0), 1.0, PI / 2, 3 * PI / 2, false));
+    suite.runTest("Arcs on one circle give the shared stretch", shared.count == 2 &&
+                  shared.points[0].isEqual(Point2D(-1.0, 0.0)) && shared.points[1].isEqual(Point2D(0.0, 1.0)));
+    suite.runTest("Reflex arc sweep", intersect(ArcSegment(Point2D(0.0, 0.0), 1.0, PI / 4, -PI / 4, false),
+                                                LineSegment(Point2D(2.0, -0.5), Point2D(-2.0, -0.5))).count == 1);
+    
+    // Batch forms agree with pairwise calls
+    std::mt19937 random(1313);
+    std::uniform_real_distribution<double> coordinate(-5.0, 5.0);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * PI);
+    auto randomLine = [&]() { return LineSegment(Point2D(coordinate(random), coordinate(random)),
+                                                 Point2D(coordinate(random), coordinate(random))); };
+    auto randomArc = [&]() {
+        const double start = angle(random);
+        return ArcSegment(Point2D(coordinate(random), coordinate(random)), 0.5 + std::abs(coordinate(random)),
+                          start, start + 0.2 + angle(random) * 0.9, random() % 2 == 0);
+    };
+    std::vector<LineSegment> lines;
+    std::vector<ArcSegment> arcList;
+    std::vector<SegmentVariant> mixed;
+    for (int i = 0; i < 500; ++i)
+    {
+        lines.push_back(randomLine());
+        arcList.push_back(randomArc());
+        mixed.push_back(i % 2 == 0 ? SegmentVariant(lines.back()) : SegmentVariant(arcList.back()));
+    }
+    auto sameResult = [](const Intersection& a, const Intersection& b) {
+        bool same = a.count == b.count;
+        for (int i = 0; same && i < a.count; ++i)
+        {
+            same = a.points[i].isEqual(b.points[i]);
+        }
+        return same;
+    };
+    std::vector<Intersection> results(500);
+    bool batchMatches = true;
+    std::size_t total = 0;
+    for (int q = 0; q < 20; ++q)
+    {
+        const LineSegment line = randomLine();
+        const ArcSegment arc = randomArc();
+        std::size_t hits = intersectBatch(line, lines.data(), lines.size(), results.data());
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            batchMatches = batchMatches && sameResult(results[i], intersect(line, lines[i]));
+        }
+        hits += intersectBatch(line, arcList.data(), arcList.size(), results.data());
+        for (std::size_t i = 0; i < arcList.size(); ++i)
+        {
+            batchMatches = batchMatches && sameResult(results[i], intersect(line, arcList[i]));
+        }
+        hits += intersectBatch(arc, lines.data(), lines.size(), results.data());
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            batchMatches = batchMatches && sameResult(results[i], intersect(arc, lines[i]));
+        }
+        hits += intersectBatch(arc, arcList.data(), arcList.size(), results.data());
+        for (std::size_t i = 0; i < arcList.size(); ++i)
+        {
+            batchMatches = batchMatches && sameResult(results[i], intersect(arc, arcList[i]));
+        }
+        hits += intersectBatch(SegmentVariant(arc), mixed.data(), mixed.size(), results.data());
+        for (std::size_t i = 0; i < mixed.size(); ++i)
+        {
+            batchMatches = batchMatches && sameResult(results[i], intersect(SegmentVariant(arc), mixed[i]));
+        }
+        total += hits;
+    }
+    suite.runTest("Batch intersections match pairwise calls", batchMatches && total > 0);
+    
+    // Every reported point lies on both segments
+    bool pointsOnBoth = true;
+    for (std::size_t i = 0; i + 1 < mixed.size(); ++i)
+    {
+        std::unique_ptr<Segment> first = std::visit([](const auto& s) -> std::unique_ptr<Segment> { return s.clone(); }, mixed[i]);
+        std::unique_ptr<Segment> second = std::visit([](const auto& s) -> std::unique_ptr<Segment> { return s.clone(); }, mixed[i + 1]);
+        const Intersection result = intersect(*first, *second);
+        for (int k = 0; k < result.count; ++k)
+        {
+            pointsOnBoth = pointsOnBoth && first->distanceTo(result.points[k]) < 1e-7 &&
+                           second->distanceTo(result.points[k]) < 1e-7;
+        }
+    }
+    suite.runTest("Intersection points lie on both segments", pointsOnBoth);
+    
+    // Batch kernel vs the polymorphic pairwise path
+    const int rounds = 200;
+    std::vector<std::unique_ptr<Segment>> boxed;
+    for (const auto& line : lines)
+    {
+        boxed.push_back(line.clone());
+    }
+    std::size_t batchHits = 0;
+    std::size_t pairHits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        batchHits += intersectBatch(arcList[r], lines.data(), lines.size(), results.data());
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (const auto& candidate : boxed)
+        {
+            pairHits += intersect(arcList[r], *candidate).count > 0 ? 1 : 0;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << rounds << " x " << lines.size() << " arc/line tests: batch "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, pairwise "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("Batch and pairwise hit counts agree", batchHits == pairHits);
+}
+
 // Test contour functionality
 void testContour(TestSuite& suite)
 {
@@ -187,6 +394,130 @@ void testSegmentManagement(TestSuite& suite)
     
     arcContour.addSegment(createLineSegment(Point2D(0.0, 1.0), Point2D(1.0, 1.0)));
     suite.runTest("Add line after arc", arcContour.size() == 2 && arcContour.isValid());
+    
+    // Joint-gap summary answers any tolerance and follows every edit
+    Contour gapped;
+    gapped.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    gapped.addSegment(createLineSegment(Point2D(1.0, 0.25), Point2D(2.0, 0.0)));
+    gapped.addSegment(createLineSegment(Point2D(2.0, 0.0), Point2D(3.0, 0.0)));
+    suite.runTest("Max joint gap", isEqual(gapped.getMaxJointGap(), 0.25));
+    suite.runTest("Validity for any epsilon", !gapped.isValid() && !gapped.isValid(0.25) &&
+                  gapped.isValid(0.3) && !gapped.isValid(0.1));
+    
+    Contour gappedCopy = gapped;
+    gapped.replaceSegment(1, createLineSegment(Point2D(1.0, 0.0), Point2D(2.0, 0.0)));
+    suite.runTest("Replace closes gap", gapped.isValid() && isEqual(gapped.getMaxJointGap(), 0.0));
+    suite.runTest("Copy keeps its own summary", isEqual(gappedCopy.getMaxJointGap(), 0.25));
+    
+    gappedCopy.removeSegment(1);
+    suite.runTest("Remove bridges neighbours", isEqual(gappedCopy.getMaxJointGap(), 1.0));
+    gappedCopy.insertSegment(1, createLineSegment(Point2D(1.0, 0.0), Point2D(2.0, 0.0)));
+    suite.runTest("Insert reconnects", gappedCopy.isValid() && gappedCopy.size() == 3);
+    gappedCopy.removeSegment(0);
+    gappedCopy.removeSegment(1);
+    suite.runTest("Single segment has no joints", gappedCopy.isValid() && isEqual(gappedCopy.getMaxJointGap(), 0.0));
+    
+    // Disconnected joints are tracked locally and shift with insert/remove
+    std::vector<Point2D> stairs;
+    for (int i = 0; i <= 8; ++i)
+    {
+        stairs.emplace_back(static_cast<double>(i), static_cast<double>(i % 2));
+    }
+    Contour tracked = utilities::createPolylineContour(stairs);
+    suite.runTest("No disconnected joints", tracked.getDisconnectedJoints().empty());
+    
+    tracked.replaceSegment(3, createLineSegment(Point2D(3.0, 5.0), Point2D(4.0, 5.0)));
+    suite.runTest("Replace breaks both joints",
+                  tracked.getDisconnectedJoints() == std::vector<Contour::size_type>{2, 3});
+    
+    tracked.insertSegment(0, createLineSegment(Point2D(-5.0, 0.0), Point2D(-4.0, 0.0)));
+    suite.runTest("Insert shifts broken joints",
+                  tracked.getDisconnectedJoints() == std::vector<Contour::size_type>{0, 3, 4});
+    
+    tracked.removeSegment(4);
+    suite.runTest("Remove merges broken joints",
+                  tracked.getDisconnectedJoints() == std::vector<Contour::size_type>{0, 3});
+    
+    tracked.insertSegment(4, createLineSegment(Point2D(3.0, 1.0), Point2D(4.0, 0.0)));
+    suite.runTest("Insert repairs gap",
+                  tracked.getDisconnectedJoints() == std::vector<Contour::size_type>{0} && !tracked.isValid());
+    
+    tracked.removeSegment(0);
+    suite.runTest("Gaps cleared", tracked.getDisconnectedJoints().empty() && tracked.isValid());
+    
+    // Mutation goes through explicit edit handles
+    {
+        auto edit = tracked.edit(2);
+        static_cast<LineSegment&>(*edit) = LineSegment(Point2D(2.0, 0.0), Point2D(3.0, 7.0));
+    }
+    suite.runTest("Edit handle refreshes on destruction",
+                  tracked.getDisconnectedJoints() == std::vector<Contour::size_type>{2});
+    
+    auto edit = tracked.edit(2);
+    edit.replace(createArcSegment(Point2D(2.5, 0.5), std::sqrt(0.5), 5*PI/4, PI/4, false));
+    edit.commit();
+    suite.runTest("Edit handle commit", tracked.isValid() && tracked[2].getType() == SegmentType::Arc);
+    
+    bool committedThrows = true;
+    for (int use = 0; use < 3; ++use)
+    {
+        try
+        {
+            if (use == 0) { *edit; }
+            else if (use == 1) { edit->getLength(); }
+            else { edit.replace(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0))); }
+            committedThrows = false;
+        }
+        catch (const std::logic_error&) {}
+    }
+    suite.runTest("Committed edit handle throws instead of dereferencing null",
+                  committedThrows && tracked[2].getType() == SegmentType::Arc);
+    
+    bool threw = false;
+    try { tracked.edit(tracked.size()); } catch (const std::out_of_range&) { threw = true; }
+    suite.runTest("Edit handle bounds check", threw);
+}
+
+// Test arc-length parameterization
+void testArcLength(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Arc Length Queries ===" << std::endl;
+    
+    // 1 unit line, quarter circle of radius 1, then 2 unit line
+    Contour path;
+    path.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    path.addSegment(createArcSegment(Point2D(1.0, 1.0), 1.0, -PI/2, 0.0, false));
+    path.addSegment(createLineSegment(Point2D(2.0, 1.0), Point2D(2.0, 3.0)));
+    const double total = 3.0 + PI/2;
+    suite.runTest("Cached total length", isEqual(path.getTotalLength(), total));
+    
+    suite.runTest("Segment at distance", path.segmentIndexAtDistance(0.0) == 0 &&
+                  path.segmentIndexAtDistance(1.5) == 1 && path.segmentIndexAtDistance(total) == 2);
+    suite.runTest("Point at distance on line", path.pointAtDistance(0.5).isEqual(Point2D(0.5, 0.0)));
+    
+    Point2D mid = path.pointAtDistance(1.0 + PI/4);
+    suite.runTest("Point at distance on arc", mid.isEqual(Point2D(1.0 + std::sqrt(0.5), 1.0 - std::sqrt(0.5)), 1e-9));
+    
+    geometry::Vector2D tangent = path.tangentAtDistance(1.0 + PI/4);
+    suite.runTest("Tangent at distance on arc", isEqual(tangent.x, std::sqrt(0.5)) && isEqual(tangent.y, std::sqrt(0.5)));
+    suite.runTest("Tangent at end", path.tangentAtDistance(total).isEqual(Point2D(0.0, 1.0)));
+    
+    bool threw = false;
+    try { path.pointAtDistance(total + 0.1); } catch (const std::out_of_range&) { threw = true; }
+    suite.runTest("Distance out of range", threw);
+    
+    // Edits invalidate only the suffix of the table
+    path.replaceSegment(2, createLineSegment(Point2D(2.0, 1.0), Point2D(2.0, 2.0)));
+    suite.runTest("Length after replace", isEqual(path.getTotalLength(), 2.0 + PI/2));
+    path.insertSegment(0, createLineSegment(Point2D(-1.0, 0.0), Point2D(0.0, 0.0)));
+    suite.runTest("Length after insert", isEqual(path.getTotalLength(), 3.0 + PI/2) &&
+                  path.pointAtDistance(1.5).isEqual(Point2D(0.5, 0.0)));
+    path.removeSegment(2);
+    suite.runTest("Length after remove", isEqual(path.getTotalLength(), 3.0));
+    
+    Contour moved = std::move(path);
+    suite.runTest("Moved-from contour has no length", isEqual(path.getTotalLength(), 0.0) &&
+                  isEqual(moved.getTotalLength(), 3.0));
 }
 
 // Test utility functions
@@ -230,6 +561,1846 @@ void testUtilities(TestSuite& suite)
     suite.runTest("Polygon area calculation", isEqual(area, 1.0));
 }
 
+// Test batch arc-length resampling
+void testResampling(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Resampling ===" << std::endl;
+    
+    Contour path;
+    path.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    path.addSegment(createArcSegment(Point2D(1.0, 1.0), 1.0, -PI/2, 0.0, false));
+    path.addSegment(createArcSegment(Point2D(3.0, 1.0), 1.0, PI, PI/2, true));
+    path.addSegment(createLineSegment(Point2D(3.0, 2.0), Point2D(5.0, 2.0)));
+    
+    const size_t n = 101;
+    std::vector<Point2D> samples(n);
+    utilities::resampleUniform(path, n, samples.data());
+    
+    const double spacing = path.getTotalLength() / (n - 1);
+    bool matches = true;
+    for (size_t i = 0; i < n && matches; ++i)
+    {
+        matches = samples[i].isEqual(path.pointAtDistance(std::min(i * spacing, path.getTotalLength())), 1e-9);
+    }
+    suite.runTest("Uniform resample matches pointAtDistance", matches);
+    suite.runTest("Uniform resample endpoints", samples.front().isEqual(Point2D(0.0, 0.0)) &&
+                  samples.back().isEqual(Point2D(5.0, 2.0)));
+    
+    size_t needed = utilities::resampleByStepCount(path, 0.25);
+    std::vector<Point2D> stepped(needed);
+    size_t written = utilities::resampleByStep(path, 0.25, stepped.data(), stepped.size());
+    suite.runTest("Step resample count", written == needed &&
+                  needed == static_cast<size_t>(std::floor(path.getTotalLength() / 0.25)) + 1);
+    suite.runTest("Step resample spacing", stepped[5].isEqual(path.pointAtDistance(1.25), 1e-9));
+    suite.runTest("Step resample respects capacity", utilities::resampleByStep(path, 0.25, stepped.data(), 3) == 3);
+    
+    bool threw = false;
+    try { utilities::resampleByStepCount(path, 0.0); } catch (const std::invalid_argument&) { threw = true; }
+    suite.runTest("Step must be positive", threw);
+    
+    // Single sweep against one binary search per sample
+    std::vector<Point2D> ring;
+    for (int i = 0; i < 2000; ++i)
+    {
+        ring.emplace_back(std::cos(i * 0.001), std::sin(i * 0.001) + (i % 2) * 0.01);
+    }
+    Contour large = utilities::createPolylineContour(ring);
+    std::vector<Point2D> sweep(100000), search(100000);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    utilities::resampleUniform(large, sweep.size(), sweep.data());
+    auto middle = std::chrono::high_resolution_clock::now();
+    const double largeSpacing = large.getTotalLength() / (search.size() - 1);
+    for (size_t i = 0; i < search.size(); ++i)
+    {
+        search[i] = large.pointAtDistance(std::min(i * largeSpacing, large.getTotalLength()));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Resample " << sweep.size() << " points: sweep "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, pointAtDistance "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("Large resample matches", sweep[sweep.size() / 2].isEqual(search[search.size() / 2], 1e-9));
+}
+
+// Test level-of-detail flattening for display
+void testDisplaySimplification(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Display Simplification ===" << std::endl;
+
+    std::vector<Point2D> points;
+    std::vector<size_t> starts;
+
+    // Distance from p to the polyline points[begin, end)
+    auto distanceToPolyline = [&points](const Point2D& p, size_t begin, size_t end) {
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t i = begin; i + 1 < end; ++i)
+        {
+            best = std::min(best, createLineSegment(points[i], points[i + 1])->distanceTo(p));
+        }
+        return end - begin == 1 ? points[begin].distanceTo(p) : best;
+    };
+
+    // A wiggly polyline of many sub-tolerance segments
+    std::vector<Point2D> wiggle;
+    for (int i = 0; i <= 10000; ++i)
+    {
+        wiggle.emplace_back(i * 0.01, 0.05 * std::sin(i * 0.3));
+    }
+    Contour dense = utilities::createPolylineContour(wiggle);
+    const double tolerance = 0.5;
+    utilities::simplifyForDisplay(dense, 0, dense.size(), tolerance, points, starts);
+    suite.runTest("Dense polyline becomes one short polyline", starts.size() == 1 && points.size() <= 2 + 100.0 / tolerance);
+    suite.runTest("Simplified ends are exact", points.front().isEqual(wiggle.front()) && points.back().isEqual(wiggle.back()));
+    bool spaced = true;
+    for (size_t i = 1; i + 1 < points.size(); ++i)
+    {
+        spaced = spaced && points[i - 1].distanceTo(points[i]) >= tolerance;
+    }
+    suite.runTest("Kept vertices are at least tolerance apart", spaced);
+    bool close = true;
+    for (size_t i = 0; i < wiggle.size() && close; i += 7)
+    {
+        close = distanceToPolyline(wiggle[i], 0, points.size()) < tolerance;
+    }
+    suite.runTest("Every original vertex is within tolerance", close);
+
+    // Arcs are flattened within tolerance
+    Contour circle;
+    circle.addSegment(createArcSegment(Point2D(0.0, 0.0), 100.0, 0.0, PI, false));
+    circle.addSegment(createArcSegment(Point2D(0.0, 0.0), 100.0, PI, 0.0, false));
+    utilities::simplifyForDisplay(circle, 0, circle.size(), tolerance, points, starts);
+    bool onCircle = starts.size() == 1 && points.size() > 8 && points.size() < 100;
+    for (int k = 0; k < 360 && onCircle; ++k)
+    {
+        const Point2D p(100.0 * std::cos(k * PI / 180.0), 100.0 * std::sin(k * PI / 180.0));
+        onCircle = distanceToPolyline(p, 0, points.size()) < tolerance;
+    }
+    suite.runTest("Circle flattened within chord tolerance", onCircle);
+
+    // Gaps start new polylines; pieces smaller than tolerance vanish
+    Contour pieces;
+    pieces.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(10.0, 0.0)));
+    pieces.addSegment(createLineSegment(Point2D(20.0, 0.0), Point2D(30.0, 0.0)));
+    pieces.addSegment(createLineSegment(Point2D(50.0, 0.0), Point2D(50.1, 0.0)));
+    utilities::simplifyForDisplay(pieces, 0, pieces.size(), tolerance, points, starts);
+    suite.runTest("Disconnected segments split polylines", starts.size() == 2 && starts[1] == 2 && points.size() == 4);
+    utilities::simplifyForDisplay(pieces, 1, 2, tolerance, points, starts);
+    suite.runTest("Segment range is honoured", starts.size() == 1 && points.front().isEqual(Point2D(20.0, 0.0)));
+    utilities::simplifyForDisplay(pieces, 2, 3, tolerance, points, starts);
+    suite.runTest("Sub-tolerance segments are dropped", starts.empty() && points.empty());
+
+    bool threw = false;
+    try { utilities::simplifyForDisplay(pieces, 0, 3, 0.0, points, starts); } catch (const std::invalid_argument&) { threw = true; }
+    suite.runTest("Tolerance must be positive", threw);
+    threw = false;
+    try { utilities::simplifyForDisplay(pieces, 2, 4, 1.0, points, starts); } catch (const std::out_of_range&) { threw = true; }
+    suite.runTest("Range must lie inside the contour", threw);
+
+    // A million-segment contour at a zoom where each segment is sub-pixel
+    std::vector<Point2D> spiral;
+    for (int i = 0; i <= 1000000; ++i)
+    {
+        const double angle = i * 0.0005;
+        spiral.emplace_back((100.0 + angle) * std::cos(angle), (100.0 + angle) * std::sin(angle));
+    }
+    Contour huge = utilities::createPolylineContour(spiral);
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t kept = 0;
+    for (size_t first = 0; first < huge.size(); first += 4096)
+    {
+        utilities::simplifyForDisplay(huge, first, std::min(huge.size(), first + 4096), 2.0, points, starts);
+        kept += points.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Simplified " << huge.size() << " segments to " << kept << " vertices in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    suite.runTest("Huge contour collapses at coarse tolerance", kept < huge.size() / 10);
+}
+
+// Test arena-backed contour construction
+void testMemoryResource(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Memory Resources ===" << std::endl;
+    
+    std::pmr::monotonic_buffer_resource arena;
+    {
+        // With a null default resource, any allocation outside the arena throws
+        std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        bool arenaOnly = true;
+        try
+        {
+            ContourBuilder builder(&arena);
+            builder.addLine(Point2D(0.0, 0.0), Point2D(1.0, 0.0))
+                   .addArc(Point2D(1.0, 1.0), 1.0, -PI/2, 0.0, false)
+                   .addLine(Point2D(2.0, 1.0), Point2D(0.0, 0.0));
+            Contour contour = std::move(builder).build();
+            arenaOnly = contour.getResource() == &arena && contour.isValid() && contour.size() == 3;
+        }
+        catch (const std::bad_alloc&)
+        {
+            arenaOnly = false;
+        }
+        std::pmr::set_default_resource(previous);
+        suite.runTest("Builder allocates only from the arena", arenaOnly);
+    }
+    
+    std::vector<Point2D> square = { Point2D(0.0, 0.0), Point2D(1.0, 0.0), Point2D(1.0, 1.0), Point2D(0.0, 1.0) };
+    utilities::PolylineOptions options;
+    options.closePath = true;
+    Contour arenaSquare = utilities::createPolylineContour(square, options, &arena);
+    Contour sharedCopy = arenaSquare;
+    Contour arenaCopy(sharedCopy, &arena);
+    suite.runTest("Copy shares the arena", sharedCopy.getResource() == &arena &&
+                  sharedCopy.sharesStorageWith(arenaSquare) && sharedCopy == arenaSquare);
+    suite.runTest("Copy into a resource", arenaCopy.getResource() == &arena && arenaCopy.isClosed());
+    
+    // Plain unique_ptr segments still mix with arena segments
+    arenaCopy.replaceSegment(0, createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    arenaCopy.insertSegment(0, cloneSegment(arenaSquare[3], &arena));
+    suite.runTest("Mixed segment origins", arenaCopy.size() == 5 && arenaCopy[0].isEqual(arenaSquare[3]));
+    
+    // Batch of polylines: one heap allocation per segment vs one shared arena
+    const int contourCount = 20;
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 50000; ++i)
+    {
+        points.emplace_back(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0);
+    }
+    
+    double heapLength = 0.0;
+    double arenaLength = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<Contour> batch;
+        for (int i = 0; i < contourCount; ++i)
+        {
+            batch.push_back(utilities::createPolylineContour(points));
+        }
+        heapLength = batch.back().getTotalLength();
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    {
+        std::pmr::monotonic_buffer_resource batchArena;
+        std::vector<Contour> batch;
+        for (int i = 0; i < contourCount; ++i)
+        {
+            batch.push_back(utilities::createPolylineContour(points, &batchArena));
+        }
+        arenaLength = batch.back().getTotalLength();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Build and free " << contourCount << " x " << points.size() - 1 << " segments: heap "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, arena "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("Arena batch matches heap batch", isEqual(heapLength, arenaLength));
+}
+
+// Test the bounding-volume hierarchy queries against brute force
+void testSpatialQueries(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Spatial Queries ===" << std::endl;
+    
+    auto line = createLineSegment(Point2D(0.0, 0.0), Point2D(4.0, 0.0));
+    suite.runTest("Line distance", isEqual(line->distanceTo(Point2D(2.0, 3.0)), 3.0) &&
+                  isEqual(line->distanceTo(Point2D(7.0, 4.0)), 5.0));
+    auto arc = createArcSegment(Point2D(0.0, 0.0), 2.0, 0.0, PI/2, false);
+    suite.runTest("Arc distance", isEqual(arc->distanceTo(Point2D(3.0, 3.0)), std::sqrt(18.0) - 2.0) &&
+                  isEqual(arc->distanceTo(Point2D(0.0, -1.0)), std::sqrt(5.0)) &&
+                  isEqual(arc->distanceTo(Point2D(0.0, 0.0)), 2.0));
+    
+    // Scattered lines and arcs over several chunks, edited so chunks are uneven
+    std::mt19937 random(777);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    std::uniform_real_distribution<double> offset(-15.0, 15.0);
+    auto randomSegment = [&]() -> std::unique_ptr<Segment> {
+        const Point2D a(coordinate(random), coordinate(random));
+        if (random() % 3 == 0)
+        {
+            const double startAngle = coordinate(random) / 100.0;
+            return createArcSegment(a, 1.0 + std::abs(offset(random)), startAngle, startAngle + 1.0 + offset(random) / 10.0, random() % 2 == 0);
+        }
+        return createLineSegment(a, Point2D(a.x + offset(random), a.y + offset(random)));
+    };
+    
+    Contour contour;
+    for (int i = 0; i < 1500; ++i)
+    {
+        contour.addSegment(randomSegment());
+    }
+    for (int i = 0; i < 300; ++i)
+    {
+        contour.insertSegment(random() % contour.size(), randomSegment());
+        contour.removeSegment(random() % contour.size());
+        contour.replaceSegment(random() % contour.size(), randomSegment());
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        contour.addSegment(randomSegment());
+    }
+    
+    bool rangeMatches = true;
+    bool nearestMatches = true;
+    for (int q = 0; q < 200; ++q)
+    {
+        const Point2D corner(coordinate(random), coordinate(random));
+        BoundingBox range(corner, Point2D(corner.x + 60.0, corner.y + 40.0));
+        std::vector<Contour::size_type> expected;
+        double best = std::numeric_limits<double>::infinity();
+        for (Contour::size_type i = 0; i < contour.size(); ++i)
+        {
+            if (contour[i].getBoundingBox().intersects(range))
+            {
+                expected.push_back(i);
+            }
+            best = std::min(best, contour[i].distanceTo(corner));
+        }
+        rangeMatches = rangeMatches && contour.segmentsInBox(range) == expected;
+        nearestMatches = nearestMatches && isEqual(contour[contour.nearestSegment(corner)].distanceTo(corner), best);
+    }
+    suite.runTest("Range queries match brute force", rangeMatches);
+    suite.runTest("Nearest queries match brute force", nearestMatches);
+    
+    std::vector<std::pair<Contour::size_type, Contour::size_type>> expectedPairs;
+    for (Contour::size_type i = 0; i < contour.size(); ++i)
+    {
+        const BoundingBox box = contour[i].getBoundingBox();
+        for (Contour::size_type j = i + 1; j < contour.size(); ++j)
+        {
+            if (box.intersects(contour[j].getBoundingBox()))
+            {
+                expectedPairs.emplace_back(i, j);
+            }
+        }
+    }
+    suite.runTest("Overlap pairs match brute force", contour.overlappingSegments() == expectedPairs);
+    
+    Contour other;
+    for (int i = 0; i < 700; ++i)
+    {
+        other.addSegment(randomSegment());
+    }
+    std::vector<std::pair<Contour::size_type, Contour::size_type>> expectedCross;
+    for (Contour::size_type i = 0; i < contour.size(); ++i)
+    {
+        const BoundingBox box = contour[i].getBoundingBox();
+        for (Contour::size_type j = 0; j < other.size(); ++j)
+        {
+            if (box.intersects(other[j].getBoundingBox()))
+            {
+                expectedCross.emplace_back(i, j);
+            }
+        }
+    }
+    suite.runTest("Cross-contour overlap pairs match brute force", contour.overlappingSegments(other) == expectedCross);
+    
+    bool threw = false;
+    try
+    {
+        Contour().nearestSegment(Point2D(0.0, 0.0));
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    suite.runTest("Nearest on empty contour throws", threw);
+    
+    // Indexed vs linear range queries on a long zigzag
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 200000; ++i)
+    {
+        points.emplace_back(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0);
+    }
+    Contour large = utilities::createPolylineContour(points);
+    const int queries = 200;
+    std::size_t indexedHits = 0;
+    std::size_t linearHits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int q = 0; q < queries; ++q)
+    {
+        const double x = static_cast<double>((q * 997) % 200000);
+        indexedHits += large.segmentsInBox(BoundingBox(Point2D(x, 0.2), Point2D(x + 10.0, 0.8))).size();
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int q = 0; q < queries; ++q)
+    {
+        const double x = static_cast<double>((q * 997) % 200000);
+        const BoundingBox range(Point2D(x, 0.2), Point2D(x + 10.0, 0.8));
+        for (const auto& segment : large)
+        {
+            linearHits += segment->getBoundingBox().intersects(range) ? 1 : 0;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << queries << " range queries over " << large.size() << " segments: indexed "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, linear "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("Indexed and linear range queries agree", indexedHits == linearHits && indexedHits > 0);
+}
+
+// Test the uniform-grid hash used for editor hit-testing
+void testGridHash(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Grid Hash ===" << std::endl;
+
+    using contour::spatial::GridHash;
+
+    GridHash grid(10.0);
+    grid.insert(0, Point2D(1.0, 1.0));
+    grid.insert(1, Point2D(-1.0, -1.0));
+    grid.insert(2, BoundingBox(Point2D(5.0, 5.0), Point2D(35.0, 15.0)));
+
+    auto collect = [&grid](const BoundingBox& range) {
+        std::set<std::size_t> found;
+        grid.query(range, [&found](std::size_t item) { found.insert(item); });
+        return found;
+    };
+
+    suite.runTest("Point query finds its cell", collect(BoundingBox(Point2D(0.5, 0.5), Point2D(1.5, 1.5))) == std::set<std::size_t>{ 0, 2 });
+    suite.runTest("Negative coordinates use their own cells", collect(BoundingBox(Point2D(-2.0, -2.0), Point2D(-0.5, -0.5))) == std::set<std::size_t>{ 1 });
+    suite.runTest("Box items are found in every cell they touch", collect(BoundingBox(Point2D(31.0, 11.0), Point2D(32.0, 12.0))) == std::set<std::size_t>{ 2 });
+
+    grid.erase(2, BoundingBox(Point2D(5.0, 5.0), Point2D(35.0, 15.0)));
+    grid.erase(0, Point2D(1.0, 1.0));
+    suite.runTest("Erase removes items from all their cells", collect(BoundingBox(Point2D(-50.0, -50.0), Point2D(50.0, 50.0))) == std::set<std::size_t>{ 1 });
+
+    grid.insert(3, BoundingBox(Point2D(-1e9, -1e9), Point2D(1e9, 1e9)));
+    suite.runTest("Huge boxes are kept out of the cell table", grid.cellCount() == 1 && collect(BoundingBox(Point2D(500.0, 500.0), Point2D(501.0, 501.0))) == std::set<std::size_t>{ 3 });
+    grid.erase(3, BoundingBox(Point2D(-1e9, -1e9), Point2D(1e9, 1e9)));
+    grid.clear();
+    suite.runTest("Clear empties the hash", grid.empty());
+
+    bool threw = false;
+    try
+    {
+        grid.setCellSize(0.0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    suite.runTest("Non-positive cell size is rejected", threw);
+
+    // Random points with moves, checked against a linear scan of the same points
+    std::mt19937 random(2024);
+    std::uniform_real_distribution<double> coordinate(-500.0, 500.0);
+    std::vector<Point2D> points(2000);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = Point2D(coordinate(random), coordinate(random));
+        grid.insert(i, points[i]);
+    }
+    for (std::size_t i = 0; i < points.size(); i += 3)
+    {
+        grid.erase(i, points[i]);
+        points[i] = Point2D(coordinate(random), coordinate(random));
+        grid.insert(i, points[i]);
+    }
+    bool agrees = true;
+    for (int q = 0; q < 200 && agrees; ++q)
+    {
+        const Point2D center(coordinate(random), coordinate(random));
+        const double tolerance = 6.0;
+        const BoundingBox range(Point2D(center.x - tolerance, center.y - tolerance), Point2D(center.x + tolerance, center.y + tolerance));
+        std::set<std::size_t> hashed;
+        grid.query(range, [&](std::size_t item) {
+            if (points[item].distanceTo(center) <= tolerance)
+            {
+                hashed.insert(item);
+            }
+        });
+        std::set<std::size_t> scanned;
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            if (points[i].distanceTo(center) <= tolerance)
+            {
+                scanned.insert(i);
+            }
+        }
+        agrees = hashed == scanned;
+    }
+    suite.runTest("Radius queries agree with a linear scan", agrees);
+}
+
+// Test leveled asynchronous logging
+void testLogging(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Logging ===" << std::endl;
+
+    namespace lg = contour::log;
+
+    std::vector<lg::Record> records;
+    std::mutex recordsMutex;
+    lg::setSink([&records, &recordsMutex](const lg::Record& record) {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        records.push_back(record);
+    });
+    const lg::Level savedLevel = lg::getLevel();
+    const std::uint32_t savedCategories = lg::getCategories();
+
+    lg::setLevel(lg::Level::Info);
+    lg::setCategories(lg::AllCategories);
+    int evaluated = 0;
+    auto count = [&evaluated]() { return ++evaluated; };
+    CONTOUR_DEBUG(lg::Scene, "hidden " << count());
+    CONTOUR_INFO(lg::Scene, "shown " << count());
+    CONTOUR_ERROR(lg::Core, "error " << 42);
+    lg::flush();
+    suite.runTest("Records below the level are not formatted", evaluated == 1);
+    suite.runTest("Enabled records reach the sink in order",
+        records.size() == 2 && records[0].message == "shown 1" && records[1].message == "error 42"
+        && records[1].level == lg::Level::Error && records[1].category == lg::Core);
+
+    records.clear();
+    lg::setCategories(lg::Core);
+    CONTOUR_WARNING(lg::Scene, "filtered");
+    CONTOUR_WARNING(lg::Core, "kept");
+    lg::flush();
+    suite.runTest("Category mask filters records", records.size() == 1 && records[0].message == "kept");
+
+    records.clear();
+    lg::setLevel(lg::Level::Trace);
+    lg::setCategories(lg::AllCategories);
+    CONTOUR_TRACE(lg::Input, "trace " << count());
+    lg::flush();
+#ifdef NDEBUG
+    suite.runTest("Trace is compiled out of release builds", records.empty() && evaluated == 1);
+#else
+    suite.runTest("Trace is kept in debug builds", records.size() == 1 && records[0].level == lg::Level::Trace);
+#endif
+
+    records.clear();
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t)
+    {
+        writers.emplace_back([t]() {
+            for (int i = 0; i < 500; ++i)
+            {
+                CONTOUR_INFO(lg::Render, t << ":" << i);
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    lg::flush();
+    suite.runTest("Concurrent writers lose nothing unless the ring overflows",
+        records.size() + lg::getDroppedCount() >= 2000 && records.size() <= 2000);
+
+    suite.runTest("Level and category names", std::string(lg::levelName(lg::Level::Warning)) == "WARNING"
+        && std::string(lg::categoryName(lg::Scene)) == "scene");
+
+    lg::setSink(nullptr);
+    lg::setLevel(savedLevel);
+    lg::setCategories(savedCategories);
+}
+
+// Test the binary .cnt contour format
+void testContourIO(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Contour File I/O ===" << std::endl;
+
+    ContourBuilder builder;
+    builder.addLine(Point2D(0.0, 0.0), Point2D(10.0, 0.0))
+        .addArc(Point2D(10.0, 5.0), 5.0, -PI / 2, PI / 2)
+        .addArc(Point2D(10.0, 15.0), 5.0, -PI / 2, PI / 2, true)
+        .addLine(Point2D(10.0, 20.0), Point2D(0.1 + 0.2, 1e-300));
+    Contour mixed = std::move(builder).build();
+
+    std::stringstream stream;
+    io::writeContour(stream, mixed);
+    const std::string bytes = stream.str();
+    suite.runTest("File size is header, padded tags and packed doubles",
+        bytes.size() == io::CNT_HEADER_SIZE + 8 + (2 * io::LINE_DOUBLES + 2 * io::ARC_DOUBLES) * sizeof(double));
+    suite.runTest("File starts with the magic", bytes.compare(0, 4, "CNTR") == 0);
+
+    // Any nonzero difference is at least denorm_min, so this compares exactly
+    const double exactly = std::numeric_limits<double>::denorm_min();
+    Contour loaded = io::readContour(stream);
+    bool exact = loaded.size() == mixed.size();
+    for (std::size_t i = 0; exact && i < mixed.size(); ++i)
+    {
+        exact = mixed[i].isEqual(loaded[i], exactly);
+    }
+    suite.runTest("Round trip preserves every segment bit for bit", exact);
+    suite.runTest("Arc direction survives the round trip",
+        static_cast<const ArcSegment&>(loaded[2]).isClockwise() && !static_cast<const ArcSegment&>(loaded[1]).isClockwise());
+
+    std::stringstream twoFiles;
+    io::writeContour(twoFiles, Contour());
+    io::writeContour(twoFiles, mixed);
+    Contour first = io::readContour(twoFiles);
+    Contour second = io::readContour(twoFiles);
+    suite.runTest("Concatenated files read back one after another", first.empty() && second.isEqual(mixed, exactly));
+
+    auto rejects = [](std::string data) {
+        std::istringstream in(data);
+        try
+        {
+            io::readContour(in);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    };
+    std::string badMagic = bytes;
+    badMagic[0] = 'X';
+    std::string badVersion = bytes;
+    badVersion[4] = 9;
+    std::string badTag = bytes;
+    badTag[io::CNT_HEADER_SIZE + 1] = 7;
+    std::string hugeCount = bytes;
+    hugeCount[22] = 0x7F;
+    // The first arc's start angle is the fourth double after the line's four
+    const std::size_t arcStartAngle = io::CNT_HEADER_SIZE + 8 + (io::LINE_DOUBLES + 3) * sizeof(double);
+    std::string hugeAngle = bytes;
+    io::detail::storeDouble(reinterpret_cast<unsigned char*>(&hugeAngle[arcStartAngle]), 1e300);
+    std::string infiniteAngle = bytes;
+    io::detail::storeDouble(reinterpret_cast<unsigned char*>(&infiniteAngle[arcStartAngle]), std::numeric_limits<double>::infinity());
+    suite.runTest("Wrong magic is rejected", rejects(badMagic));
+    suite.runTest("Unknown version is rejected", rejects(badVersion));
+    suite.runTest("Unknown segment tag is rejected", rejects(badTag));
+    suite.runTest("Truncated file is rejected", rejects(bytes.substr(0, bytes.size() - 3)));
+    suite.runTest("Corrupt segment count is rejected without allocating it", rejects(hugeCount));
+    suite.runTest("Corrupt arc angles are rejected instead of hanging", rejects(hugeAngle) && rejects(infiniteAngle));
+    suite.runTest("Huge angles normalize in bounded time",
+        geometry::isEqual(ArcSegment(Point2D(0.0, 0.0), 1.0, 1e300, 1.0).getEndAngle(), 1.0)
+        && ArcSegment(Point2D(0.0, 0.0), 1.0, 4.0 * PI + 0.5, 1.0).getStartAngle() < 2.0 * PI);
+
+    std::vector<Point2D> points;
+    const std::size_t segmentCount = 200000;
+    for (std::size_t i = 0; i <= segmentCount; ++i)
+    {
+        points.emplace_back(static_cast<double>(i), std::sin(0.001 * static_cast<double>(i)));
+    }
+    Contour large = utilities::createPolylineContour(points);
+    const std::string path = (std::filesystem::temp_directory_path() / "contour_io_test.cnt").string();
+    auto start = std::chrono::high_resolution_clock::now();
+    io::writeContour(path, large);
+    auto written = std::chrono::high_resolution_clock::now();
+    Contour reloaded = io::readContour(path);
+    auto read = std::chrono::high_resolution_clock::now();
+    std::remove(path.c_str());
+    std::cout << "Wrote " << segmentCount << " segments in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(written - start).count() << " ms, read them in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(read - written).count() << " ms" << std::endl;
+    suite.runTest("Large contour round trips through a file",
+        reloaded.size() == segmentCount && reloaded.isValid() && reloaded.getTotalLength() == large.getTotalLength());
+
+    bool missingThrows = false;
+    try
+    {
+        io::readContour(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        missingThrows = true;
+    }
+    suite.runTest("Missing file throws", missingThrows);
+}
+
+// Test zero-copy views of memory-mapped .cnt files
+void testMappedContour(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Memory-Mapped Contours ===" << std::endl;
+
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 1000; ++i)
+    {
+        points.emplace_back(std::cos(0.01 * i) * i, std::sin(0.01 * i) * i);
+    }
+    Contour spiral = utilities::createPolylineContour(points);
+    ContourBuilder builder;
+    builder.addLine(Point2D(0.0, 0.0), Point2D(10.0, 0.0))
+        .addArc(Point2D(10.0, 5.0), 5.0, -PI / 2, PI / 2)
+        .addLine(Point2D(10.0, 10.0), Point2D(0.0, 10.0))
+        .addArc(Point2D(0.0, 5.0), 5.0, PI / 2, -PI / 2);
+    Contour rounded = std::move(builder).build();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "contour_mapped_test.cnt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        io::writeContour(out, spiral);
+        io::writeContour(out, rounded);
+    }
+
+    {
+        io::MappedFile file(path);
+        io::MappedContour first(file);
+        io::MappedContour second(file, first.endOffset());
+        suite.runTest("Archive holds two contours back to back",
+            first.size() == spiral.size() && second.size() == rounded.size() && second.endOffset() == file.size());
+
+        std::size_t visited = 0;
+        for (const SegmentVariant& segment : first)
+        {
+            visited += std::holds_alternative<LineSegment>(segment) ? 1 : 0;
+        }
+        suite.runTest("Iteration decodes every segment", visited == spiral.size());
+
+        suite.runTest("Total length matches the contour", std::abs(first.getTotalLength() - spiral.getTotalLength()) < 1e-9 * spiral.getTotalLength()
+            && std::abs(second.getTotalLength() - rounded.getTotalLength()) < 1e-12);
+        auto sameVertices = [](const std::vector<Point2D>& a, const std::vector<Point2D>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Point2D& p, const Point2D& q) {
+                return p.x == q.x && p.y == q.y;
+            });
+        };
+        suite.runTest("Vertices match the contour", sameVertices(first.getVertices(), spiral.getVertices())
+            && sameVertices(second.getVertices(), rounded.getVertices()));
+        BoundingBox box = second.getBoundingBox();
+        BoundingBox expected = rounded.getBoundingBox();
+        suite.runTest("Bounds include arc extremes", box.minPoint.x == expected.minPoint.x && box.maxPoint.x == expected.maxPoint.x
+            && box.minPoint.y == expected.minPoint.y && box.maxPoint.y == expected.maxPoint.y);
+        suite.runTest("Validity and closure match the contour",
+            first.isValid() && !first.isClosed() && second.isValid() && second.isClosed());
+        suite.runTest("toContour copies every segment", second.toContour().isEqual(rounded, std::numeric_limits<double>::denorm_min()));
+
+        bool pastEnd = false;
+        try
+        {
+            io::MappedContour third(file, second.endOffset());
+        }
+        catch (const std::runtime_error&)
+        {
+            pastEnd = true;
+        }
+        suite.runTest("Viewing past the last contour throws", pastEnd);
+    }
+
+    {
+        std::fstream corrupt(path, std::ios::binary | std::ios::in | std::ios::out);
+        corrupt.seekp(static_cast<std::streamoff>(io::CNT_HEADER_SIZE + 3));
+        corrupt.put(static_cast<char>(9));
+    }
+    {
+        io::MappedFile file(path);
+        io::MappedContour view(file);
+        bool badTag = false;
+        try
+        {
+            view.getTotalLength();
+        }
+        catch (const std::runtime_error&)
+        {
+            badTag = true;
+        }
+        suite.runTest("Unknown tag is reported when it is decoded", badTag);
+    }
+
+    {
+        std::stringstream stream;
+        io::writeContour(stream, rounded);
+        std::string bytes = stream.str();
+        // The first arc's start angle follows the line's four doubles and its own three
+        io::detail::storeDouble(reinterpret_cast<unsigned char*>(&bytes[io::CNT_HEADER_SIZE + 8 + (io::LINE_DOUBLES + 3) * sizeof(double)]), -1e300);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+    }
+    {
+        io::MappedFile file(path);
+        io::MappedContour view(file);
+        bool badAngle = false;
+        try
+        {
+            view.getTotalLength();
+        }
+        catch (const std::runtime_error&)
+        {
+            badAngle = true;
+        }
+        suite.runTest("Corrupt arc angle is reported instead of hanging", badAngle);
+    }
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    {
+        io::MappedFile empty(path);
+        bool tooShort = false;
+        try
+        {
+            io::MappedContour view(empty);
+        }
+        catch (const std::runtime_error&)
+        {
+            tooShort = true;
+        }
+        suite.runTest("Empty file maps but holds no contour", empty.size() == 0 && tooShort);
+    }
+    std::remove(path.c_str());
+
+    bool missing = false;
+    try
+    {
+        io::MappedFile file(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        missing = true;
+    }
+    suite.runTest("Missing file throws", missing);
+}
+
+// Single-pass source of points on a circle, standing in for a point stream
+class CirclePointStream
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Point2D;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Point2D*;
+    using reference = Point2D;
+
+    CirclePointStream() = default;
+    explicit CirclePointStream(int count) : m_remaining(count) {}
+
+    Point2D operator*() const
+    {
+        const double angle = 2.0 * PI * m_index / 360.0;
+        return Point2D(100.0 * std::cos(angle), 100.0 * std::sin(angle));
+    }
+    CirclePointStream& operator++() { ++m_index; --m_remaining; return *this; }
+    bool operator==(const CirclePointStream& other) const { return m_remaining == other.m_remaining; }
+    bool operator!=(const CirclePointStream& other) const { return !(*this == other); }
+
+private:
+    int m_index = 0;
+    int m_remaining = 0;
+};
+
+// Test streaming contour archives
+void testContourStreaming(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Contour Streaming ===" << std::endl;
+
+    const double exactly = std::numeric_limits<double>::denorm_min();
+    ContourBuilder builder;
+    for (int i = 0; i < 5; ++i)
+    {
+        const double x = 20.0 * i;
+        builder.addLine(Point2D(x, 0.0), Point2D(x + 10.0, 0.0))
+            .addArc(Point2D(x + 15.0, 0.0), 5.0, PI, 0.0, true);
+    }
+    Contour wavy = std::move(builder).build();
+
+    std::stringstream archive;
+    {
+        io::ContourWriter writer(archive, 3);
+        writer.writeContour(wavy);
+        writer.endContour();
+        writer.addPoint(Point2D(0.0, 0.0));
+        writer.addPoint(Point2D(0.0, 0.0));
+        writer.addPoint(Point2D(1.0, 0.0));
+        writer.addPoint(Point2D(1.0, 1.0));
+        writer.addPoint(Point2D(1.0, 1.0));
+        writer.addPoint(Point2D(0.0, 1.0));
+        suite.runTest("Writer counts finished contours", writer.getContourCount() == 2);
+    }
+
+    {
+        io::ContourReader reader(archive);
+        std::vector<SegmentVariant> block;
+        std::vector<std::size_t> blockSizes;
+        reader.nextContour();
+        while (reader.readSegments(block, 4) > 0)
+        {
+            blockSizes.push_back(block.size());
+        }
+        suite.runTest("Blocks span the continued records of one contour",
+            blockSizes == std::vector<std::size_t>{ 4, 4, 2 });
+
+        Contour empty;
+        empty.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 1.0)));
+        Contour polyline;
+        const bool readBoth = reader.read(empty) && reader.read(polyline);
+        suite.runTest("Empty contour reads back empty", readBoth && empty.empty());
+        suite.runTest("Points become the same lines as createPolylineContour",
+            readBoth && polyline.isEqual(utilities::createPolylineContour({ Point2D(0.0, 0.0), Point2D(0.0, 0.0), Point2D(1.0, 0.0),
+                Point2D(1.0, 1.0), Point2D(1.0, 1.0), Point2D(0.0, 1.0) }), exactly));
+        Contour none;
+        suite.runTest("Reader stops cleanly at the end", !reader.read(none) && !reader.nextContour());
+    }
+
+    archive.clear();
+    archive.seekg(0);
+    suite.runTest("readContour joins continued records", io::readContour(archive).isEqual(wavy, exactly));
+
+    std::stringstream skipping(archive.str());
+    {
+        io::ContourReader reader(skipping);
+        std::vector<SegmentVariant> block;
+        reader.nextContour();
+        reader.readSegments(block, 1);
+        reader.nextContour();
+        reader.nextContour();
+        reader.readSegments(block, 100);
+        suite.runTest("nextContour skips the rest of a partly read contour", block.size() == 3);
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "contour_stream_test.cnt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << archive.str();
+    }
+    {
+        io::MappedFile file(path);
+        io::MappedContour mapped(file);
+        std::size_t visited = 0;
+        for (auto it = mapped.begin(); it != mapped.end(); ++it)
+        {
+            ++visited;
+        }
+        io::MappedContour empty(file, mapped.endOffset());
+        suite.runTest("MappedContour views continued records as one contour",
+            mapped.size() == wavy.size() && visited == wavy.size() && mapped.toContour().isEqual(wavy, exactly)
+            && empty.empty() && empty.begin() == empty.end());
+    }
+    std::remove(path.c_str());
+
+    bool zeroBlock = false;
+    try
+    {
+        io::ContourWriter writer(archive, 0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        zeroBlock = true;
+    }
+    suite.runTest("Zero block size is rejected", zeroBlock);
+
+    Contour streamed = utilities::createPolylineContour(CirclePointStream(361), CirclePointStream());
+    std::vector<Point2D> points(CirclePointStream(361), CirclePointStream());
+    suite.runTest("createPolylineContour consumes a single-pass point stream",
+        streamed.size() == 360 && streamed.isClosed(1e-9) && streamed.isEqual(utilities::createPolylineContour(points), exactly));
+}
+
+// Test delta + varint compressed records
+void testContourCompression(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Contour Compression ===" << std::endl;
+
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 2000; ++i)
+    {
+        const double angle = 2.0 * PI * i / 2000.0;
+        points.emplace_back(100.0 + 50.0 * std::cos(angle), 50.0 + 50.0 * std::sin(angle));
+    }
+    Contour circle = utilities::createPolylineContour(points);
+
+    std::stringstream plain;
+    io::writeContour(plain, circle);
+    std::stringstream packed;
+    io::writeCompressedContour(packed, circle);
+    suite.runTest("Compressed polyline is at least 5x smaller", packed.str().size() * 5 <= plain.str().size());
+
+    Contour unpacked = io::readContour(packed);
+    const std::vector<Point2D> original = circle.getVertices();
+    const std::vector<Point2D> decoded = unpacked.getVertices();
+    bool withinResolution = original.size() == decoded.size();
+    for (std::size_t i = 0; withinResolution && i < original.size(); ++i)
+    {
+        withinResolution = original[i].isEqual(decoded[i], io::CNT_DEFAULT_RESOLUTION);
+    }
+    suite.runTest("Polyline vertices survive within the resolution",
+        unpacked.size() == circle.size() && withinResolution && unpacked.isValid() && unpacked.isClosed());
+
+    ContourBuilder builder;
+    for (int i = 0; i < 5; ++i)
+    {
+        const double x = 20.0 * i;
+        builder.addLine(Point2D(x, 0.0), Point2D(x + 10.0, 0.0))
+            .addArc(Point2D(x + 15.0, 0.0), 5.0, PI, 0.0, true);
+    }
+    Contour wavy = std::move(builder).build();
+    wavy.addSegment(createArcSegment(Point2D(-5.0, 30.0), 2.5, 0.25, 2.0));
+    wavy.addSegment(createLineSegment(Point2D(7.0, 7.0), Point2D(-7.0, 3.0)));
+
+    // Quantized angles may wrap past 2*PI, so arcs are compared by their ends
+    auto sameEnds = [](const Contour& lhs, const Contour& rhs, double epsilon) {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (lhs[i].getType() != rhs[i].getType() || !lhs[i].getStartPoint().isEqual(rhs[i].getStartPoint(), epsilon)
+                || !lhs[i].getEndPoint().isEqual(rhs[i].getEndPoint(), epsilon))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::stringstream archive;
+    {
+        io::ContourWriter writer(archive, 4);
+        writer.setCompression(1e-4);
+        writer.writeContour(wavy);
+        writer.setCompression(0.0);
+        writer.writeContour(circle);
+    }
+    {
+        io::ContourReader reader(archive);
+        Contour first;
+        Contour second;
+        const bool readBoth = reader.read(first) && reader.read(second);
+        bool jointsClosed = readBoth;
+        for (std::size_t i = 1; jointsClosed && i < 10; ++i)
+        {
+            jointsClosed = first[i - 1].getEndPoint().isEqual(first[i].getStartPoint());
+        }
+        suite.runTest("Arcs and detached segments round-trip through compressed records",
+            readBoth && sameEnds(first, wavy, 1e-3));
+        suite.runTest("Joints stay closed after quantization", jointsClosed);
+        suite.runTest("Compressed and plain records mix in one archive",
+            readBoth && second.isEqual(circle, std::numeric_limits<double>::denorm_min()));
+    }
+
+    Contour tiny;
+    tiny.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    tiny.addSegment(createLineSegment(Point2D(1.0, 0.0), Point2D(1.01, 0.0)));
+    std::stringstream untouched;
+    bool collapsed = false;
+    try
+    {
+        io::writeCompressedContour(untouched, tiny, 0.1);
+    }
+    catch (const std::invalid_argument&)
+    {
+        collapsed = true;
+    }
+    suite.runTest("Segment collapsing at the resolution is rejected before writing", collapsed && untouched.str().empty());
+
+    bool badResolution = false;
+    try
+    {
+        io::DeltaEncoder encoder(-1.0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        badResolution = true;
+    }
+    bool openContour = false;
+    try
+    {
+        std::stringstream out;
+        io::ContourWriter writer(out);
+        writer.addPoint(Point2D(0.0, 0.0));
+        writer.setCompression(1e-3);
+    }
+    catch (const std::logic_error&)
+    {
+        openContour = true;
+    }
+    suite.runTest("Bad resolutions and mid-contour switches are rejected", badResolution && openContour);
+
+    // One detached arc whose start angle step count is corrupted to 2^63 - 1
+    std::string hugeSteps(io::CNT_HEADER_SIZE + 24, '\0');
+    {
+        io::CntHeader header;
+        header.flags = io::CNT_FLAG_COMPRESSED;
+        header.segmentCount = 1;
+        header.payloadSize = 24;
+        unsigned char headerBytes[io::CNT_HEADER_SIZE];
+        io::formatHeader(header, headerBytes);
+        hugeSteps.replace(0, io::CNT_HEADER_SIZE, reinterpret_cast<const char*>(headerBytes), io::CNT_HEADER_SIZE);
+        io::detail::storeDouble(reinterpret_cast<unsigned char*>(&hugeSteps[io::CNT_HEADER_SIZE]), 1.0);
+        const unsigned char varints[] = { 5, 1, 0, 0, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 1 };
+        hugeSteps.replace(io::CNT_HEADER_SIZE + 8, sizeof varints, reinterpret_cast<const char*>(varints), sizeof varints);
+    }
+    std::stringstream corruptAngle(hugeSteps);
+    bool corruptAngleThrows = false;
+    try
+    {
+        io::readContour(corruptAngle);
+    }
+    catch (const std::runtime_error&)
+    {
+        corruptAngleThrows = true;
+    }
+    suite.runTest("Corrupt compressed arc angle is rejected", corruptAngleThrows);
+
+    // These detached arcs differ only in the sign of their start angle
+    Contour upper;
+    Contour lower;
+    for (int i = 0; i < 8; ++i)
+    {
+        const Point2D center(10.0 * i, 0.0);
+        upper.addSegment(createArcSegment(center, 3.0, 0.5, 1.5));
+        lower.addSegment(createArcSegment(center, 3.0, -0.5, 0.5));
+    }
+    std::stringstream upperPacked;
+    std::stringstream lowerPacked;
+    io::writeCompressedContour(upperPacked, upper);
+    io::writeCompressedContour(lowerPacked, lower);
+    suite.runTest("Negative arc start angles pack as small as positive ones",
+        lowerPacked.str().size() == upperPacked.str().size()
+            && sameEnds(io::readContour(lowerPacked), lower, 1e-5));
+
+    std::string truncatedBytes = packed.str();
+    truncatedBytes.resize(truncatedBytes.size() - 64);
+    std::stringstream truncated(truncatedBytes);
+    bool truncatedThrows = false;
+    try
+    {
+        io::readContour(truncated);
+    }
+    catch (const std::runtime_error&)
+    {
+        truncatedThrows = true;
+    }
+    suite.runTest("Truncated compressed record is reported", truncatedThrows);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "contour_compressed_test.cnt").string();
+    io::writeCompressedContour(path, wavy);
+    bool mappedRejects = false;
+    {
+        io::MappedFile file(path);
+        try
+        {
+            io::MappedContour mapped(file);
+        }
+        catch (const std::runtime_error&)
+        {
+            mappedRejects = true;
+        }
+    }
+    suite.runTest("Compressed file reads back by path, MappedContour rejects it",
+        sameEnds(io::readContour(path), wavy, 1e-5) && mappedRejects);
+    std::remove(path.c_str());
+}
+
+// Test DXF import and export
+void testDxfIO(TestSuite& suite)
+{
+    std::cout << "\n=== Testing DXF Import/Export ===" << std::endl;
+
+    const std::string drawing =
+        "  0\r\nSECTION\r\n  2\r\nHEADER\r\n  9\r\n$ACADVER\r\n  1\r\nAC1015\r\n  0\r\nENDSEC\r\n"
+        "  0\r\nSECTION\r\n  2\r\nENTITIES\r\n"
+        "  0\r\nLINE\r\n  8\r\n0\r\n 10\r\n0.0\r\n 20\r\n0.0\r\n 30\r\n0.0\r\n 11\r\n10.0\r\n 21\r\n0.0\r\n 31\r\n0.0\r\n"
+        "  0\r\nLWPOLYLINE\r\n  8\r\n0\r\n 90\r\n4\r\n 70\r\n1\r\n 43\r\n0.5\r\n"
+        " 10\r\n10.0\r\n 20\r\n0.0\r\n 10\r\n20.0\r\n 20\r\n0.0\r\n 42\r\n1.0\r\n"
+        " 10\r\n20.0\r\n 20\r\n10.0\r\n 10\r\n10.0\r\n 20\r\n10.0\r\n"
+        "  0\r\nCIRCLE\r\n  8\r\n0\r\n 10\r\n1.0\r\n 20\r\n1.0\r\n 40\r\n3.0\r\n"
+        "  0\r\nARC\r\n  8\r\n0\r\n 10\r\n5.0\r\n 20\r\n5.0\r\n 40\r\n2.0\r\n 50\r\n0.0\r\n 51\r\n90.0\r\n"
+        "  0\r\nARC\r\n  8\r\n0\r\n 10\r\n3.0\r\n 20\r\n0.0\r\n 40\r\n1.0\r\n 50\r\n0.0\r\n 51\r\n90.0\r\n"
+        "210\r\n0.0\r\n220\r\n0.0\r\n230\r\n-1.0\r\n"
+        "  0\r\nINSERT\r\n  2\r\nBLOCK1\r\n 10\r\n0.0\r\n 20\r\n0.0\r\n"
+        "  0\r\nENDSEC\r\n  0\r\nEOF\r\n";
+
+    {
+        std::istringstream in(drawing);
+        io::DxfReader reader(in);
+        std::vector<SegmentVariant> block;
+        std::size_t total = 0;
+        std::vector<SegmentVariant> all;
+        while (reader.readSegments(block, 3) > 0)
+        {
+            total += block.size();
+            all.insert(all.end(), block.begin(), block.end());
+        }
+        suite.runTest("LINE, LWPOLYLINE and ARC entities are read, others skipped",
+            total == 7 && reader.getEntityCount() == 4 && reader.getSkippedCount() == 2);
+
+        const auto* bulged = total == 7 ? std::get_if<ArcSegment>(&all[2]) : nullptr;
+        suite.runTest("Bulge 1 becomes a counter-clockwise half circle",
+            bulged && !bulged->isClockwise() && geometry::isEqual(bulged->getRadius(), 5.0)
+            && bulged->getCenter().isEqual(Point2D(20.0, 5.0)) && bulged->getEndPoint().isEqual(Point2D(20.0, 10.0))
+            && bulged->getPointAt(0.5).isEqual(Point2D(25.0, 5.0)));
+        const auto* closing = total == 7 ? std::get_if<LineSegment>(&all[4]) : nullptr;
+        suite.runTest("Closed polyline gets its closing edge",
+            closing && closing->getStartPoint().isEqual(Point2D(10.0, 10.0)) && closing->getEndPoint().isEqual(Point2D(10.0, 0.0)));
+        const auto* mirrored = total == 7 ? std::get_if<ArcSegment>(&all[6]) : nullptr;
+        suite.runTest("Arc with a downward normal is mirrored and clockwise",
+            mirrored && mirrored->isClockwise() && mirrored->getStartPoint().isEqual(Point2D(-4.0, 0.0))
+            && mirrored->getEndPoint().isEqual(Point2D(-3.0, 1.0)));
+    }
+
+    ContourBuilder builder;
+    builder.addLine(Point2D(0.0, 0.0), Point2D(10.0, 0.0))
+        .addArc(Point2D(15.0, 0.0), 5.0, PI, 0.0, true)
+        .addLine(Point2D(20.0, 0.0), Point2D(20.0, 10.0))
+        .addArc(Point2D(15.0, 10.0), 5.0, 0.0, PI / 2);
+    Contour shape = std::move(builder).build();
+    std::stringstream written;
+    io::writeDxf(written, shape);
+    Contour readBack = io::readDxf(written);
+    bool sameShape = readBack.size() == shape.size() && readBack.isValid();
+    for (std::size_t i = 0; sameShape && i < shape.size(); ++i)
+    {
+        sameShape = readBack[i].getType() == shape[i].getType()
+            && readBack[i].getStartPoint().isEqual(shape[i].getStartPoint())
+            && readBack[i].getEndPoint().isEqual(shape[i].getEndPoint());
+    }
+    suite.runTest("writeDxf output reads back with arc directions kept", sameShape);
+
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 5000; ++i)
+    {
+        const double angle = 2.0 * PI * i / 5000.0;
+        points.emplace_back(40.0 * std::cos(angle), 40.0 * std::sin(angle));
+    }
+    Contour circle = utilities::createPolylineContour(points);
+    const std::string path = (std::filesystem::temp_directory_path() / "contour_dxf_test.dxf").string();
+    io::writeDxf(path, circle);
+    suite.runTest("Drawing larger than the tokenizer buffer reads back exactly",
+        std::filesystem::file_size(path) > 64 * 1024 && io::readDxf(path).isEqual(circle, std::numeric_limits<double>::denorm_min()));
+    std::remove(path.c_str());
+
+    auto failsWith = [](const std::string& text, const std::string& expected) {
+        std::istringstream in(text);
+        try
+        {
+            io::readDxf(in);
+        }
+        catch (const std::runtime_error& e)
+        {
+            return std::string(e.what()).find(expected) != std::string::npos;
+        }
+        return false;
+    };
+    suite.runTest("Malformed number is reported with its line",
+        failsWith("  0\nSECTION\n  2\nENTITIES\n  0\nLINE\n 10\nx1\n", "line 8"));
+    {
+        std::istringstream in("0\nSECTION\n2\nENTITIES\n0\nLINE\n10\n1\n20\n1\n11\n1\n21\n1\n"
+                              "0\nLINE\n10\n1\n20\n1\n11\n2\n21\n1\n0\nENDSEC\n0\nEOF\n");
+        io::DxfReader reader(in);
+        std::vector<SegmentVariant> block;
+        const std::size_t count = reader.readSegments(block, 8);
+        suite.runTest("Zero-length line is skipped and counted",
+            count == 1 && reader.getEntityCount() == 1 && reader.getSkippedCount() == 1);
+    }
+    suite.runTest("Out-of-range polyline flags are rejected",
+        failsWith("0\nSECTION\n2\nENTITIES\n0\nLWPOLYLINE\n70\n1e300\n0\nENDSEC\n0\nEOF\n", "line 8")
+        && failsWith("0\nSECTION\n2\nENTITIES\n0\nLWPOLYLINE\n70\n99999999999999999999\n0\nENDSEC\n0\nEOF\n", "integer"));
+    suite.runTest("Huge and non-finite arc values are rejected instead of hanging",
+        failsWith("0\nSECTION\n2\nENTITIES\n0\nARC\n10\n0\n20\n0\n40\n1\n50\n1e300\n51\n90\n0\nENDSEC\n0\nEOF\n", "line 14")
+        && failsWith("0\nSECTION\n2\nENTITIES\n0\nARC\n10\n0\n20\n0\n40\ninf\n50\n0\n51\n90\n0\nENDSEC\n0\nEOF\n", "line 12")
+        && failsWith("0\nSECTION\n2\nENTITIES\n0\nARC\n10\n0\n20\n0\n40\n-1\n50\n0\n51\n90\n0\nENDSEC\n0\nEOF\n", "radius"));
+    suite.runTest("Binary DXF and missing ENTITIES are rejected",
+        failsWith(std::string("AutoCAD Binary DXF\r\n\x1a\0", 22), "binary")
+        && failsWith("  0\nSECTION\n  2\nHEADER\n  0\nENDSEC\n  0\nEOF\n", "ENTITIES"));
+}
+
+// Test sweep-line self-intersection detection
+void testSelfIntersection(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Self-Intersection ===" << std::endl;
+    
+    Contour square = utilities::createPolylineContour({
+        Point2D(0.0, 0.0), Point2D(2.0, 0.0), Point2D(2.0, 2.0), Point2D(0.0, 2.0), Point2D(0.0, 0.0) });
+    suite.runTest("Closed square is simple", square.isSimple() && square.findSelfIntersections().empty());
+    
+    Contour bowtie = utilities::createPolylineContour({
+        Point2D(0.0, 0.0), Point2D(2.0, 2.0), Point2D(2.0, 0.0), Point2D(0.0, 2.0), Point2D(0.0, 0.0) });
+    auto bowtieCrossings = bowtie.findSelfIntersections();
+    suite.runTest("Figure-eight has one crossing", !bowtie.isSimple() && bowtieCrossings.size() == 1 &&
+                  bowtieCrossings[0].first == 0 && bowtieCrossings[0].second == 2 &&
+                  bowtieCrossings[0].point.isEqual(Point2D(1.0, 1.0)));
+    
+    std::vector<Point2D> star;
+    for (int i = 0; i <= 5; ++i)
+    {
+        const double angle = PI / 2 + (i % 5) * 4.0 * PI / 5.0;
+        star.emplace_back(std::cos(angle), std::sin(angle));
+    }
+    suite.runTest("Pentagram has five crossings", utilities::createPolylineContour(star).findSelfIntersections().size() == 5);
+    
+    // Tangent arcs meeting lines at their joints
+    Contour rounded;
+    rounded.addSegment(createLineSegment(Point2D(1.0, 0.0), Point2D(3.0, 0.0)));
+    rounded.addSegment(createArcSegment(Point2D(3.0, 1.0), 1.0, -PI/2, 0.0, false));
+    rounded.addSegment(createLineSegment(Point2D(4.0, 1.0), Point2D(4.0, 2.0)));
+    rounded.addSegment(createArcSegment(Point2D(3.0, 2.0), 1.0, 0.0, PI/2, false));
+    rounded.addSegment(createLineSegment(Point2D(3.0, 3.0), Point2D(1.0, 3.0)));
+    rounded.addSegment(createArcSegment(Point2D(1.0, 2.0), 1.0, PI/2, PI, false));
+    rounded.addSegment(createLineSegment(Point2D(0.0, 2.0), Point2D(0.0, 1.0)));
+    rounded.addSegment(createArcSegment(Point2D(1.0, 1.0), 1.0, PI, 1.5 * PI, false));
+    suite.runTest("Rounded rectangle is simple", rounded.isValid() && rounded.isSimple());
+    
+    Contour arcLine;
+    arcLine.addSegment(createArcSegment(Point2D(0.0, 0.0), 1.0, PI, 0.0, true));
+    arcLine.addSegment(createLineSegment(Point2D(1.0, 0.0), Point2D(-2.0, 0.5)));
+    auto arcLineCrossings = arcLine.findSelfIntersections();
+    suite.runTest("Line crossing an arc", arcLineCrossings.size() == 1 &&
+                  isEqual(arcLineCrossings[0].point.magnitude(), 1.0) && arcLineCrossings[0].point.x < 0.0);
+    
+    Contour arcArc;
+    arcArc.addSegment(createArcSegment(Point2D(0.0, 0.0), 1.0, 0.0, PI, false));
+    arcArc.addSegment(createArcSegment(Point2D(1.0, 0.0), 1.0, 0.0, PI, false));
+    auto arcArcCrossings = arcArc.findSelfIntersections();
+    const bool onBothCircles = arcArcCrossings.size() == 1 &&
+                               arcArcCrossings[0].point.isEqual(Point2D(0.5, std::sqrt(3.0) / 2.0));
+    suite.runTest("Arc crossing an arc", onBothCircles);
+    
+    // Endpoints a rounding error apart still meet at one event
+    bool touchesFound = true;
+    for (double offset : { 0.0, 1e-12, -1e-12 })
+    {
+        Contour touching;
+        touching.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 1.0)));
+        touching.addSegment(createLineSegment(Point2D(1.0, 1.0), Point2D(2.0, 0.0)));
+        touching.addSegment(createLineSegment(Point2D(2.0, 0.0), Point2D(3.0, 3.0)));
+        touching.addSegment(createLineSegment(Point2D(1.0 + offset, 1.0), Point2D(1.0, 3.0)));
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> pairs;
+        for (const auto& crossing : touching.findSelfIntersections())
+        {
+            pairs.emplace_back(crossing.first, crossing.second);
+        }
+        touchesFound = touchesFound && pairs == std::vector<std::pair<Contour::size_type, Contour::size_type>>{ { 0, 3 }, { 1, 3 } };
+    }
+    suite.runTest("Endpoints 1e-12 apart touch", touchesFound);
+    
+    // Random closed polylines against an all-pairs check
+    std::mt19937 random(4242);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+    auto segmentsCross = [](const Segment& a, const Segment& b) {
+        const Point2D p = a.getStartPoint();
+        const Point2D r = a.getEndPoint() - p;
+        const Point2D q = b.getStartPoint();
+        const Point2D s = b.getEndPoint() - q;
+        const double denominator = r.x * s.y - r.y * s.x;
+        const double t = ((q.x - p.x) * s.y - (q.y - p.y) * s.x) / denominator;
+        const double u = ((q.x - p.x) * r.y - (q.y - p.y) * r.x) / denominator;
+        return t >= 0.0 && t <= 1.0 && u >= 0.0 && u <= 1.0;
+    };
+    bool pairsMatch = true;
+    bool modesAgree = true;
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        std::vector<Point2D> polygon;
+        const int count = 5 + trial * 3;
+        for (int i = 0; i < count; ++i)
+        {
+            polygon.emplace_back(coordinate(random), coordinate(random));
+        }
+        polygon.push_back(polygon.front());
+        Contour contour = utilities::createPolylineContour(polygon);
+        
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> expected;
+        const Contour::size_type n = contour.size();
+        for (Contour::size_type i = 0; i < n; ++i)
+        {
+            for (Contour::size_type j = i + 2; j < n; ++j)
+            {
+                if (!(i == 0 && j == n - 1) && segmentsCross(contour[i], contour[j]))
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> found;
+        for (const auto& crossing : contour.findSelfIntersections())
+        {
+            found.emplace_back(crossing.first, crossing.second);
+        }
+        pairsMatch = pairsMatch && found == expected;
+        modesAgree = modesAgree && contour.isSimple() == expected.empty();
+    }
+    suite.runTest("Random polygon crossings match brute force", pairsMatch);
+    suite.runTest("isSimple agrees with findSelfIntersections", modesAgree);
+    
+    // Mixed lines and arcs against all pairs through the intersection kernels
+    bool mixedMatches = true;
+    for (int trial = 0; trial < 10; ++trial)
+    {
+        Contour contour;
+        for (int i = 0; i < 40 + trial * 10; ++i)
+        {
+            const Point2D a(coordinate(random), coordinate(random));
+            if (random() % 2 == 0)
+            {
+                const double startAngle = coordinate(random) / 10.0;
+                contour.addSegment(createArcSegment(a, 2.0 + coordinate(random) / 10.0, startAngle,
+                                                    startAngle + 0.5 + coordinate(random) / 30.0, random() % 2 == 0));
+            }
+            else
+            {
+                contour.addSegment(createLineSegment(a, Point2D(coordinate(random), coordinate(random))));
+            }
+        }
+        
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> expected;
+        for (Contour::size_type i = 0; i < contour.size(); ++i)
+        {
+            for (Contour::size_type j = i + 1; j < contour.size(); ++j)
+            {
+                if (intersect(contour[i], contour[j]).count > 0)
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> found;
+        for (const auto& crossing : contour.findSelfIntersections())
+        {
+            if (found.empty() || found.back() != std::make_pair(crossing.first, crossing.second))
+            {
+                found.emplace_back(crossing.first, crossing.second);
+            }
+        }
+        mixedMatches = mixedMatches && found == expected;
+    }
+    suite.runTest("Line and arc crossings match brute force", mixedMatches);
+    
+    // Connected chains of lines and arcs: neighbours meet at their joint, which is not a crossing
+    bool chainMatches = true;
+    for (int trial = 0; trial < 30; ++trial)
+    {
+        Contour chain;
+        Point2D end(50.0, 50.0);
+        for (int i = 0; i < 10 + trial; ++i)
+        {
+            if (random() % 2 == 0)
+            {
+                chain.addSegment(createLineSegment(end, Point2D(coordinate(random), coordinate(random))));
+            }
+            else
+            {
+                const double radius = 2.0 + coordinate(random) / 5.0;
+                const double direction = coordinate(random) / 10.0;
+                const Point2D center(end.x + radius * std::cos(direction), end.y + radius * std::sin(direction));
+                const double startAngle = direction + PI;
+                const double span = 0.2 + coordinate(random) / 20.0;
+                const bool clockwise = random() % 2 == 0;
+                chain.addSegment(createArcSegment(center, radius, startAngle,
+                                                  clockwise ? startAngle - span : startAngle + span, clockwise));
+            }
+            end = chain[chain.size() - 1].getEndPoint();
+        }
+        
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> expected;
+        for (Contour::size_type i = 0; i < chain.size(); ++i)
+        {
+            for (Contour::size_type j = i + 1; j < chain.size(); ++j)
+            {
+                const Intersection result = intersect(chain[i], chain[j], 1e-7);
+                bool crosses = false;
+                for (int k = 0; k < result.count; ++k)
+                {
+                    const bool atJoint = j == i + 1 && result.points[k].isEqual(chain[i].getEndPoint(), 1e-6);
+                    crosses = crosses || !atJoint;
+                }
+                if (crosses)
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        std::vector<std::pair<Contour::size_type, Contour::size_type>> found;
+        for (const auto& crossing : chain.findSelfIntersections())
+        {
+            if (found.empty() || found.back() != std::make_pair(crossing.first, crossing.second))
+            {
+                found.emplace_back(crossing.first, crossing.second);
+            }
+        }
+        chainMatches = chainMatches && found == expected && chain.isSimple() == expected.empty();
+    }
+    suite.runTest("Connected line and arc chains match brute force", chainMatches);
+    
+    // Sweep vs all-pairs on a long simple staircase
+    std::vector<Point2D> stairs;
+    for (int i = 0; i <= 20000; ++i)
+    {
+        stairs.emplace_back(static_cast<double>(i / 2 + i % 2), static_cast<double>(i / 2));
+    }
+    Contour staircase = utilities::createPolylineContour(stairs);
+    auto start = std::chrono::high_resolution_clock::now();
+    const bool sweptSimple = staircase.isSimple();
+    auto middle = std::chrono::high_resolution_clock::now();
+    bool pairwiseSimple = true;
+    for (Contour::size_type i = 0; i < staircase.size() && pairwiseSimple; ++i)
+    {
+        const BoundingBox box = staircase[i].getBoundingBox();
+        for (Contour::size_type j = i + 2; j < staircase.size(); ++j)
+        {
+            if (box.intersects(staircase[j].getBoundingBox()) && segmentsCross(staircase[i], staircase[j]))
+            {
+                pairwiseSimple = false;
+                break;
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "isSimple over " << staircase.size() << " segments: sweep "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, all pairs "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("Sweep and all-pairs agree on a long staircase", sweptSimple && pairwiseSimple);
+}
+
+// Test copy-on-write snapshots and chunked storage
+void testCopyOnWrite(TestSuite& suite)
+{
+    std::cout << "\n=== Testing Copy-on-Write Contours ===" << std::endl;
+    
+    std::vector<Point2D> zigzag;
+    for (int i = 0; i <= 1000; ++i)
+    {
+        zigzag.emplace_back(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0);
+    }
+    Contour original = utilities::createPolylineContour(zigzag);
+    Contour snapshot = original;
+    suite.runTest("Snapshot shares storage", snapshot.sharesStorageWith(original) && snapshot == original);
+    
+    const double originalLength = original.getTotalLength();
+    original.replaceSegment(500, createLineSegment(Point2D(500.0, 0.0), Point2D(600.0, 5.0)));
+    {
+        auto handle = original.edit(10);
+        handle.replace(createLineSegment(Point2D(10.0, 0.0), Point2D(11.0, 1.0)));
+    }
+    original.removeSegment(999);
+    suite.runTest("Edits detach the snapshot", !snapshot.sharesStorageWith(original) &&
+                  snapshot.size() == 1000 && original.size() == 999);
+    suite.runTest("Snapshot keeps its segments", isEqual(snapshot.getTotalLength(), originalLength) &&
+                  snapshot[500].getEndPoint().isEqual(Point2D(501.0, 1.0)) && snapshot.isValid());
+    suite.runTest("Edited contour sees its own joints", original.getDisconnectedJoints() == std::vector<Contour::size_type>{ 500 });
+    original.replaceSegment(500, createLineSegment(Point2D(500.0, 0.0), Point2D(501.0, 1.0)));
+    suite.runTest("Repaired joint leaves the summaries", original.getDisconnectedJoints().empty() &&
+                  original.getMaxJointGap() == 0.0 && original.isValid());
+    
+    // Chunks still shared with a snapshot bound the range the edits touched
+    Contour shown = utilities::createPolylineContour(zigzag);
+    Contour edited = shown;
+    edited.replaceSegment(300, createLineSegment(Point2D(300.0, 0.0), Point2D(301.0, 2.0)));
+    const auto afterReplace = edited.sharedEnds(shown);
+    edited.insertSegment(600, createLineSegment(Point2D(600.0, 0.0), Point2D(600.0, 1.0)));
+    const auto afterInsert = edited.sharedEnds(shown);
+    suite.runTest("Shared chunks bound the edited range",
+                  afterReplace == std::make_pair<Contour::size_type, Contour::size_type>(256, 488) &&
+                  afterInsert == std::make_pair<Contour::size_type, Contour::size_type>(256, 232) &&
+                  shown.sharedEnds(shown).first == 1000 && edited.sharedEnds(original) == std::make_pair<Contour::size_type, Contour::size_type>(0, 0));
+    
+    // Random edits against a plain vector of endpoints, crossing chunk splits and merges
+    std::vector<std::pair<Point2D, Point2D>> reference;
+    Contour chunked;
+    for (int i = 0; i < 600; ++i)
+    {
+        reference.emplace_back(Point2D(i, 0.0), Point2D(i + 1.0, 0.0));
+        chunked.addSegment(createLineSegment(reference.back().first, reference.back().second));
+    }
+    
+    std::mt19937 random(12345);
+    bool matches = true;
+    Contour previous = chunked;
+    auto previousReference = reference;
+    for (int step = 0; step < 3000 && matches; ++step)
+    {
+        const std::size_t count = reference.size();
+        const int operation = static_cast<int>(random() % 4);
+        const Point2D start(static_cast<double>(random() % 1000), static_cast<double>(random() % 3));
+        const Point2D end(start.x + 1.0, start.y);
+        if (operation < 2 || count < 2)
+        {
+            const std::size_t index = random() % (count + 1);
+            reference.insert(reference.begin() + index, { start, end });
+            chunked.insertSegment(index, createLineSegment(start, end));
+        }
+        else if (operation == 2)
+        {
+            const std::size_t index = random() % count;
+            reference.erase(reference.begin() + index);
+            chunked.removeSegment(index);
+        }
+        else
+        {
+            const std::size_t index = random() % count;
+            reference[index] = { start, end };
+            chunked.replaceSegment(index, createLineSegment(start, end));
+        }
+        if (step % 500 == 0)
+        {
+            previous = chunked;
+            previousReference = reference;
+        }
+        
+        std::vector<Contour::size_type> joints;
+        double maxGap = 0.0;
+        for (std::size_t i = 0; i + 1 < reference.size(); ++i)
+        {
+            const double gap = std::max(std::abs(reference[i].second.x - reference[i + 1].first.x),
+                                        std::abs(reference[i].second.y - reference[i + 1].first.y));
+            maxGap = std::max(maxGap, gap);
+            if (!(gap < EPSILON))
+            {
+                joints.push_back(i);
+            }
+        }
+        matches = chunked.size() == reference.size() && chunked.getDisconnectedJoints() == joints &&
+                  isEqual(chunked.getMaxJointGap(), maxGap) &&
+                  isEqual(chunked.getTotalLength(), static_cast<double>(reference.size()), 1e-6);
+        
+        std::size_t i = 0;
+        for (const auto& segment : chunked)
+        {
+            matches = matches && segment->getStartPoint().isEqual(reference[i].first);
+            ++i;
+        }
+        const std::size_t probe = random() % reference.size();
+        matches = matches && i == reference.size() && chunked[probe].getEndPoint().isEqual(reference[probe].second) &&
+                  chunked.segmentIndexAtDistance(probe + 0.5) == probe;
+        
+        // Bounds and the chunk tree follow the edits
+        BoundingBox bounds;
+        const BoundingBox range(Point2D(random() % 1000, 0.5), Point2D(random() % 1000 + 20.0, 1.5));
+        std::vector<Contour::size_type> inRange;
+        for (std::size_t k = 0; k < reference.size(); ++k)
+        {
+            bounds.expand(reference[k].first);
+            bounds.expand(reference[k].second);
+            const BoundingBox box(reference[k].first, reference[k].second);
+            if (box.intersects(range))
+            {
+                inRange.push_back(k);
+            }
+        }
+        const BoundingBox actual = chunked.getBoundingBox();
+        matches = matches && actual.minPoint.isEqual(bounds.minPoint) && actual.maxPoint.isEqual(bounds.maxPoint) &&
+                  chunked.segmentsInBox(range) == inRange;
+    }
+    suite.runTest("Random edits match reference", matches);
+    
+    bool untouched = previous.size() == previousReference.size();
+    std::size_t k = 0;
+    for (const auto& segment : previous)
+    {
+        untouched = untouched && k < previousReference.size() &&
+                    segment->getStartPoint().isEqual(previousReference[k].first) &&
+                    segment->getEndPoint().isEqual(previousReference[k].second);
+        ++k;
+    }
+    suite.runTest("Older snapshot is untouched", untouched && k == previousReference.size());
+    
+    // O(1) snapshots vs deep copies of a large contour
+    std::vector<Point2D> points;
+    for (int i = 0; i <= 200000; ++i)
+    {
+        points.emplace_back(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0);
+    }
+    Contour large = utilities::createPolylineContour(points);
+    const int copies = 100;
+    std::size_t total = 0;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < copies; ++i)
+    {
+        Contour copy = large;
+        total += copy.size();
+    }
+    auto middleTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 5; ++i)
+    {
+        Contour copy(large, nullptr);
+        total += copy.size();
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::cout << "Copy " << large.size() << " segments: snapshot "
+              << std::chrono::duration<double, std::micro>(middleTime - startTime).count() / copies << " us, deep copy "
+              << std::chrono::duration<double, std::micro>(endTime - middleTime).count() / 5 << " us" << std::endl;
+    suite.runTest("Snapshots and deep copies agree", total == (copies + 5) * large.size());
+}
+
+// Test value-type contour storage
+void testVariantContour(TestSuite& suite)
+{
+    std::cout << "\n=== Testing VariantContour ===" << std::endl;
+    
+    Contour contour;
+    contour.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    contour.addSegment(createArcSegment(Point2D(1.0, 1.0), 1.0, -PI/2, 0.0, false));
+    contour.addSegment(createLineSegment(Point2D(2.0, 1.0), Point2D(0.0, 0.0)));
+    
+    VariantContour packed(contour);
+    suite.runTest("VariantContour from Contour", packed.size() == 3);
+    suite.runTest("VariantContour validity", packed.isValid() == contour.isValid());
+    suite.runTest("VariantContour total length", isEqual(packed.getTotalLength(), contour.getTotalLength()));
+    suite.runTest("VariantContour is closed", packed.isClosed());
+    
+    auto vertices = packed.getVertices();
+    auto expected = contour.getVertices();
+    bool sameVertices = vertices.size() == expected.size();
+    for (size_t i = 0; sameVertices && i < vertices.size(); ++i)
+    {
+        sameVertices = vertices[i].isEqual(expected[i]);
+    }
+    suite.runTest("VariantContour vertices", sameVertices);
+    suite.runTest("VariantContour segment view", packed.segmentAt(1).getType() == SegmentType::Arc);
+    suite.runTest("VariantContour round trip", packed.toContour() == contour);
+    
+    VariantContour copy = packed;
+    copy.replaceSegment(2, LineSegment(Point2D(2.0, 1.0), Point2D(5.0, 5.0)));
+    suite.runTest("VariantContour copy is independent", copy != packed && packed.isClosed());
+    
+    copy.insertSegment(1, LineSegment(Point2D(3.0, 0.0), Point2D(4.0, 0.0)));
+    suite.runTest("VariantContour insert breaks validity", !copy.isValid());
+    copy.removeSegment(1);
+    suite.runTest("VariantContour remove restores validity", copy.isValid());
+}
+
+// Compare pointer-based and value-based contour layouts on a large contour
+void testVariantContourPerformance(TestSuite& suite)
+{
+    std::cout << "\n=== Testing VariantContour Performance ===" << std::endl;
+    
+    const size_t segmentCount = 200000;
+    const int iterations = 10;
+    
+    Contour pointerContour;
+    VariantContour packedContour;
+    packedContour.reserve(segmentCount);
+    Point2D current(0.0, 0.0);
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        if (i % 4 == 3)
+        {
+            // Half-circle bump going right: center one unit ahead
+            Point2D center(current.x + 1.0, current.y);
+            pointerContour.addSegment(createArcSegment(center, 1.0, PI, 0.0, true));
+            packedContour.addArc(center, 1.0, PI, 0.0, true);
+            current = Point2D(current.x + 2.0, current.y);
+        }
+        else
+        {
+            Point2D next(current.x + 1.0, current.y + ((i % 2 == 0) ? 0.5 : -0.5));
+            pointerContour.addSegment(createLineSegment(current, next));
+            packedContour.addLine(current, next);
+            current = next;
+        }
+    }
+    
+    auto timeMs = [](auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    
+    double pointerLength = 0.0;
+    double packedLength = 0.0;
+    bool pointerValid = true;
+    bool packedValid = true;
+    size_t pointerVertices = 0;
+    size_t packedVertices = 0;
+    
+    // Contour answers getTotalLength and isValid from its summaries in O(1),
+    // so the timed loops walk the segments themselves
+    double pointerTime = timeMs([&] {
+        for (int i = 0; i < iterations; ++i)
+        {
+            pointerLength = 0.0;
+            for (const auto& segment : pointerContour)
+            {
+                pointerLength += segment->getLength();
+            }
+            pointerVertices = pointerContour.getVertices().size();
+        }
+    });
+    double packedTime = timeMs([&] {
+        for (int i = 0; i < iterations; ++i)
+        {
+            packedLength = 0.0;
+            for (const auto& segment : packedContour)
+            {
+                packedLength += std::visit([](const auto& s) { return s.getLength(); }, segment);
+            }
+            packedVertices = packedContour.getVertices().size();
+        }
+    });
+    pointerValid = pointerContour.isValid(1e-6);
+    packedValid = packedContour.isValid(1e-6);
+    
+    // A deep copy, so isEqual cannot take the shared-storage shortcut
+    Contour pointerCopy(pointerContour, nullptr);
+    VariantContour packedCopy = packedContour;
+    bool pointerEqual = false;
+    bool packedEqual = false;
+    double pointerEqualTime = timeMs([&] { pointerEqual = pointerContour.isEqual(pointerCopy); });
+    double packedEqualTime = timeMs([&] { packedEqual = packedContour.isEqual(packedCopy); });
+    
+    std::cout << "Length/vertices walk x" << iterations << " over " << segmentCount << " segments: "
+              << "unique_ptr " << pointerTime << " ms, variant " << packedTime << " ms" << std::endl;
+    std::cout << "isEqual: unique_ptr " << pointerEqualTime << " ms, variant " << packedEqualTime << " ms" << std::endl;
+    
+    suite.runTest("Layouts agree on total length", isEqual(pointerLength, packedLength, 1e-6));
+    suite.runTest("Layouts agree on validity", pointerValid && packedValid);
+    suite.runTest("Layouts agree on vertex count", pointerVertices == packedVertices);
+    suite.runTest("Layouts agree on equality", pointerEqual && packedEqual && !pointerCopy.sharesStorageWith(pointerContour));
+}
+
+// Test structure-of-arrays contour and batch kernels
+void testFlatContour(TestSuite& suite)
+{
+    std::cout << "\n=== Testing FlatContour ===" << std::endl;
+    
+    Contour contour;
+    contour.addSegment(createLineSegment(Point2D(0.0, 0.0), Point2D(1.0, 0.0)));
+    contour.addSegment(createArcSegment(Point2D(1.0, 1.0), 1.0, -PI/2, 0.0, false));
+    contour.addSegment(createLineSegment(Point2D(2.0, 1.0), Point2D(0.0, 0.0)));
+    
+    FlatContour flat(contour);
+    suite.runTest("FlatContour from Contour", flat.size() == 3 && flat.arcCount() == 1);
+    suite.runTest("FlatContour type column", flat.typeAt(1) == SegmentType::Arc);
+    suite.runTest("FlatContour total length kernel", isEqual(kernels::totalLength(flat), contour.getTotalLength()));
+    suite.runTest("FlatContour validity kernel", kernels::isValid(flat));
+    suite.runTest("FlatContour round trip", flat.toContour() == contour);
+    
+    std::vector<Point2D> vertices;
+    kernels::extractVertices(flat, vertices);
+    auto expected = contour.getVertices();
+    bool sameVertices = vertices.size() == expected.size();
+    for (size_t i = 0; sameVertices && i < vertices.size(); ++i)
+    {
+        sameVertices = vertices[i].isEqual(expected[i]);
+    }
+    suite.runTest("FlatContour vertex kernel", sameVertices);
+    
+    // A quarter arc bulges past its endpoints only on its own quadrant
+    FlatContour quarter;
+    quarter.addArc(Point2D(0.0, 0.0), 2.0, PI/4, 3*PI/4, false);
+    BoundingBox box = kernels::bounds(quarter);
+    suite.runTest("FlatContour arc bounds", isEqual(box.maxPoint.y, 2.0) &&
+                  isEqual(box.minPoint.y, std::sqrt(2.0)) &&
+                  isEqual(box.minPoint.x, -std::sqrt(2.0)) && isEqual(box.maxPoint.x, std::sqrt(2.0)));
+    
+    FlatContour broken;
+    broken.addLine(Point2D(0.0, 0.0), Point2D(1.0, 0.0));
+    broken.addLine(Point2D(2.0, 0.0), Point2D(3.0, 0.0));
+    suite.runTest("FlatContour detects gaps", !kernels::isValid(broken));
+    
+    // Batch kernels against the pointer walk on a large contour
+    std::vector<Point2D> points;
+    for (size_t i = 0; i <= 200000; ++i)
+    {
+        points.emplace_back(static_cast<double>(i), (i % 2 == 0) ? 0.0 : 1.0);
+    }
+    Contour large = utilities::createPolylineContour(points);
+    FlatContour largeFlat(large);
+    
+    double pointerLength = 0.0;
+    double flatLength = 0.0;
+    // getTotalLength is O(1) from the chunk summaries, so the pointer side
+    // walks the segments to compare like with like
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 10; ++i)
+    {
+        pointerLength = 0.0;
+        for (const auto& segment : large)
+        {
+            pointerLength += segment->getLength();
+        }
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 10; ++i)
+    {
+        flatLength = kernels::totalLength(largeFlat);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Total length x10 over " << large.size() << " segments: Contour "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, FlatContour "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    suite.runTest("FlatContour large length matches", isEqual(pointerLength, flatLength, 1e-6));
+}
+
 // Create hardcoded test contours as required by specifications
 std::vector<std::unique_ptr<Contour>> createTestContours()
 {
@@ -455,9 +2626,28 @@ void runAllTests()
     {
         testGeometry(suite);
         testSegments(suite);
+        testBoundingBoxes(suite);
+        testIntersections(suite);
         testContour(suite);
         testSegmentManagement(suite);
+        testArcLength(suite);
+        testResampling(suite);
+        testDisplaySimplification(suite);
+        testMemoryResource(suite);
+        testCopyOnWrite(suite);
+        testSpatialQueries(suite);
+        testGridHash(suite);
+        testLogging(suite);
+        testContourIO(suite);
+        testMappedContour(suite);
+        testContourStreaming(suite);
+        testContourCompression(suite);
+        testDxfIO(suite);
+        testSelfIntersection(suite);
         testUtilities(suite);
+        testVariantContour(suite);
+        testVariantContourPerformance(suite);
+        testFlatContour(suite);
         testVisualization(suite);
         testAsyncContourSearch(suite);
     }